@@ -0,0 +1,58 @@
+#-------------------------------------------------
+#
+# GUI application, items are views over components from protoelectronics-core
+#
+#-------------------------------------------------
+
+QT       += core gui
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+TARGET = protoElectronics
+TEMPLATE = app
+
+# The following define makes your compiler emit warnings if you use
+# any feature of Qt which has been marked as deprecated (the exact warnings
+# depend on your compiler). Please consult the documentation of the
+# deprecated API in order to know how to port your code away from it.
+DEFINES += QT_DEPRECATED_WARNINGS
+
+# You can also make your code fail to compile if you use deprecated APIs.
+# In order to do so, uncomment the following line.
+# You can also select to disable deprecated APIs only up to a certain version of Qt.
+#DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
+
+CONFIG += c++11
+
+INCLUDEPATH += include
+
+OBJECTS_DIR = obj/app
+MOC_DIR = obj/app
+
+LIBS += -L$$OUT_PWD -lprotoelectronics-core
+win32:!win32-g++: PRE_TARGETDEPS += $$OUT_PWD/protoelectronics-core.lib
+else: PRE_TARGETDEPS += $$OUT_PWD/libprotoelectronics-core.a
+
+SOURCES += \
+        src/main.cpp \
+        src/mainwindow.cpp \
+        src/scene.cpp \
+    src/dialog.cpp \
+    src/component_item.cpp \
+    src/log_component_item.cpp \
+    src/item_factory.cpp \
+    src/waveform_panel.cpp
+
+HEADERS += \
+        include/mainwindow.h \
+        include/scene.h \
+    include/dialog.h \
+    include/component_item.h \
+    include/log_component_item.h \
+    include/item_factory.h \
+    include/waveform_panel.h
+
+# Default rules for deployment.
+qnx: target.path = /tmp/$${TARGET}/bin
+else: unix:!android: target.path = /opt/$${TARGET}/bin
+!isEmpty(target.path): INSTALLS += target
@@ -0,0 +1,72 @@
+#-------------------------------------------------
+#
+# Headless simulation core: nodes, nets, components and scheduler.
+# Doesn't depend on Qt, so it can be used without GUI.
+#
+#-------------------------------------------------
+
+QT       -= core gui
+
+TARGET = protoelectronics-core
+TEMPLATE = lib
+CONFIG += staticlib c++11 thread
+CONFIG -= qt
+
+INCLUDEPATH += include
+
+OBJECTS_DIR = obj/core
+
+SOURCES += \
+        src/components.cpp \
+    src/log_component.cpp \
+    src/circuit.cpp \
+    src/node_registry.cpp \
+    src/scheduler.cpp \
+    src/net.cpp \
+    src/logic.cpp \
+    src/json.cpp \
+    src/schematic.cpp \
+    src/schematic_file.cpp \
+    src/component_type.cpp \
+    src/timeline.cpp \
+    src/delay.cpp \
+    src/compiled_logic.cpp \
+    src/pattern_simulator.cpp \
+    src/logic_kernel.cpp \
+    src/thread_pool.cpp \
+    src/sparse_lu.cpp \
+    src/analog_solver.cpp \
+    src/slab_allocator.cpp \
+    src/vcd_writer.cpp \
+    src/trace_buffer.cpp \
+    src/change_log.cpp \
+    src/change_feed.cpp
+
+HEADERS += \
+        include/components.hpp \
+    include/log_component.hpp \
+    include/circuit.hpp \
+    include/node_registry.hpp \
+    include/pin_table.hpp \
+    include/scheduler.hpp \
+    include/net.hpp \
+    include/logic.hpp \
+    include/disjoint_set.hpp \
+    include/json.hpp \
+    include/schematic.hpp \
+    include/schematic_file.hpp \
+    include/component_type.hpp \
+    include/timeline.hpp \
+    include/delay.hpp \
+    include/timing_wheel.hpp \
+    include/compiled_logic.hpp \
+    include/pattern_simulator.hpp \
+    include/logic_kernel.hpp \
+    include/thread_pool.hpp \
+    include/sparse_lu.hpp \
+    include/analog_solver.hpp \
+    include/slab_allocator.hpp \
+    include/vcd_writer.hpp \
+    include/trace_buffer.hpp \
+    include/change_log.hpp \
+    include/change_feed.hpp
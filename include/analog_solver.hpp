@@ -0,0 +1,167 @@
+#ifndef ANALOG_SOLVER_HPP
+#define ANALOG_SOLVER_HPP
+
+#include "sparse_lu.hpp"
+
+#include <cstddef>
+#include <vector>
+
+class Component;
+class Node;
+class Resistor;
+class Switch;
+
+/*
+ * DC operating point of resistor networks, found by modified nodal analysis.
+ * Unknowns are voltages of groups of nodes joined by wires and closed switches.
+ * Every resistor adds its conductance to nodal matrix G and G * v = i is solved
+ * with sparse LU factorization.
+ *
+ * Groups with ground or DC voltage, and groups driven by other components (gate outputs,
+ * flip-flops) are fixed: their voltage is known and moves to right side, so matrix stays
+ * symmetric and positive definite. Groups of resistors which don't reach any fixed net
+ * are floating and keep their voltage.
+ *
+ * Factorization is reused as long as possible:
+ *  - clock edges only change right side
+ *  - changed resistance is rank-1 update G + dg * u * u^T
+ *  - switch which was flipped once stays out of the matrix, when it is closed it is
+ *    constraint v(a) = v(b), also rank-1
+ * Updates are applied with Sherman-Morrison-Woodbury formula on top of the factorization,
+ * every update costs one extra solve when it appears. When there are too many of them,
+ * matrix is factorized again with the same ordering. Only new components or connections
+ * need new ordering.
+ *
+ * Components, including wires and switches, have to exist while solver is used.
+*/
+class AnalogSolver {
+public:
+    explicit AnalogSolver(const std::vector<Component*>& components);
+
+    AnalogSolver(const AnalogSolver&) = delete;
+    AnalogSolver& operator=(const AnalogSolver&) = delete;
+
+    /*
+     * Solves circuit, writes voltages of solved nets and propagates them to components
+     * which read those nets. Returns number of unknowns.
+     * Throws std::runtime_error if matrix is singular or resistance has no finite conductance,
+     * voltages of nets don't change then.
+    */
+    size_t solve();
+
+    //Number of unknowns in the last solve
+    size_t nets() const {
+        return _groups.size();
+    }
+
+    //Number of resistors in circuit
+    size_t resistors() const {
+        return _resistors.size();
+    }
+
+    //Number of low-rank updates used by the last solve
+    size_t updates() const {
+        return _updates.size();
+    }
+
+    //Number of numeric factorizations and orderings since solver was created
+    size_t factorizations() const {
+        return _factorizations;
+    }
+
+    size_t analyses() const {
+        return _analyses;
+    }
+
+private:
+    enum Kind : unsigned char {
+        FREE, FIXED, GROUND
+    };
+
+    //Groups of nodes which solver sees for current connections
+    struct Topology {
+        //two groups for every resistor and every switch, -1 if it isn't connected
+        std::vector<int> resistors, switches;
+        std::vector<Kind> kinds;
+        //node of every group, its net gives voltage
+        std::vector<Node*> nodes;
+
+        bool operator==(const Topology& other) const {
+            return resistors == other.resistors && switches == other.switches && kinds == other.kinds;
+        }
+    };
+
+    struct Branch {
+        Resistor* resistor;
+        //unknown index of both ends, -1 for fixed group
+        int ia, ib;
+        //groups of both ends
+        int ga, gb;
+        //positions of values in matrix: aa, bb, ab, ba, or NONE
+        size_t values[4];
+        //conductance in factorized matrix and current one
+        double base, conductance;
+    };
+
+    //Rank-1 change: u has +1 at 'a' and -1 at 'b' (if they are unknowns)
+    struct Update {
+        int a, b;
+        //1 / dg for resistor, 0 for closed switch
+        double inverse;
+        //right side of switch constraint: u^T v = c
+        double c;
+        //A^-1 * u for factorized matrix A, index of cached vector
+        size_t z;
+    };
+
+    //Finds groups for current connections
+    Topology topology() const;
+
+    //Orders and factorizes matrix for topology
+    void build(const Topology& topology);
+
+    //Fills matrix with current conductances and factorizes it
+    void factorize();
+
+    //Voltage of fixed group
+    double fixedVoltage(int group) const;
+
+    //Collects updates against factorized matrix, returns false if matrix has to be built again
+    bool collectUpdates();
+
+    //Cached A^-1 * u for update of resistor or switch
+    size_t cached(std::vector<int>& cache, size_t i, int a, int b);
+
+    std::vector<Resistor*> _resistors;
+    std::vector<Switch*> _switches;
+    std::vector<Component*> _wires;
+    //components which can drive nets, their groups are fixed
+    std::vector<Component*> _sources;
+
+    Topology _topology;
+    std::vector<Branch> _branches;
+    //unknown of every group, -1 for fixed or floating group
+    std::vector<int> _unknowns;
+    //group of every unknown
+    std::vector<int> _groups;
+
+    //switch was flipped after its nets were merged into the matrix
+    std::vector<bool> _volatile;
+    //state of every switch when matrix was built
+    std::vector<bool> _closed;
+
+    SparseLU _lu;
+    std::vector<double> _values;
+    std::vector<double> _rhs;
+
+    std::vector<Update> _updates;
+    std::vector<std::vector<double>> _z;
+    std::vector<int> _resistorZ, _switchZ;
+
+    unsigned long _version = 0;
+    bool _built = false;
+    size_t _factorizations = 0;
+    size_t _analyses = 0;
+};
+
+#endif /* ANALOG_SOLVER_HPP */
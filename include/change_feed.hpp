@@ -0,0 +1,95 @@
+#ifndef CHANGE_FEED_HPP
+#define CHANGE_FEED_HPP
+
+#include "logic.hpp"
+
+#include <cstddef>
+#include <vector>
+
+/*
+ * One stream of changes of logic levels for everything which records them (VcdWriter, TraceBuffer, ChangeLog).
+ * While there are subscribers, NetList remembers nets whose level changed, and publish() hands every
+ * subscriber only its probes on those nets. Cost of a moment depends on number of changes,
+ * not on number of probes.
+ *
+ * Probe is node given by coordinates. Nodes are looked up only when nets were edited
+ * (NetList::version changed), then all probes are compared once. Probe without node reads as floating net.
+ *
+ * Timeline publishes after every moment. Changes made between moments (switch clicked by user,
+ * initial settling) are published by owner.
+*/
+class ChangeFeed {
+public:
+    class Subscriber {
+    public:
+        Subscriber();
+        virtual ~Subscriber();
+
+        Subscriber(const Subscriber&) = delete;
+        Subscriber& operator=(const Subscriber&) = delete;
+
+    protected:
+        //Adds probe on node at (x, y), its level is reported at next publish. Returns its index
+        size_t watch(int x, int y);
+
+        //Removes probe, probes after it move one place down
+        void unwatch(size_t probe);
+
+        //True if probe is on net of node at (x, y)
+        bool watches(size_t probe, int x, int y) const;
+
+        //Forgets reported levels, so all probes are reported again at next publish
+        void resend() {
+            _stale = true;
+            for (auto& probe : _probes) probe.last = 0xff;
+        }
+
+        //Probe changed to 'value' at 'time'. Changes of one moment come in order of probes
+        virtual void changed(long long time, size_t probe, Logic::Value value) = 0;
+
+        //All changes of moment 'time' were reported
+        virtual void published(long long time) {
+            (void) time;
+        }
+
+    private:
+        friend class ChangeFeed;
+
+        struct Probe {
+            int x;
+            int y;
+            //root net of node, -1 without node
+            int net;
+            //level reported last, 0xff before the first one
+            unsigned char last;
+        };
+
+        //Reports probes on changed nets, or all probes after nets were edited
+        void update(long long time, const std::vector<int>& nets);
+
+        //Finds nodes of probes again
+        void locate();
+
+        //Reports probe if its level differs from the last reported one
+        void compare(long long time, size_t probe);
+
+        std::vector<Probe> _probes;
+        //first probe on every net and next probe on the same net, -1 at end
+        std::vector<int> _first;
+        std::vector<int> _next;
+        unsigned long _version = 0;
+        bool _stale = true;
+        //probes touched in one moment, reused
+        std::vector<size_t> _touched;
+    };
+
+    //Reports changes since previous publish to all subscribers
+    static void publish(long long time);
+
+private:
+    static std::vector<Subscriber*> _subscribers;
+    //changed nets of one moment, reused
+    static std::vector<int> _nets;
+};
+
+#endif /* CHANGE_FEED_HPP */
@@ -0,0 +1,109 @@
+#ifndef CHANGE_LOG_HPP
+#define CHANGE_LOG_HPP
+
+#include "change_feed.hpp"
+#include "logic.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ * History of logic levels of nets for waveform views.
+ * Changes come from ChangeFeed. Probe is node given by coordinates, so it survives editing of circuit:
+ * node is looked up again after nets changed, probe without node reads as floating net.
+ *
+ * Only changes are stored, for every probe ordered by time, so level at any moment is found
+ * by binary search. View which shows long history on few pixels asks for summary of pixel columns
+ * (summarize) instead of walking all changes, its cost depends on number of columns and not on
+ * length of history. When probe has more than 'limit' changes, older half of them is dropped
+ * and the last dropped level is kept as level before its first kept change.
+ *
+ * Before its first change probe is Z.
+*/
+class ChangeLog : private ChangeFeed::Subscriber {
+public:
+    //Summary of one column of time
+    struct Column {
+        //level just before column and at its end
+        Logic::Value first;
+        Logic::Value last;
+        //number of changes inside column, more than one can't be drawn one by one
+        uint32_t changes;
+    };
+
+    explicit ChangeLog(size_t limit = 1 << 20);
+
+    //Adds probe on node at (x, y), returns its index
+    size_t addProbe(const std::string& name, int x, int y);
+
+    //Removes probe, probes after it move one place down
+    void removeProbe(size_t probe);
+
+    size_t probes() const {
+        return _probes.size();
+    }
+
+    const std::string& name(size_t probe) const {
+        return _probes[probe].name;
+    }
+
+    //True if net of node at (x, y) already has probe
+    bool probed(int x, int y) const;
+
+    //Drops history, probes stay
+    void clear();
+
+    /*
+     * Time of the oldest kept change, but not before the first kept change of probe which dropped
+     * some history (its older levels aren't known). -1 if there is no change
+    */
+    long long begin() const;
+
+    //Time of the last published moment, -1 before the first one
+    long long end() const {
+        return _end;
+    }
+
+    //Number of kept changes of probe
+    size_t changes(size_t probe) const {
+        return _probes[probe].times.size();
+    }
+
+    //Level of probe at given time
+    Logic::Value level(size_t probe, long long time) const;
+
+    /*
+     * Fills 'columns' (its size is number of columns) with summary of probe in time from 'from' to 'to',
+     * which is divided in columns of equal width
+    */
+    void summarize(size_t probe, long long from, long long to, std::vector<Column>& columns) const;
+
+private:
+    struct Probe {
+        std::string name;
+        std::vector<long long> times;
+        std::vector<unsigned char> values;
+        //level before the first kept change, 0xff if nothing was dropped
+        unsigned char dropped;
+    };
+
+    void changed(long long time, size_t probe, Logic::Value value) override;
+
+    void published(long long time) override {
+        _end = time;
+    }
+
+    //Level of probe after its change 'index' - 1 (level before kept changes if index is 0)
+    static Logic::Value after(const Probe& probe, size_t index) {
+        if (index > 0) return static_cast<Logic::Value>(probe.values[index - 1]);
+        return probe.dropped != 0xff ? static_cast<Logic::Value>(probe.dropped) : Logic::Z;
+    }
+
+    std::vector<Probe> _probes;
+    size_t _limit;
+    long long _end = -1;
+};
+
+#endif /* CHANGE_LOG_HPP */
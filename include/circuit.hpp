@@ -17,6 +17,23 @@ public:
     //Adds component to circuit
     void addComponent(Component* c);
 
+    //Makes room for 'count' components, so adding them doesn't reallocate
+    void reserve(size_t count);
+
+    /*
+     * Batch edit for loading, pasting or scripts: between begin and commit, connections
+     * and parameter changes only mark their nets as dirty, and all of them are propagated
+     * once at commit. Batches can be nested, only the outermost commit propagates.
+    */
+    void begin();
+
+    //Ends batch edit. Throws std::logic_error without matching begin
+    void commit();
+
+    bool inBatch() const {
+        return _batches > 0;
+    }
+
     //Removes all components from circuit
     void removeComponents();
 
@@ -33,6 +50,7 @@ public:
 
 private:
     std::vector<Component*> _components;
+    unsigned _batches = 0;
 };
 
 #endif /* CIRCUIT_HPP */
@@ -0,0 +1,144 @@
+#ifndef COMPILED_LOGIC_HPP
+#define COMPILED_LOGIC_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+class Component;
+
+/*
+ * Combinational gates compiled into flat program.
+ * Gates are levelized (every gate comes after gates which drive its inputs) and each one
+ * becomes instruction (opcode, input, input, output) over bit values of nets.
+ * When some input net of block changes, scheduler evaluates whole program in one loop
+ * instead of calling gates one by one and converting voltages between them.
+ *
+ * Program is split into tasks for ThreadPool: clusters of gates which are not connected
+ * through nets are independent, big clusters are split by levels. Stages of tasks run one
+ * after another and tasks of one stage in parallel. Every task writes only its own slots
+ * and partition doesn't depend on number of threads, so results are the same for any of them.
+ *
+ * In four-state mode slots hold Logic values and every instruction is one lookup in table of results.
+ *
+ * Gates in feedback loops, gates whose output net is driven by some other component,
+ * gates with propagation delay, flip-flops and decoders are not compiled and stay event-driven.
+ * Program is rebuilt automatically when nets or connections change.
+*/
+class CompiledLogic {
+public:
+    enum Opcode : unsigned char {
+        AND, OR, XOR, NAND, NOR, NXOR, NOT
+    };
+
+    //Operands are slots of nets in block, NOT uses only 'a'
+    struct Instruction {
+        Opcode op;
+        unsigned a, b, out;
+    };
+
+    //Compiles logic gates from given components, other components are ignored
+    explicit CompiledLogic(const std::vector<Component*>& components);
+
+    //Gates go back to event-driven mode
+    ~CompiledLogic();
+
+    CompiledLogic(const CompiledLogic&) = delete;
+    CompiledLogic& operator=(const CompiledLogic&) = delete;
+
+    //Reads input nets, runs program and drives output nets which are changed
+    void evaluate();
+
+    /*
+     * Runs program on 64 * width patterns at once, nets are not changed.
+     * 'words' has 'width' words for every slot (slot s starts at s * width),
+     * bit i of word j is logical value in pattern 64 * j + i.
+     * Words of input slots have to be set before, others are calculated.
+    */
+    void evaluate(std::vector<uint64_t>& words, unsigned width = 1);
+
+    /*
+     * Four-state version of evaluate on two bit-planes with the same layout as 'words':
+     * bit of 'values' is logical value and bit of 'unknown' is set if signal is X or Z (see Logic)
+    */
+    void evaluate(std::vector<uint64_t>& values, std::vector<uint64_t>& unknown, unsigned width = 1);
+
+    //Number of nets used by program
+    size_t slots();
+
+    //Slot of net, -1 if program doesn't use it
+    int slot(int net);
+
+    //Net of slot
+    int net(unsigned slot);
+
+    //Slots which program reads, but doesn't drive
+    const std::vector<unsigned>& inputs();
+
+    //Compiled instructions in order of evaluation
+    const std::vector<Instruction>& program();
+
+    //Number of gates left in event-driven mode
+    size_t fallbacks();
+
+    //Length of the longest path through compiled gates
+    unsigned levels();
+
+    //Number of parallel tasks in all stages
+    size_t tasks();
+
+    //Number of groups of tasks which have to run one after another
+    size_t stages();
+
+private:
+    friend class Scheduler;
+    friend class Component;
+
+    //Levelizes gates and builds program for current nets
+    void compile();
+
+    //Recompiles if nets or connections changed since last compilation
+    void update();
+
+    //Orders program into tasks and stages, 'levels' has level of every instruction
+    void partition(const std::vector<unsigned>& levels);
+
+    //Runs task for every part of program, in parallel if there are more threads
+    void runTasks(const std::function<void(const Instruction*, const Instruction*)>& task);
+
+    //Removes gate which is being destroyed
+    void remove(Component* gate);
+
+    //All logic gates given to block
+    std::vector<Component*> _candidates;
+
+    std::vector<Instruction> _program;
+    //gate of every instruction, notified when its output changes
+    std::vector<Component*> _gates;
+    //net id of every slot
+    std::vector<int> _nets;
+    std::unordered_map<int, unsigned> _slots;
+    //slots which are not driven by program
+    std::vector<unsigned> _inputs;
+    std::vector<unsigned char> _values;
+
+    //Parts of program, range of instructions
+    struct Range {
+        size_t begin, end;
+    };
+    std::vector<std::vector<Range>> _stages;
+
+    size_t _fallbacks = 0;
+    unsigned _levels = 0;
+    unsigned long _version = 0;
+    bool _compiled = false;
+
+    //block waits in scheduler queue, same as Component
+    bool _queued = false;
+    unsigned _run = 0;
+    unsigned _evaluations = 0;
+};
+
+#endif /* COMPILED_LOGIC_HPP */
@@ -0,0 +1,156 @@
+#ifndef COMPONENT_ITEM_H
+#define COMPONENT_ITEM_H
+
+#include "components.hpp"
+
+#include <QPainter>
+#include <QGraphicsItem>
+#include <QGraphicsSceneMouseEvent>
+#include <QGraphicsSceneHoverEvent>
+#include <QApplication>
+#include <QPen>
+#include <QObject>
+
+/*
+ * Graphics item which shows component on the scene.
+ * Item owns core component and only draws it and passes user actions to it,
+ * simulation doesn't know anything about items.
+*/
+class ComponentItem : public QGraphicsItem, public ComponentObserver {
+public:
+    //Takes ownership of component
+    ComponentItem(Component* component);
+
+    ~ComponentItem() override;
+
+    ComponentItem(const ComponentItem&) = delete;
+    ComponentItem& operator=(const ComponentItem&) = delete;
+
+    Component* component() const;
+
+    //Connects component to nodes on its current connection points
+    void connect();
+
+    //True if component is connected to nodes on its current connection points
+    bool connectedInPlace() const;
+
+    //Rotates component and item together
+    void rotate(int angle);
+
+    //Moves and transforms item like its component, after component was placed directly
+    void updateFromComponent();
+
+    QRectF boundingRect() const override;
+
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+    //Repaints item when component is evaluated
+    void componentChanged(const Component& component) override;
+
+protected:
+    //Returns voltage of node 'id', or 0 if component isn't connected to it
+    double nodeVoltage(unsigned id) const;
+
+    QPen penForLines;
+    QPen penForLinesWhite;
+    QPen penForDots;
+    QPen penForLeadsGreen;
+    QPen penForLeadsRed;
+	QPen penForDigit;
+
+    QVariant itemChange(GraphicsItemChange change, const QVariant &value) override;
+
+    void mousePressEvent(QGraphicsSceneMouseEvent* event) override;
+    void mouseReleaseEvent(QGraphicsSceneMouseEvent* event) override;
+    void mouseMoveEvent(QGraphicsSceneMouseEvent* event) override;
+    void hoverEnterEvent(QGraphicsSceneHoverEvent* event) override;
+    void hoverLeaveEvent(QGraphicsSceneHoverEvent* event) override;
+
+private:
+    std::unique_ptr<Component> _component;
+};
+
+//Item with access to its component with the right type
+template <class T>
+class TypedComponentItem : public ComponentItem {
+public:
+    T* component() const {
+        return static_cast<T*>(ComponentItem::component());
+    }
+
+protected:
+    TypedComponentItem(T* component)
+        : ComponentItem(component)
+    {}
+};
+
+
+class GroundItem : public TypedComponentItem<Ground> {
+public:
+    GroundItem();
+
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+};
+
+
+class WireItem : public TypedComponentItem<Wire> {
+public:
+    WireItem();
+
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+    //Changes length of wire, it has to be reconnected after that
+    void setLength(double length);
+
+protected:
+    void mouseDoubleClickEvent(QGraphicsSceneMouseEvent* event) override;
+};
+
+
+class ResistorItem : public TypedComponentItem<Resistor> {
+public:
+    ResistorItem();
+
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+protected:
+    void mouseDoubleClickEvent(QGraphicsSceneMouseEvent* event) override;
+};
+
+
+class SwitchItem : public TypedComponentItem<Switch> {
+public:
+    SwitchItem();
+
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+protected:
+    void mousePressEvent(QGraphicsSceneMouseEvent* event) override;
+};
+
+
+class DCVoltageItem : public TypedComponentItem<DCVoltage> {
+public:
+    DCVoltageItem();
+
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+
+protected:
+    //For derived sources
+    DCVoltageItem(DCVoltage* source);
+
+    void mouseDoubleClickEvent(QGraphicsSceneMouseEvent* event) override;
+};
+
+
+//Clock is ticked by Timeline, which MainWindow advances with one timer for all clocks
+class ClockItem : public DCVoltageItem {
+public:
+	ClockItem(double voltage = 5, int timeInterval = 500);
+
+    Clock* component() const {
+        return static_cast<Clock*>(ComponentItem::component());
+    }
+};
+
+#endif // COMPONENT_ITEM_H
@@ -0,0 +1,68 @@
+#ifndef COMPONENT_TYPE_HPP
+#define COMPONENT_TYPE_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class Component;
+struct ComponentRecord;
+
+//Kind of component, in order in which schematic files are loaded (wires after components on their ends)
+enum class ComponentKind : unsigned char {
+    AND, NAND, OR, NOR, XOR, NXOR, NOT, LCD, DECODER, FLIPFLOP,
+    SWITCH, GROUND, CLOCK, WIRE, VOLTAGE, RESISTOR
+};
+
+//Number of kinds, tables indexed by kind have this size
+const size_t COMPONENT_KINDS = static_cast<size_t>(ComponentKind::RESISTOR) + 1;
+
+//Everything that is needed to make, load and save component of one kind
+struct ComponentType {
+    ComponentKind kind;
+    //name in schematic files and componentType()
+    std::string name;
+    //name in palette of GUI
+    std::string label;
+    unsigned pins;
+
+    //Makes new component, parameter of record is used only by types which need it in constructor (clock)
+    Component* (*create)(const ComponentRecord& record);
+
+    //Sets saved parameter on component which isn't connected yet, nullptr if type doesn't have parameter
+    void (*load)(Component* component, const ComponentRecord& record);
+
+    //Returns parameter which is saved with component, nullptr if type doesn't have parameter
+    double (*save)(const Component& component);
+};
+
+/*
+ * Registry of all component types. Components know only their kind,
+ * name and everything else is looked up here, so there is one place
+ * which has to be changed when new type is added.
+*/
+class ComponentTypes {
+public:
+    //All types, indexed by kind
+    static const std::vector<ComponentType>& all();
+
+    static const ComponentType& get(ComponentKind kind) {
+        return all()[static_cast<size_t>(kind)];
+    }
+
+    //Type with name used in files, nullptr if there is no such type
+    static const ComponentType* find(const std::string& name);
+
+    //Same as find, but 'hint' is checked first, so records grouped by type are looked up once per group
+    static const ComponentType* find(const std::string& name, const ComponentType* hint) {
+        return hint != nullptr && hint->name == name ? hint : find(name);
+    }
+
+    //Makes new component of kind with default parameters
+    static Component* create(ComponentKind kind);
+
+    //Type with name used in palette of GUI, nullptr if there is no such type
+    static const ComponentType* findLabel(const std::string& label);
+};
+
+#endif /* COMPONENT_TYPE_HPP */
@@ -1,32 +1,25 @@
 #ifndef COMPONENTS_HPP
 #define COMPONENTS_HPP
 
-#define QTPAINT
-
-#ifdef QTPAINT
-#include "math.h"
-
-#include <QPainter>
-#include <QGraphicsItem>
-#include <QGraphicsRectItem>
-#include <QGraphicsSceneMouseEvent>
-#include <QGraphicsSceneHoverEvent>
-#include <QApplication>
-#include <QPen>
-#include <QSize>
-#include <QTimer>
-#include <qobject.h>
-#endif
-
 #include <string>
 #include <vector>
 #include <memory>
-#include <set>
 #include <algorithm> //std::find_if
+#include <iterator> //std::inserter
 #include <cassert>
+#include <cstdint>
 #include <iomanip> //std::setprecision
 #include <sstream> // stringstream
 
+#include "component_type.hpp"
+#include "delay.hpp"
+#include "node_registry.hpp"
+#include "pin_table.hpp"
+#include "slab_allocator.hpp"
+#include "scheduler.hpp"
+#include "net.hpp"
+#include "timeline.hpp"
+
 //Interface for counting and naming components in the same class
 template <class T>
 class Counter {
@@ -55,15 +48,56 @@ public:
 bool doubleEquals(double a, double b, double epsilon = 1e-5);
 
 class Component;
+class CompiledLogic;
 
-class Node : public Counter<Node> {
+//Interface for views of component (e.g. items in GUI), they are notified when component is evaluated
+class ComponentObserver {
 public:
-    //voltage in node
-    double _v = 0;
+    virtual ~ComponentObserver() {}
+
+    virtual void componentChanged(const Component& component) = 0;
+};
+
+/*
+ * Affine transformation of component, in the same convention as QTransform:
+ * point (x, y) is mapped to (m11*x + m21*y + dx, m12*x + m22*y + dy)
+*/
+struct Transform {
+    double m11 = 1, m12 = 0;
+    double m21 = 0, m22 = 1;
+    double dx = 0, dy = 0;
+
+    std::pair<double, double> map(double x, double y) const {
+        return std::pair<double, double>(m11*x + m21*y + dx, m12*x + m22*y + dy);
+    }
+
+    //Rotates around point (cx, cy) before current transformation
+    void rotate(int angle, double cx, double cy);
+};
 
+class Node : public Counter<Node> {
+public:
     //Creates node with given coordinates and optionally adds connection to component
 	Node(int x, int y, Component* const component);
 
+    //Makes shared node, node and its reference counts are one piece from slab allocator
+    static std::shared_ptr<Node> create(int x, int y, Component* const component);
+
+    //Removes node from its net
+    ~Node();
+
+    //Returns voltage in node, that is voltage of the whole net
+    double v() const;
+
+    //Sets voltage of the whole net. Components are not notified, see Component::driveNode
+    void setV(double v);
+
+    //Returns logic level of the whole net, Logic::floating() if node isn't in any net yet
+    Logic::Value level() const;
+
+    //Returns id of net which contains node, -1 if node isn't in any net yet
+    int net() const;
+
     //Returns node coordinates
 	int x() const;
 	int y() const;
@@ -72,16 +106,18 @@ public:
 	void addComponent(Component* const e);
 
     //Returns all direct components connected to node
-	std::vector<Component*> directComponents() const;
+	const std::vector<Component*>& directComponents() const;
 
     //Returns only direct components of type 'componentType' connected to node
 	std::vector<Component*> directComponents(const std::string& componentType) const;
+	std::vector<Component*> directComponents(ComponentKind kind) const;
 
-    //Returns all components connected to node, including wire connections
+    //Returns all components connected to node, including components on the other nodes of the same net
 	std::vector<Component*> components() const;
 
-    //Returns all components of type 'componentType' connected to node, including wire connections
+    //Returns all components of type 'componentType' connected to node, including components on the same net
 	std::vector<Component*> components(const std::string& componentType) const;
+	std::vector<Component*> components(ComponentKind kind) const;
 
     //Returns iterator to component
     std::vector<Component*>::iterator find(Component* const e);
@@ -95,16 +131,8 @@ public:
     //Disconnects node from component (delete connection node->component)
 	void disconnectFromComponent(Component* const e);
 
-	//Two nodes are the same if they have the same coordinates
-	struct lex_node_cmp {
-		bool operator() (const std::shared_ptr<Node>& n1,
-				const std::shared_ptr<Node>& n2) const {
-			return n1->to_string() < n2->to_string();
-		}
-	};
-
     //Set of all different nodes, compared by coordinates
-	static std::set<std::shared_ptr<Node>, lex_node_cmp> _allNodes;
+	static NodeRegistry _allNodes;
 
     //Finds all components with componentType directly connected to node (x, y)
 	static std::vector<Component*> findDirectlyConnected(const std::string& componentType, int x, int y);
@@ -113,7 +141,7 @@ public:
 	static std::vector<Component*> find(const std::string& componentType, int x, int y);
 
     //Finds node by coordinates
-    static std::set<std::shared_ptr<Node>, lex_node_cmp>::iterator find(int x, int y);
+    static NodeRegistry::iterator find(int x, int y);
 
     static size_t size() {
         return _allNodes.size();
@@ -125,45 +153,85 @@ private:
 	//connected components to node
 	std::vector<Component*> _components;
 
-    //string representation of coordinates: from (x, y) to "xy"
-    std::string to_string() const {
-        return std::to_string(_x) + std::to_string(_y);
-    }
+    friend class Scheduler;
+    friend class NetList;
+    //net which contains node and position of node in that net
+    int _net = -1;
+    unsigned _netIndex = 0;
 };
 
 
-class Component
-				#ifdef QTPAINT
-                : public QGraphicsItem
-				#endif
-				{
+class Component {
 public:
 	Component(const std::string &name);
 
-#ifdef QTPAINT
-    virtual QRectF boundingRect() const;
-
-    virtual void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
-    virtual std::vector<std::pair<int, int>> connectionPoints(void) const = 0;
-#endif
-
     virtual ~Component();
 
-	virtual std::string componentType() const = 0;
+    //Kind of component, everything else about its type is in ComponentTypes
+    virtual ComponentKind kind() const = 0;
+
+    //Name of type in schematic files
+    const std::string& componentType() const {
+        return ComponentTypes::get(kind()).name;
+    }
 
     Component(const Component&) = delete;
     Component& operator=(const Component&) = delete;
 
+    //Components are allocated from slabs, see SlabAllocator
+    static void* operator new(std::size_t size) {
+        return SlabAllocator::allocate(size);
+    }
+
+    static void operator delete(void* p, std::size_t size) {
+        SlabAllocator::deallocate(p, size);
+    }
+
 	std::string name() const;
     int rotationAngle() const;
     void setRotationAngle(int angle);
+
+    //Rotates component around center of its bounding rectangle and connects it to new connection points
     void rotate(int angle);
 
-    //All nodes that component have
-	std::vector<std::shared_ptr<Node>> nodes() const;
+    //Rotates component without connecting it, so component which isn't connected yet is connected only once
+    void orient(int angle);
+
+    //Position of component in scene
+    double x() const;
+    double y() const;
+    void setPosition(double x, double y);
+
+    //Rotation of component, without position
+    const Transform& transform() const;
+
+    //Size of bounding rectangle, which starts at (0, 0) in component coordinates
+    virtual double width() const {
+        return 100;
+    }
+
+    virtual double height() const {
+        return 100;
+    }
+
+    //Connection points in component coordinates
+    virtual std::vector<std::pair<double, double>> localConnectionPoints() const = 0;
+
+    //Connection points mapped to scene: rotated and moved to position of component
+    std::vector<std::pair<int, int>> connectionPoints() const;
+
+    //View which is notified when component is evaluated, component doesn't own it
+    void setObserver(ComponentObserver* observer);
+
+    void notifyObserver() const;
+
+    virtual std::string toString() const;
+
+    //All nodes that component have, in order of its pins
+	const PinTable& nodes() const;
 
     //Finds first node connected to component by coordinates
-    std::vector< std::shared_ptr<Node> >::iterator find(int x, int y);
+    PinTable::iterator find(int x, int y);
 
     /*
      * Checks if component have connection with node
@@ -198,13 +266,52 @@ public:
 
     /*
      * Forces all components connected to given node to calculate their voltage
-     * because voltage in node is changed
+     * because voltage in node is changed.
+     * Components are not called directly, node is scheduled and evaluated by Scheduler
     */
     void updateVoltages(const std::shared_ptr<Node>& node) const;
 
     virtual double voltage() const = 0;
+
+    /*
+     * Called by scheduler when voltage on some of the nets is changed.
+     * By default calculates voltage, components which drive nets override it
+    */
+    virtual void evaluate() const {
+        voltage();
+    }
+
+    //Returns true if component joins all its nodes into one net (wire, closed switch)
+    virtual bool joinsNets() const {
+        return false;
+    }
+
+    //Returns true if component only reads voltage on its pin 'pin' (index in nodes()) and never drives it
+    virtual bool isInput(unsigned pin) const {
+        (void)pin;
+        return false;
+    }
+
+    //Value which component drives on pin 'pin' in four-state mode, Z if it doesn't drive it
+    virtual Logic::Value drive(unsigned pin) const {
+        return pin < MAX_DRIVEN_PINS ? static_cast<Logic::Value>(_drives >> (2 * pin) & 3) : Logic::Z;
+    }
+
+    //Propagation delay of outputs: delay of this component if it is set, otherwise default delay of its kind
+    Delay delay() const {
+        return _delay >= 0 ? Delay(_delay, _delayModel) : Delays::get(kind());
+    }
+
+    //Overrides default delay of kind, throws std::invalid_argument if component can't have delay
+    void setDelay(Delay delay);
+
+    //Component takes default delay of its kind again
+    void clearDelay();
 private:
 	std::string _name;
+    double _x = 0, _y = 0;
+    Transform _transform;
+    ComponentObserver* _observer = nullptr;
 
     /*
      * Removes both connections: component->node and node->component
@@ -226,29 +333,62 @@ private:
 
 friend std::ostream& operator<<(std::ostream& out, const Component& c);
 
+    friend class Scheduler;
+    friend class CompiledLogic;
+    //component waits in scheduler queue
+    bool _queued = false;
+    //component is being destroyed and must not be evaluated anymore
+    bool _retired = false;
+    //number of evaluations in scheduler run '_run', used for iteration limit
+    unsigned _run = 0;
+    unsigned _evaluations = 0;
+    //compiled block which evaluates this gate instead of scheduler
+    CompiledLogic* _block = nullptr;
+
+    //values driven on pins in four-state mode, two bits per pin, all pins start as Z
+    static const unsigned MAX_DRIVEN_PINS = 16;
+    mutable uint32_t _drives = ~uint32_t(0);
+
+    //Sets value driven on pin, pins after MAX_DRIVEN_PINS can't drive
+    void setDrive(unsigned pin, Logic::Value value) const;
+
+    //Pin was removed: values of following pins move one pin back
+    void removeDrive(unsigned pin);
+
+    //delay of this component, -1 if it has default delay of its kind
+    int _delay = -1;
+    DelayModel _delayModel = DelayModel::INERTIAL;
+
+    friend class Delays;
+    //Drives value on node at once, driveNode does it after delay
+    void applyDrive(const std::shared_ptr<Node>& node, Logic::Value value) const;
+
 protected:
 	//component is connected to nodes
-    std::vector<std::shared_ptr<Node>> _nodes;
-    virtual std::string toString() const;
+    PinTable _nodes;
     int _rotationAngle;
 
-#ifdef QTPAINT
-    QPen penForLines;
-    QPen penForLinesWhite;
-    QPen penForDots;
-    QPen penForLeadsGreen;
-    QPen penForLeadsRed;
-	QPen penForDigit;
+    /*
+     * Sets voltage in node, and if it is changed
+     * forces components connected to node to calculate their voltage
+    */
+    void driveNode(const std::shared_ptr<Node>& node, double v) const;
 
-    QVariant itemChange(GraphicsItemChange change, const QVariant &value);
+    /*
+     * Drives logical value on all pins connected to node. In four-state mode net is resolved
+     * with values of other drivers, in two-state mode value is driven as its voltage.
+     * If component has delay, value is driven when simulated time moves by delay
+    */
+    void driveNode(const std::shared_ptr<Node>& node, Logic::Value value) const;
+
+    //Component won't be evaluated by scheduler anymore, called at the beginning of destructor
+    void retire();
 
-    void mousePressEvent(QGraphicsSceneMouseEvent* event);
-    void mouseReleaseEvent(QGraphicsSceneMouseEvent* event);
-    void mouseMoveEvent(QGraphicsSceneMouseEvent* event);
-    void hoverEnterEvent(QGraphicsSceneHoverEvent* event);
-    void hoverLeaveEvent(QGraphicsSceneHoverEvent* event);
+    //Joins all nodes of component into one net and propagates voltage of that net
+    void joinNodes() const;
 
-#endif
+    //Rebuilds net after component stopped joining its nodes and propagates new voltages
+    void splitNet(int net) const;
 };
 
 
@@ -256,16 +396,18 @@ class Ground : public Component, public Counter<Ground> {
 public:
 	Ground();
 
-    std::string componentType() const override { return "ground"; }
+    ComponentKind kind() const override { return ComponentKind::GROUND; }
 
     double voltage() const override;
 
+    Logic::Value drive(unsigned pin) const override {
+        (void)pin;
+        return Logic::ZERO;
+    }
+
     void addNode(int x, int y) override;
 
-#ifdef QTPAINT
-    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
-    std::vector<std::pair<int, int>> connectionPoints(void) const override;
-#endif
+    std::vector<std::pair<double, double>> localConnectionPoints() const override;
 };
 
 
@@ -275,15 +417,16 @@ public:
 
     ~Wire() override;
 
-    std::string componentType() const override { return "wire"; }
+    ComponentKind kind() const override { return ComponentKind::WIRE; }
 
     double voltage() const override;
 
     std::shared_ptr<Node> otherNode(int id) const;
 
-    void addNode(int x, int y) override;
+    //Wire joins nodes on both sides into one net
+    bool joinsNets() const override;
 
-    void connect(const std::vector<std::pair<int, int>> &connPts) override;
+    void addNode(int x, int y) override;
 
     void disconnect(int x, int y) override;
 
@@ -291,27 +434,18 @@ public:
 
     void reconnect(int xFrom, int yFrom, int xTo, int yTo) override;
 
-#ifdef QTPAINT
-    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
-    std::vector<std::pair<int, int>> connectionPoints(void) const override;
+	// Wire has her own width since it's changing as we make wire longer
+    double width() const override;
 
-	// Wire has her own boundingRect since it's changing as we make wire longer
-	QRectF boundingRect() const override;
+    double length() const;
 
-    void setBoundingRect(double width);
+    //Changes length, wire has to be reconnected to take new connection points
+    void setLength(double length);
+
+    std::vector<std::pair<double, double>> localConnectionPoints() const override;
 
-protected:
-    void mouseDoubleClickEvent(QGraphicsSceneMouseEvent* event) override;
-	QRectF changingBoundingRec;
-
-	// Start/End point and line of a wire
-	QPointF startWire;
-	QPointF endWire;
-	QLineF line;
-#endif
 private:
-    mutable double _leftV, _rightV;
-    mutable int _nodeVoltageChanged;
+    double _length;
 };
 
 
@@ -319,7 +453,7 @@ class Resistor : public Component, public Counter<Resistor> {
 public:
 	Resistor(double resistance = 1000);
 
-    std::string componentType() const override {return "resistor";}
+    ComponentKind kind() const override { return ComponentKind::RESISTOR; }
 
 	double resistance() const;
 
@@ -333,13 +467,7 @@ public:
 
     std::string toString() const override;
 
-#ifdef QTPAINT
-    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
-    std::vector<std::pair<int, int>> connectionPoints(void) const override;
-
-protected:
-    void mouseDoubleClickEvent(QGraphicsSceneMouseEvent* event) override;
-#endif
+    std::vector<std::pair<double, double>> localConnectionPoints() const override;
 
 private:
 	double _resistance;
@@ -358,10 +486,19 @@ public:
 
     ~Switch() override;
 
-    std::string componentType() const override {return "switch";}
+    ComponentKind kind() const override { return ComponentKind::SWITCH; }
+
+    //Closed switch joins nodes on both sides into one net
+    bool joinsNets() const override;
 
     void addNode(int x, int y) override;
 
+    void disconnect(int x, int y) override;
+
+    void disconnect() override;
+
+    void reconnect(int xFrom, int yFrom, int xTo, int yTo) override;
+
     void open();
 
     bool isOpened() const;
@@ -376,13 +513,7 @@ public:
 
     std::string toString() const override;
 
-#ifdef QTPAINT
-    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
-    std::vector<std::pair<int, int>> connectionPoints(void) const override;
-
-protected:
-    void mousePressEvent(QGraphicsSceneMouseEvent* event) override;
-#endif
+    std::vector<std::pair<double, double>> localConnectionPoints() const override;
 
 private:
     state _state;
@@ -391,9 +522,6 @@ private:
         LEFT = 0,
         RIGHT = 1
     };
-
-    mutable double _leftV, _rightV;
-    mutable int _nodeVoltageChanged;
 };
 
 
@@ -403,10 +531,19 @@ public:
 
     ~DCVoltage() override;
 
-    std::string componentType() const override {return "voltage";}
+    ComponentKind kind() const override { return ComponentKind::VOLTAGE; }
 
     double voltage() const override;
 
+    //Source always drives logical value of its voltage
+    Logic::Value drive(unsigned pin) const override {
+        (void)pin;
+        return Logic::fromVoltage(_voltage);
+    }
+
+    //Sets voltage in node again, if it is changed by someone else
+    void evaluate() const override;
+
 	void setVoltage(double voltage);
 
 	void addNode(int x, int y) override;
@@ -417,41 +554,36 @@ public:
 
 	void reconnect(int xFrom, int yFrom, int xTo, int yTo) override;
 
-#ifdef QTPAINT
-    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
-    std::vector<std::pair<int, int>> connectionPoints(void) const override;
-
-protected:
-    void mouseDoubleClickEvent(QGraphicsSceneMouseEvent* event) override;
-#endif
+    std::vector<std::pair<double, double>> localConnectionPoints() const override;
 
 private:
 	double _voltage;
 };
 
-#ifdef QTPAINT
-class Clock : public DCVoltage, public QObject {
+/*
+ * Voltage source which switches between 0 and its voltage every time interval.
+ * Clock doesn't measure time, it is registered in Timeline which ticks it in simulated time
+*/
+class Clock : public DCVoltage {
 public:
-	Clock(double voltage = 5, int clockFrequency = 500);
-	std::string componentType() const override {return "clock";}
+	Clock(double voltage = 5, int timeInterval = 500);
+	~Clock() override;
+	ComponentKind kind() const override { return ComponentKind::CLOCK; }
 
 	int timeInterval() const;
+    //Next edge is one new time interval from now
 	void setTimeInterval(int timeInterval);
     double oldVoltage() const;
 
-	~Clock() override;
-
     std::string toString() const override;
 
-	void timerEvent(QTimerEvent *event) override;
-	void mouseDoubleClickEvent(QGraphicsSceneMouseEvent* event) override;
+    //Switches voltage between 0 and old voltage
+    void tick();
 
 private:
 	double _oldVoltage;
 	int _timeInterval;
-	int	_timerId;
 };
-#endif
 
 std::ostream& operator<<(std::ostream& out, const Component& r);
 
@@ -0,0 +1,107 @@
+#ifndef DELAY_HPP
+#define DELAY_HPP
+
+#include "component_type.hpp"
+#include "logic.hpp"
+#include "timing_wheel.hpp"
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+class Component;
+
+/*
+ * Inertial delay swallows pulses shorter than delay: new value cancels change which didn't happen yet.
+ * Transport delay passes every change, only later.
+*/
+enum class DelayModel : unsigned char {
+    INERTIAL, TRANSPORT
+};
+
+//Propagation delay in milliseconds of simulated time, 0 is change at the same moment
+struct Delay {
+    int time = 0;
+    DelayModel model = DelayModel::INERTIAL;
+
+    Delay() {}
+
+    Delay(int time, DelayModel model = DelayModel::INERTIAL)
+        :time(time), model(model)
+    {}
+};
+
+/*
+ * Propagation delays of gates, flip-flops and decoders.
+ * Every kind has default delay (0 unless it is changed) and components can override it.
+ * Outputs of component with delay are not changed at once: change is put in timing wheel
+ * at time now + delay and Timeline applies it when simulated time gets there.
+ *
+ * Gates with delay are not compiled, see CompiledLogic.
+*/
+class Delays {
+public:
+    //True if components of kind can have delay, sources, wires, switches and displays can't
+    static bool delayable(ComponentKind kind) {
+        return kind <= ComponentKind::FLIPFLOP && kind != ComponentKind::LCD;
+    }
+
+    static Delay get(ComponentKind kind) {
+        return _defaults[static_cast<size_t>(kind)];
+    }
+
+    //Sets default delay of kind, throws std::invalid_argument if kind can't have delay or delay is negative
+    static void set(ComponentKind kind, Delay delay);
+
+    //Sets default delay of all kinds which can have it
+    static void setAll(Delay delay);
+
+    //Schedules change of value driven by component on its pin 'pin'
+    static void drive(const Component* component, unsigned pin, Logic::Value value, Delay delay);
+
+    //Time of next scheduled change, -1 if there is none
+    static long long nextTime() {
+        return _wheel.nextTime();
+    }
+
+    //Applies all changes at nextTime(), which has to be current simulated time
+    static void applyNext();
+
+    //Number of scheduled changes, including cancelled ones which are dropped when their time comes
+    static size_t pending() {
+        return _wheel.size();
+    }
+
+    //Cancels all changes scheduled by component, called when its pins change or it is destroyed
+    static void forget(const Component* component) {
+        if (!_pins.empty()) _pins.erase(component);
+    }
+
+    //Cancels all changes and starts from time 'now'
+    static void clear(long long now = 0);
+
+private:
+    struct Change {
+        long long time;
+        //increasing number, changes older than PinState::validFrom are cancelled
+        unsigned long long id;
+        const Component* component;
+        unsigned pin;
+        Logic::Value value;
+    };
+
+    struct PinState {
+        unsigned long long validFrom;
+        //changes which are not cancelled, and value after the last of them
+        unsigned pending;
+        Logic::Value projected;
+    };
+
+    static Delay _defaults[COMPONENT_KINDS];
+    static TimingWheel<Change> _wheel;
+    //pins of components which have scheduled changes
+    static std::unordered_map<const Component*, std::vector<PinState>> _pins;
+    static unsigned long long _nextId;
+};
+
+#endif /* DELAY_HPP */
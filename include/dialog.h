@@ -8,14 +8,14 @@
 #include <QDialogButtonBox>
 #include <QKeyEvent>
 
-#include "components.hpp"
+#include "component_item.h"
 
 // Dialog opens on right click for resistance and dc voltage
 class Dialog: public QDialog {
     Q_OBJECT
 
 public:
-	explicit Dialog(Component* component, QWidget* parent = nullptr);
+	explicit Dialog(ComponentItem* item, QWidget* parent = nullptr);
 	~Dialog() override;
 
 protected:
@@ -26,6 +26,7 @@ private slots:
 	void onOkButtonInDialog();
 
 private:
+	ComponentItem* item;
 	Component* component;
 	QLabel *nameLabel;
 	QLabel *errorLabel;
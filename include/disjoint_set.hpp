@@ -0,0 +1,71 @@
+#ifndef DISJOINT_SET_HPP
+#define DISJOINT_SET_HPP
+
+#include <vector>
+#include <utility>
+
+//Union-find over integer ids, with union by rank and path halving
+class DisjointSet {
+public:
+    DisjointSet(int size = 0)
+    {
+        reset(size);
+    }
+
+    //Every id from 0 to size-1 becomes set for itself
+    void reset(int size) {
+        _parent.resize(size);
+        _rank.assign(size, 0);
+        for (int i = 0; i < size; ++i) _parent[i] = i;
+    }
+
+    //Adds new set with one element, returns its id
+    int add() {
+        _parent.push_back(static_cast<int>(_parent.size()));
+        _rank.push_back(0);
+        return _parent.back();
+    }
+
+    //Makes id set for itself again, used when id is reused
+    void isolate(int id) {
+        _parent[id] = id;
+        _rank[id] = 0;
+    }
+
+    //Returns representative of set which contains id
+    int find(int id) {
+        while (_parent[id] != id) {
+            _parent[id] = _parent[_parent[id]];
+            id = _parent[id];
+        }
+        return id;
+    }
+
+    //Joins sets which contain a and b, returns representative of joined set
+    int unite(int a, int b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return a;
+
+        if (_rank[a] < _rank[b]) std::swap(a, b);
+        _parent[b] = a;
+        if (_rank[a] == _rank[b]) ++_rank[a];
+        return a;
+    }
+
+    //Makes root representative of child's set, both must be representatives
+    void link(int child, int root) {
+        _parent[child] = root;
+        if (_rank[root] <= _rank[child]) _rank[root] = _rank[child] + 1;
+    }
+
+    int size() const {
+        return static_cast<int>(_parent.size());
+    }
+
+private:
+    std::vector<int> _parent;
+    std::vector<unsigned> _rank;
+};
+
+#endif /* DISJOINT_SET_HPP */
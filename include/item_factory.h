@@ -0,0 +1,22 @@
+#ifndef ITEM_FACTORY_H
+#define ITEM_FACTORY_H
+
+#include "component_item.h"
+#include "schematic.hpp"
+
+#include <vector>
+
+/*
+ * Makes graphics items by kind of component. Palette, drop on scene and opening of files
+ * make items only here, new type needs one entry in ComponentTypes and one entry here.
+*/
+class ItemFactory {
+public:
+    //Makes item with new component, parameter of record is used only by types which need it in constructor (clock)
+    static ComponentItem* create(ComponentKind kind, const ComponentRecord& record = ComponentRecord());
+
+    //Kinds in order in which they are shown in palette
+    static const std::vector<ComponentKind>& palette();
+};
+
+#endif // ITEM_FACTORY_H
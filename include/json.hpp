@@ -0,0 +1,53 @@
+#ifndef JSON_HPP
+#define JSON_HPP
+
+#include <string>
+
+/*
+ * Pull parser for schematic files: reads JSON text value by value, without building document,
+ * so values go straight to their final storage. Core library can't use QJsonDocument,
+ * because it doesn't depend on Qt.
+ * Text isn't copied and doesn't have to end with '\0'.
+*/
+class JsonReader {
+public:
+    JsonReader(const char* begin, const char* end)
+        :_begin(begin), _pos(begin), _end(end)
+    {}
+
+    //Next character after spaces, throws at the end of text
+    char peek();
+
+    //Skips next character if it is 'c'
+    bool accept(char c);
+
+    //Skips next character, throws if it isn't 'c'
+    void expect(char c);
+
+    //Throws if there is anything except spaces after current position
+    void expectEnd();
+
+    std::string readString();
+    double readNumber();
+    bool readBool();
+    void readNull();
+
+    //Skips value of any type, including nested arrays and objects
+    void skipValue();
+
+    //Throws std::runtime_error with current position
+    [[noreturn]] void error(const std::string& message) const;
+
+private:
+    void skipSpaces() {
+        while (_pos != _end && (*_pos == ' ' || *_pos == '\t' || *_pos == '\n' || *_pos == '\r')) ++_pos;
+    }
+
+    void expectWord(const char* word);
+
+    const char* _begin;
+    const char* _pos;
+    const char* _end;
+};
+
+#endif /* JSON_HPP */
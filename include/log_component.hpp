@@ -16,97 +16,76 @@ public:
     void disconnect(int x, int y) override;
 
     void disconnect() override;
-#ifdef QTPAINT
-	std::vector<std::pair<int, int>> connectionPoints(void) const override;
-#endif
 
-protected:
-	std::string toString() const override;
+    //All pins except the last one (output) are inputs
+    bool isInput(unsigned pin) const override;
+
+    double width() const override {
+        return 180;
+    }
+
+    double height() const override {
+        return 120;
+    }
 
-#ifdef QTPAINT
-    QRectF boundingRect() const override;
+	std::vector<std::pair<double, double>> localConnectionPoints() const override;
 
-    void voltageDependedSetPen(QPainter* painter, unsigned id);
-    void voltageDependedDrawLine(QLineF line, QPainter* painter, unsigned id);
-#endif
+protected:
+	std::string toString() const override;
 };
 
 class ANDGate : public LogicGate, public Counter<ANDGate>{
 public:
     ANDGate();
 
-    std::string componentType() const override { return "and"; }
+    ComponentKind kind() const override { return ComponentKind::AND; }
     
     double voltage() const override;
-#ifdef QTPAINT
-    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
-#endif
-
 };
 
 class ORGate : public LogicGate, public Counter<ORGate>{
 public:
     ORGate();
 
-    std::string componentType() const override { return "or"; }
+    ComponentKind kind() const override { return ComponentKind::OR; }
 
     double voltage() const override;
-#ifdef QTPAINT
-    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
-#endif
-
 };
 
 class XORGate : public LogicGate, public Counter<XORGate>{
 public:
     XORGate();
 
-    std::string componentType() const override { return "xor"; }
+    ComponentKind kind() const override { return ComponentKind::XOR; }
 
     double voltage() const override;
-#ifdef QTPAINT
-    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
-#endif
-
 };
 
 class NANDGate : public LogicGate, public Counter<NANDGate>{
 public:
     NANDGate();
 
-    std::string componentType() const override { return "nand"; }
+    ComponentKind kind() const override { return ComponentKind::NAND; }
     
     double voltage() const override;
-#ifdef QTPAINT
-    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
-#endif
-
 };
 
 class NORGate : public LogicGate, public Counter<NORGate>{
 public:
     NORGate();
     
-    std::string componentType() const override { return "nor"; }
+    ComponentKind kind() const override { return ComponentKind::NOR; }
 
     double voltage() const override;
-#ifdef QTPAINT
-    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
-#endif
-
 };
 
 class NXORGate : public LogicGate, public Counter<NXORGate>{
 public:
     NXORGate();
     
-    std::string componentType() const override { return "nxor"; }
+    ComponentKind kind() const override { return ComponentKind::NXOR; }
 
     double voltage() const override;
-#ifdef QTPAINT
-    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
-#endif
-
 };
 
 class NOTGate: public LogicGate, public Counter<NOTGate> {
@@ -115,17 +94,15 @@ public:
 
     ~NOTGate() override;
 
-    std::string componentType() const override { return "not"; }
+    ComponentKind kind() const override { return ComponentKind::NOT; }
 
     double voltage() const override;
 
     void disconnect(int x, int y) override;
 
     void disconnect() override;
-#ifdef QTPAINT
-    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
-    std::vector<std::pair<int, int>> connectionPoints(void) const override;
-#endif
+
+    std::vector<std::pair<double, double>> localConnectionPoints() const override;
 
 private:
 	std::string toString() const override;
@@ -142,26 +119,44 @@ public:
 		J, CLK, K, Q, Qc
     };
 
-    std::string componentType() const override { return "flipflop"; }
+    ComponentKind kind() const override { return ComponentKind::FLIPFLOP; }
 
     std::string toString() const override;
 
+    bool isInput(unsigned pin) const override {
+        return pin < Q;
+    }
+
     double voltage() const override;
 
     void disconnect(int x, int y) override;
 
     void disconnect() override;
-#ifdef QTPAINT
-    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
-    std::vector<std::pair<int, int>> connectionPoints(void) const override;
-protected:
-	QRectF boundingRect() const override;
-#endif
 
+    double width() const override {
+        return 160;
+    }
+
+    double height() const override {
+        return 180;
+    }
+
+    std::vector<std::pair<double, double>> localConnectionPoints() const override;
+
+protected:
     void set() const;
     void reset() const;
+
+    //Drives X on both outputs, four-state mode only
+    void unknown() const;
 private:
-    mutable bool _old_clk;
+    //State after edge of clock, X inputs in four-state mode give UNKNOWN if their values lead to different states
+    int nextState(Logic::Value j, Logic::Value k) const;
+
+    mutable Logic::Value _old_clk;
+    //-1 before first clock edge, 0 after reset, 1 after set
+    mutable int _state;
+    static const int UNKNOWN = 2;
 };
 
 
@@ -170,7 +165,7 @@ public:
     Decoder();
 	~Decoder() override;
 
-    std::string componentType() const override { return "decoder"; }
+    ComponentKind kind() const override { return ComponentKind::DECODER; }
 
     enum pin {
         I3, I2, I1, I0,
@@ -183,15 +178,24 @@ public:
 
     void disconnect() override;
 
-#ifdef QTPAINT
-    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
-    std::vector<std::pair<int, int>> connectionPoints(void) const override;
-protected:
-	QRectF boundingRect() const override;
-#endif
+    bool isInput(unsigned pin) const override {
+        return pin <= I0;
+    }
+
+    double width() const override {
+        return 150;
+    }
+
+    double height() const override {
+        return 180;
+    }
+
+    std::vector<std::pair<double, double>> localConnectionPoints() const override;
 
 private:
-	int  inputToBinaryInt(double a, double b, double c, double d) const;
+	//Number on inputs, -1 if some input is unknown (four-state mode)
+	int  inputToBinaryInt(Logic::Value a, Logic::Value b, Logic::Value c, Logic::Value d) const;
+	//Drives segments of digit 'input', all segments are X if it is -1
 	void decodeOutput(int input) const;
 	void updateVoltages() const;
 	std::string toString() const override;
@@ -205,7 +209,7 @@ public:
 
     std::string toString() const override;
 
-    std::string componentType() const override { return "lcd"; }
+    ComponentKind kind() const override { return ComponentKind::LCD; }
 
     enum pin {
         a, b, c, d, e, f, g
@@ -215,12 +219,21 @@ public:
         return 0;
     }
 
-#ifdef QTPAINT
-    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
-    std::vector<std::pair<int, int>> connectionPoints(void) const override;
-protected:
-	QRectF boundingRect() const override;
-#endif
+    //Display only shows voltages
+    bool isInput(unsigned pin) const override {
+        (void)pin;
+        return true;
+    }
+
+    double width() const override {
+        return 150;
+    }
+
+    double height() const override {
+        return 180;
+    }
+
+    std::vector<std::pair<double, double>> localConnectionPoints() const override;
 };
 
 #endif /* ifndef LOG_COMPONENTS_HPP */
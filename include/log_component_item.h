@@ -0,0 +1,86 @@
+#ifndef LOG_COMPONENT_ITEM_H
+#define LOG_COMPONENT_ITEM_H
+
+#include "component_item.h"
+#include "log_component.hpp"
+
+class LogicGateItem : public ComponentItem {
+public:
+    LogicGateItem(LogicGate* gate);
+
+protected:
+    void voltageDependedSetPen(QPainter* painter, unsigned id);
+    void voltageDependedDrawLine(QLineF line, QPainter* painter, unsigned id);
+};
+
+class ANDGateItem : public LogicGateItem {
+public:
+    ANDGateItem();
+
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+};
+
+class ORGateItem : public LogicGateItem {
+public:
+    ORGateItem();
+
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+};
+
+class XORGateItem : public LogicGateItem {
+public:
+    XORGateItem();
+
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+};
+
+class NANDGateItem : public LogicGateItem {
+public:
+    NANDGateItem();
+
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+};
+
+class NORGateItem : public LogicGateItem {
+public:
+    NORGateItem();
+
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+};
+
+class NXORGateItem : public LogicGateItem {
+public:
+    NXORGateItem();
+
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+};
+
+class NOTGateItem : public LogicGateItem {
+public:
+    NOTGateItem();
+
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+};
+
+class JKFlipFlopItem : public LogicGateItem {
+public:
+    JKFlipFlopItem();
+
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+};
+
+class DecoderItem : public LogicGateItem {
+public:
+    DecoderItem();
+
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+};
+
+class LCDDisplayItem : public LogicGateItem {
+public:
+    LCDDisplayItem();
+
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) override;
+};
+
+#endif // LOG_COMPONENT_ITEM_H
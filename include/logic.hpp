@@ -0,0 +1,125 @@
+#ifndef LOGIC_HPP
+#define LOGIC_HPP
+
+/*
+ * Logical values of nets. In two-state mode (default) net is 1 if its voltage is at least 2.5 V, otherwise 0.
+ * In four-state mode every driver of net is remembered and net is resolved from all of them:
+ * net without drivers is Z (floating), drivers which don't agree make it X (unknown).
+ * Gates read Z as X and X propagates through them, unless other input decides output (0 on AND input).
+ *
+ * Value takes two bits: bit 0 is logical value and bit 1 says that value is unknown,
+ * so the same encoding is used for bit-planes, where one word holds one bit of many signals.
+*/
+class Logic {
+public:
+    enum Value : unsigned char {
+        ZERO = 0, ONE = 1, X = 2, Z = 3
+    };
+
+    static bool fourState() {
+        return _fourState;
+    }
+
+    /*
+     * Changes mode, it should be done before circuit is built:
+     * drivers are remembered only in four-state mode
+    */
+    static void setFourState(bool fourState) {
+        _fourState = fourState;
+    }
+
+    //Value of net which nobody drives
+    static Value floating() {
+        return _fourState ? Z : ZERO;
+    }
+
+    static Value fromVoltage(double v) {
+        return v >= 2.5 ? ONE : ZERO;
+    }
+
+    //Voltage of driven value, X and Z have 0 V
+    static double voltage(Value value) {
+        return value == ONE ? 5.0 : 0.0;
+    }
+
+    static bool isKnown(Value value) {
+        return value <= ONE;
+    }
+
+    //Value of net with two drivers: Z gives way to any value, different values make X
+    static Value resolve(Value a, Value b) {
+        if (a == Z) return b;
+        if (b == Z || a == b) return a;
+        return X;
+    }
+
+    /*
+     * Gates on bit-planes, T is unsigned integer type (unsigned or wider).
+     * Bit i of 'value' is logical value of signal i and bit i of 'unknown' is set if signal is X or Z.
+     * Output bits are never Z, unknown output has value bit 0
+    */
+    template <class T>
+    static void andPlanes(T va, T ua, T vb, T ub, T& value, T& unknown) {
+        T one = va & ~ua & vb & ~ub;
+        T zero = (~va & ~ua) | (~vb & ~ub);
+        value = one;
+        unknown = ~(one | zero);
+    }
+
+    template <class T>
+    static void orPlanes(T va, T ua, T vb, T ub, T& value, T& unknown) {
+        T one = (va & ~ua) | (vb & ~ub);
+        T zero = ~va & ~ua & ~vb & ~ub;
+        value = one;
+        unknown = ~(one | zero);
+    }
+
+    template <class T>
+    static void xorPlanes(T va, T ua, T vb, T ub, T& value, T& unknown) {
+        unknown = ua | ub;
+        value = (va ^ vb) & ~unknown;
+    }
+
+    template <class T>
+    static void notPlanes(T va, T ua, T& value, T& unknown) {
+        unknown = ua;
+        value = ~(va | ua);
+    }
+
+    static Value andOf(Value a, Value b) {
+        unsigned v, u;
+        andPlanes<unsigned>(a & 1, a >> 1, b & 1, b >> 1, v, u);
+        return join(v, u);
+    }
+
+    static Value orOf(Value a, Value b) {
+        unsigned v, u;
+        orPlanes<unsigned>(a & 1, a >> 1, b & 1, b >> 1, v, u);
+        return join(v, u);
+    }
+
+    static Value xorOf(Value a, Value b) {
+        unsigned v, u;
+        xorPlanes<unsigned>(a & 1, a >> 1, b & 1, b >> 1, v, u);
+        return join(v, u);
+    }
+
+    static Value notOf(Value a) {
+        unsigned v, u;
+        notPlanes<unsigned>(a & 1, a >> 1, v, u);
+        return join(v, u);
+    }
+
+    //'0', '1', 'x' or 'z'
+    static char name(Value value);
+
+private:
+    //Value from lowest bits of planes
+    static Value join(unsigned value, unsigned unknown) {
+        return static_cast<Value>((unknown & 1) << 1 | (value & ~unknown & 1));
+    }
+
+    static bool _fourState;
+};
+
+#endif /* LOGIC_HPP */
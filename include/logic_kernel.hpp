@@ -0,0 +1,58 @@
+#ifndef LOGIC_KERNEL_HPP
+#define LOGIC_KERNEL_HPP
+
+#include "compiled_logic.hpp"
+
+#include <cstdint>
+#include <vector>
+
+/*
+ * Runs compiled program on many patterns at once.
+ * Every slot has 'width' 64-bit words, so one instruction evaluates 64 * width patterns.
+ * Best instruction set is chosen at runtime: AVX2 (4 words per operation),
+ * SSE2 (2 words) or plain 64-bit words.
+*/
+class LogicKernel {
+public:
+    enum Isa {
+        SCALAR, SSE2, AVX2
+    };
+
+    //Best instruction set which this CPU supports
+    static Isa best();
+
+    //Instruction set used by run
+    static Isa active();
+
+    //Chooses instruction set, returns false if CPU doesn't support it
+    static bool setActive(Isa isa);
+
+    static bool supported(Isa isa);
+
+    static const char* name(Isa isa);
+
+    //Number of words which active instruction set processes at once
+    static unsigned lanes();
+
+    /*
+     * Runs program, slot s has words from s * width to s * width + width - 1.
+     * Words of slots which program doesn't drive have to be set before.
+    */
+    static void run(const std::vector<CompiledLogic::Instruction>& program, uint64_t* words, unsigned width) {
+        run(program.data(), program.data() + program.size(), words, width);
+    }
+
+    //Runs instructions from 'begin' to 'end'
+    static void run(const CompiledLogic::Instruction* begin, const CompiledLogic::Instruction* end, uint64_t* words, unsigned width);
+
+    /*
+     * Four-state run on two bit-planes with the same layout as 'words': bit of 'values' is logical value
+     * and bit of 'unknown' is set if signal is X or Z (see Logic). Plain 64-bit words, which compiler can vectorize
+    */
+    static void run(const CompiledLogic::Instruction* begin, const CompiledLogic::Instruction* end, uint64_t* values, uint64_t* unknown, unsigned width);
+
+private:
+    static Isa _active;
+};
+
+#endif /* LOGIC_KERNEL_HPP */
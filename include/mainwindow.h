@@ -2,8 +2,11 @@
 #define MAINWINDOW_H
 
 //#include "components.hpp"
-#include "log_component.hpp"
+#include "analog_solver.hpp"
+#include "log_component_item.h"
+#include "schematic.hpp"
 #include "scene.h" // for itemChange
+#include "waveform_panel.h"
 
 #include <QMainWindow>
 #include <QListWidget>
@@ -14,7 +17,12 @@
 #include <QLabel>
 #include <QPushButton>
 #include <QDialogButtonBox>
-#include <QJsonDocument>
+#include <QComboBox>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QDockWidget>
+
+#include <memory>
 
 class MainWindow : public QMainWindow
 {
@@ -31,12 +39,20 @@ public:
 	}
 	~MainWindow() override;
 
+    // Resistor networks are solved again after resistance, voltage or state of switch changed,
+    // solver updates its factorization instead of building it again
+    void solveAnalog();
+    // Solver is made again for components of scene after they were added, removed or reconnected
+    void rebuildAnalog();
+
 protected:
     void keyPressEvent(QKeyEvent *) override;
 
 private slots:
 	void onOpenFile();
 	void onSaveFile();
+    void onSimulationTimer();
+    void onSpeedChanged(int index);
 
 private:
     QGraphicsView* view;
@@ -50,12 +66,25 @@ private:
     void createListWidget();
     void createSceneAndView();
     void createLayout();
-    template<typename T>
-    void rotateComponent(T* component, int angle){
-        component->rotate(angle);
-    }
+    void createSimulationTimer();
+    void createWaveformPanel();
 
-    void saveFile(QJsonDocument);
+    // One timer advances simulated time of all clocks
+    QTimer* simulationTimer;
+    QElapsedTimer elapsedTimer;
+    QComboBox* speedBox;
+    // Simulated milliseconds per real millisecond, 0 is as fast as possible
+    double simulationRate = 1;
+    // Part of simulated millisecond which is not processed yet
+    double simulationBacklog = 0;
+    // Logic analyzer with levels of selected nets, docked below the scene
+    WaveformPanel* waveformPanel;
+    // Items own their components, circuit only groups loading into one batch edit
+    Circuit batch;
+    // DC voltages of resistor networks, nullptr while scene is empty
+    std::unique_ptr<AnalogSolver> analogSolver;
+    //Writes records to currentFile as JSON
+    void saveFile(const std::vector<ComponentRecord>& records);
 	QString currentFile;
     unsigned counterOfFiles = 0;
 };
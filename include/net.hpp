@@ -0,0 +1,195 @@
+#ifndef NET_HPP
+#define NET_HPP
+
+#include "disjoint_set.hpp"
+#include "logic.hpp"
+#include "timeline.hpp"
+
+#include <cstddef>
+#include <vector>
+
+class Node;
+class Component;
+
+/*
+ * Nets are groups of nodes joined by wires and closed switches.
+ * All nodes in the same net have the same voltage, which is stored once per net,
+ * so there is no need to copy voltage from node to node through every wire.
+ *
+ * Nets are merged with union-find when wire or switch joins two nodes.
+ * When wire is removed or switch is opened, only nets of affected nodes are rebuilt.
+ *
+ * State of nets is kept in separate arrays indexed by net id (voltage, logic level, driver,
+ * time of last change), so scheduler, compiled logic and views read contiguous memory
+ * instead of going from node to node. Nodes keep only id of their net.
+ *
+ * In four-state mode logic level of net is resolved from values which components drive
+ * on its pins (see Logic), voltage follows level.
+*/
+class NetList {
+public:
+    //Makes new net which contains only given node, returns net id
+    static int create(Node* node);
+
+    //Removes node from its net, net without nodes is deleted
+    static void remove(Node* node);
+
+    //Returns id of net (representative of union-find set)
+    static int find(int net) {
+        return _sets.find(net);
+    }
+
+    //Joins nets of two nodes, returns id of joined net
+    static int merge(Node* a, Node* b);
+
+    /*
+     * Rebuilds net after some wire or switch stopped joining its nodes.
+     * New nets have voltage 0 and they are scheduled for evaluation,
+     * so components which drive them can set voltage again
+    */
+    static void split(int net);
+
+    static double voltage(int net) {
+        return _voltage[find(net)];
+    }
+
+    /*
+     * Sets voltage and logic level of net, 'driver' is component which drives it (nullptr if it is set from outside).
+     * Level is taken from voltage also in four-state mode, until net is resolved again
+    */
+    static void setVoltage(int net, double v, const Component* driver = nullptr) {
+        net = find(net);
+        if (_voltage[net] != v) _changed[net] = Timeline::now();
+        _voltage[net] = v;
+        unsigned char level = Logic::fromVoltage(v);
+        if (_watching && _level[net] != level) markLevelChanged(net);
+        _level[net] = level;
+        _driver[net] = driver;
+    }
+
+    /*
+     * Four-state mode: sets level of net to resolution of values driven on all its pins.
+     * Voltage is kept if it has the same logical value, otherwise it is set to voltage of level.
+     * Returns true if level or voltage changed
+    */
+    static bool resolve(int net, const Component* driver = nullptr);
+
+    //Logic level of net: in two-state mode 1 if voltage is at least half of 5 V
+    static Logic::Value level(int net) {
+        return static_cast<Logic::Value>(_level[find(net)]);
+    }
+
+    //Component which set voltage of net last, nullptr if voltage was set from outside
+    static const Component* driver(int net) {
+        return _driver[find(net)];
+    }
+
+    //Simulated time of last change of voltage
+    static long long changed(int net) {
+        return _changed[find(net)];
+    }
+
+    //Component stops being driver of all nets, called when it is destroyed
+    static void forget(const Component* driver, int net) {
+        net = find(net);
+        if (_driver[net] == driver) _driver[net] = nullptr;
+    }
+
+    //All nodes in net
+    static const std::vector<Node*>& nodes(int net) {
+        return _nodes[find(net)];
+    }
+
+    //Pin of component connected to net, 'pin' is index in Component::nodes()
+    struct Pin {
+        Component* component;
+        unsigned pin;
+    };
+
+    /*
+     * Flat index of pins of all nets (nets in order of id, pins of net next to each other),
+     * so scheduler expands net by walking one array instead of its nodes and their components.
+     * Index is valid until nets or connections change, it has to be built again after that
+    */
+    static bool hasPinIndex() {
+        return _pinVersion == _version;
+    }
+
+    static void buildPinIndex();
+
+    //Pins of net, index has to be valid
+    static const Pin* pinsBegin(int net) {
+        return _pins.data() + _pinStart[find(net)];
+    }
+
+    static const Pin* pinsEnd(int net) {
+        return _pins.data() + _pinStart[find(net) + 1];
+    }
+
+    //Number of nets
+    static size_t size() {
+        return _size;
+    }
+
+    //Changes every time nets or connections of nodes change, compiled logic uses it to rebuild itself
+    static unsigned long version() {
+        return _version;
+    }
+
+    //Marks that connections changed without changing nets
+    static void touch() {
+        ++_version;
+    }
+
+    /*
+     * While levels are watched, every net whose logic level changes is remembered once (see ChangeFeed).
+     * Nets which are made, joined or split change version() instead
+    */
+    static void watchLevels(bool watch) {
+        _watching = watch;
+    }
+
+    //Moves nets whose level changed since previous call to 'nets'
+    static void takeChangedLevels(std::vector<int>& nets);
+
+private:
+    //Returns id of unused net
+    static int allocate();
+
+    static void markLevelChanged(int net) {
+        if (_levelChanged[net]) return;
+        _levelChanged[net] = true;
+        _changedLevels.push_back(net);
+    }
+
+    //Deletes net without nodes so id can be reused
+    static void release(int net);
+
+    friend class Scheduler;
+    //state of nets, indexed by net id
+    static std::vector<double> _voltage;
+    static std::vector<unsigned char> _level;
+    static std::vector<const Component*> _driver;
+    static std::vector<long long> _changed;
+    static std::vector<std::vector<Node*>> _nodes;
+
+    //net waits in scheduler queue, 'source' is component which changed it
+    static std::vector<unsigned char> _dirty;
+    static std::vector<const Component*> _dirtySource;
+
+    //nets whose level changed while levels are watched
+    static bool _watching;
+    static std::vector<unsigned char> _levelChanged;
+    static std::vector<int> _changedLevels;
+
+    //pin index: pins of net 'id' are from _pins[_pinStart[id]] to _pins[_pinStart[id + 1]]
+    static std::vector<unsigned> _pinStart;
+    static std::vector<Pin> _pins;
+    static unsigned long _pinVersion;
+    static DisjointSet _sets;
+    static std::vector<int> _free;
+    static size_t _size;
+    static unsigned long _version;
+};
+
+#endif /* NET_HPP */
@@ -0,0 +1,92 @@
+#ifndef NODE_REGISTRY_HPP
+#define NODE_REGISTRY_HPP
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <utility>
+
+class Node;
+
+/*
+ * Set of all different nodes, keyed by coordinates.
+ * Coordinates are packed into one 64-bit key and stored in open addressing
+ * hash table (linear probing), so lookup by (x, y) doesn't allocate.
+ * Interface follows std::set which was used before: insert/find/erase/end.
+*/
+class NodeRegistry {
+public:
+    //Iterates over occupied slots of the table
+    class iterator {
+    public:
+        iterator(std::shared_ptr<Node>* slot = nullptr, std::shared_ptr<Node>* last = nullptr)
+            :_slot(slot), _last(last)
+        {}
+
+        std::shared_ptr<Node>& operator*() const { return *_slot; }
+        std::shared_ptr<Node>* operator->() const { return _slot; }
+
+        iterator& operator++() {
+            do {
+                ++_slot;
+            } while (_slot != _last && *_slot == nullptr);
+            return *this;
+        }
+
+        bool operator==(const iterator& other) const { return _slot == other._slot; }
+        bool operator!=(const iterator& other) const { return _slot != other._slot; }
+
+    private:
+        std::shared_ptr<Node>* _slot;
+        std::shared_ptr<Node>* _last;
+    };
+
+    NodeRegistry();
+
+    //Packs coordinates into one key: x in high 32 bits, y in low 32 bits
+    static uint64_t key(int x, int y) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+    }
+
+    /*
+     * Inserts node if there is no node with the same coordinates.
+     * Returns iterator to node with those coordinates and true if node is inserted.
+     * NOTE: iterators are invalidated by insert
+    */
+    std::pair<iterator, bool> insert(const std::shared_ptr<Node>& node);
+
+    //Finds node by coordinates, returns end() if there is no such node
+    iterator find(int x, int y);
+
+    //Removes node with the same coordinates as given node, returns number of removed nodes
+    size_t erase(const std::shared_ptr<Node>& node);
+
+    //Removes all nodes
+    void clear();
+
+    //Grows table for 'count' nodes at once, instead of doubling it many times while they are inserted
+    void reserve(size_t count);
+
+    iterator begin();
+    iterator end();
+
+    size_t size() const { return _size; }
+    bool empty() const { return _size == 0; }
+
+private:
+    //Position of key in table if it is present, or first empty slot where it belongs
+    size_t probe(uint64_t key) const;
+
+    //Inserts all nodes again in table with new capacity (power of two)
+    void rehash(size_t capacity);
+
+    static size_t hash(uint64_t key);
+
+    std::vector<uint64_t> _keys;
+    std::vector<std::shared_ptr<Node>> _slots;
+    size_t _mask;
+    size_t _size;
+};
+
+#endif /* NODE_REGISTRY_HPP */
@@ -0,0 +1,81 @@
+#ifndef PATTERN_SIMULATOR_HPP
+#define PATTERN_SIMULATOR_HPP
+
+#include "compiled_logic.hpp"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class Switch;
+
+/*
+ * Simulates 64 * width input patterns at once, e.g. for truth tables.
+ * Chosen switches are inputs: bit i of their word j says if switch is closed in pattern 64 * j + i.
+ * Every net holds 'width' 64-bit words and every compiled gate evaluates all patterns with one
+ * instruction, which LogicKernel runs with AVX2 or SSE2 if CPU has them.
+ *
+ * One side of input switch has to be source which program doesn't drive (e.g. DC voltage),
+ * other side is input of gates. Nets which are not driven by program or switches keep
+ * their current logical value in all patterns (e.g. outputs of flip-flops).
+ * Input switches are opened while simulator exists and their old state is restored after.
+*/
+class PatternSimulator {
+public:
+    //Throws std::runtime_error if there are feedback loops or some switch can't be input
+    PatternSimulator(const std::vector<Component*>& components, const std::vector<Switch*>& inputs, unsigned width = 1);
+
+    ~PatternSimulator();
+
+    PatternSimulator(const PatternSimulator&) = delete;
+    PatternSimulator& operator=(const PatternSimulator&) = delete;
+
+    //Number of 64-bit words per net
+    unsigned width() const {
+        return _width;
+    }
+
+    //Sets word 'index' of input switch 'input': bit i is 1 if switch is closed in pattern 64 * index + i
+    void setPattern(unsigned input, uint64_t word, unsigned index = 0);
+
+    /*
+     * Sets patterns to combinations from block * 64 * width on:
+     * input k in pattern p is bit k of combination number block * 64 * width + p
+    */
+    void setCombinations(uint64_t block);
+
+    //Number of blocks with all combinations of inputs
+    uint64_t combinationBlocks() const;
+
+    //Evaluates all 64 * width patterns
+    void run();
+
+    //Word 'index' of net which contains node (x, y), bit i is its logical value in pattern 64 * index + i. Throws if there is no node
+    uint64_t output(int x, int y, unsigned index = 0);
+
+    CompiledLogic& logic() {
+        return _logic;
+    }
+
+private:
+    //Finds source and load net of every switch for current nets
+    void prepare();
+
+    CompiledLogic _logic;
+    unsigned _width;
+    std::vector<Switch*> _switches;
+    std::vector<bool> _wasClosed;
+    //'width' words for every switch
+    std::vector<uint64_t> _patterns;
+
+    //for every switch: net which switch drives and value of its source
+    std::vector<int> _loads;
+    std::vector<uint64_t> _sources;
+
+    std::vector<uint64_t> _words;
+    //words of nets driven by switches which program doesn't read
+    std::unordered_map<int, std::vector<uint64_t>> _loadWords;
+    unsigned long _version = 0;
+};
+
+#endif /* PATTERN_SIMULATOR_HPP */
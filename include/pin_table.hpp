@@ -0,0 +1,110 @@
+#ifndef PIN_TABLE_HPP
+#define PIN_TABLE_HPP
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+class Node;
+
+/*
+ * Nodes of component's pins. Up to INLINE pins are stored inside the component itself,
+ * so wires, resistors and gates don't allocate anything for their pins.
+ * Components with more pins (flip-flops, decoder) reserve their exact count once in constructor.
+ * Pins are kept in order of connection, the same way as in vector.
+*/
+class PinTable {
+public:
+    static const size_t INLINE = 3;
+
+    typedef std::shared_ptr<Node> value_type;
+    typedef value_type* iterator;
+    typedef const value_type* const_iterator;
+
+    PinTable() {}
+
+    PinTable(const PinTable&) = delete;
+    PinTable& operator=(const PinTable&) = delete;
+
+    iterator begin() {
+        return data();
+    }
+
+    iterator end() {
+        return data() + _size;
+    }
+
+    const_iterator begin() const {
+        return data();
+    }
+
+    const_iterator end() const {
+        return data() + _size;
+    }
+
+    size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+    value_type& operator[](size_t i) {
+        return data()[i];
+    }
+
+    const value_type& operator[](size_t i) const {
+        return data()[i];
+    }
+
+    value_type& back() {
+        return data()[_size - 1];
+    }
+
+    const value_type& back() const {
+        return data()[_size - 1];
+    }
+
+    //Makes place for 'capacity' pins, pins are moved to heap if they don't fit inline
+    void reserve(size_t capacity) {
+        if (capacity <= _capacity) return;
+
+        std::unique_ptr<value_type[]> heap(new value_type[capacity]);
+        for (size_t i = 0; i < _size; ++i) heap[i] = std::move(data()[i]);
+        _heap = std::move(heap);
+        _capacity = capacity;
+    }
+
+    void push_back(value_type node) {
+        if (_size == _capacity) reserve(2 * _capacity);
+        data()[_size++] = std::move(node);
+    }
+
+    //Removes pin, following pins are moved one place forward
+    iterator erase(iterator it) {
+        for (iterator next = it + 1; next != end(); ++next) *(next - 1) = std::move(*next);
+        data()[--_size].reset();
+        return it;
+    }
+
+    void clear() {
+        while (_size > 0) data()[--_size].reset();
+    }
+
+private:
+    value_type* data() {
+        return _heap ? _heap.get() : _inline;
+    }
+
+    const value_type* data() const {
+        return _heap ? _heap.get() : _inline;
+    }
+
+    value_type _inline[INLINE];
+    std::unique_ptr<value_type[]> _heap;
+    size_t _size = 0;
+    size_t _capacity = INLINE;
+};
+
+#endif /* PIN_TABLE_HPP */
@@ -0,0 +1,91 @@
+#ifndef SCHEDULER_HPP
+#define SCHEDULER_HPP
+
+#include <memory>
+#include <vector>
+
+class Node;
+class Component;
+class CompiledLogic;
+
+/*
+ * Propagates voltage changes through circuit.
+ * Instead of components calling each other recursively, changed nets are put
+ * in work queue and evaluated breadth-first, pass by pass:
+ * in every pass each dirty net is expanded once and each component connected
+ * to dirty nets is evaluated once. Evaluation of component can make new nets
+ * dirty, they are handled in the next pass.
+*/
+class Scheduler {
+public:
+    //Marks net of node as dirty: components connected to it, except 'source', need to calculate their voltage
+    static void schedule(const std::shared_ptr<Node>& node, const Component* source = nullptr);
+
+    //Marks net as dirty
+    static void scheduleNet(int net, const Component* source = nullptr);
+
+    /*
+     * Evaluates components until there are no dirty nets.
+     * If it is called while scheduler is already running (from evaluation of some component),
+     * it does nothing, the outermost call will process new dirty nets. It also does nothing while scheduler is held.
+    */
+    static void run();
+
+    /*
+     * Postpones runs until matching release, so changes made together (e.g. clock edges at the same moment)
+     * are propagated in one run. Calls can be nested.
+    */
+    static void hold();
+
+    //Ends hold, runs scheduler when last hold is released
+    static void release();
+
+    static bool isRunning() {
+        return _running;
+    }
+
+    static bool isHeld() {
+        return _holds > 0;
+    }
+
+    //True if last run stopped because some component reached iteration limit (oscillating loop)
+    static bool oscillating() {
+        return _oscillating;
+    }
+
+    //Maximum number of evaluations of one component in one run
+    static unsigned iterationLimit() {
+        return _iterationLimit;
+    }
+
+    static void setIterationLimit(unsigned limit);
+
+    //Number of evaluations in last run
+    static size_t evaluations() {
+        return _evaluations;
+    }
+
+private:
+    //Evaluates one component if it didn't reach iteration limit
+    static void evaluate(Component* c);
+
+    //Evaluates compiled block with the same iteration limit as components
+    static void evaluate(CompiledLogic* block);
+
+    //Queues component connected to dirty net, pins of 'source' are only counted
+    static void enqueue(Component* c, Component* source, unsigned& sourcePins);
+
+    static std::vector<int> _dirtyNets;
+    static std::vector<Component*> _queue;
+    static std::vector<CompiledLogic*> _blocks;
+    static bool _running;
+    static unsigned _holds;
+    static bool _oscillating;
+    static unsigned _iterationLimit;
+    static unsigned _run;
+    static size_t _evaluations;
+    //version of nets at the end of last run
+    static unsigned long _version;
+};
+
+#endif /* SCHEDULER_HPP */
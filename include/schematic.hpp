@@ -0,0 +1,81 @@
+#ifndef SCHEMATIC_HPP
+#define SCHEMATIC_HPP
+
+#include "circuit.hpp"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+class SchematicFile;
+struct ComponentType;
+
+/*
+ * One component from schematic file: [x, y, angle, parameter].
+ * Parameter depends on type: wire length, switch is opened, voltage, resistance
+ * or clock time interval. Other types don't have it.
+*/
+struct ComponentRecord {
+    std::string type;
+    int x = 0;
+    int y = 0;
+    int angle = 0;
+    double parameter = 0;
+    bool hasParameter = false;
+};
+
+/*
+ * Reads schematic files saved by GUI: { type : [ [x, y, angle, parameter], ... ] }
+ * and builds core components from them, so files can be loaded with or without GUI.
+*/
+class Schematic {
+public:
+    //Makes new component of registered type for record and keeps it (in circuit, in graphics item)
+    typedef std::function<Component*(const ComponentType& type, const ComponentRecord& record)> Creator;
+
+    //All types in order in which they are loaded
+    static const std::vector<std::string>& types();
+
+    //Parses JSON text, records are ordered by types(). Throws std::runtime_error if text is not valid
+    static std::vector<ComponentRecord> parse(const std::string& json);
+
+    //Parses text in one pass, records are read straight from text without JSON document
+    static std::vector<ComponentRecord> parse(const char* begin, const char* end);
+
+    //Reads and parses JSON or binary file. Throws std::runtime_error if file can't be read or parsed
+    static std::vector<ComponentRecord> readFile(const std::string& path);
+
+    //JSON text in the same form as GUI saves, numbers are written without loss of precision
+    static std::string toJson(const std::vector<ComponentRecord>& records);
+
+    //Writes records as JSON. Throws std::runtime_error if file can't be written
+    static void writeFile(const std::vector<ComponentRecord>& records, const std::string& path);
+
+    //Makes new component of record type, nullptr if type is unknown
+    static Component* create(const ComponentRecord& record);
+
+    //Moves and rotates component, sets its parameter and then connects it to final connection points
+    static void place(Component* component, const ComponentRecord& record);
+
+    //Record of placed component, as it is saved to file
+    static ComponentRecord record(const Component& component);
+
+    /*
+     * Creates and places all components in circuit, circuit owns them. Throws std::runtime_error for unknown type.
+     * Voltages are propagated once, after all components are connected
+    */
+    static void load(const std::vector<ComponentRecord>& records, Circuit& circuit);
+
+    //Loads components straight from mapped binary file, without copying all records
+    static void load(const SchematicFile& file, Circuit& circuit);
+
+    /*
+     * Same loading with components made by 'create' instead of circuit, which is used only for batch edit
+     * (GUI makes items which own their components). Components made before error stay placed and
+     * voltages are propagated also when it throws
+    */
+    static void load(const std::vector<ComponentRecord>& records, Circuit& circuit, const Creator& create);
+    static void load(const SchematicFile& file, Circuit& circuit, const Creator& create);
+};
+
+#endif /* SCHEMATIC_HPP */
@@ -0,0 +1,94 @@
+#ifndef SCHEMATIC_FILE_HPP
+#define SCHEMATIC_FILE_HPP
+
+#include "schematic.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ * Binary schematic (.psch), same records as JSON files in compact form which is
+ * memory-mapped and read in place, without parsing text.
+ *
+ * Layout, all numbers little-endian:
+ *  - header: "PSCH", version, number of types, number of components
+ *  - type table: name of every type, 16 bytes padded with zeros
+ *  - component table: Entry for every component, in the order in which they are loaded
+ *  - parameters: double for every component, valid if entry has HAS_PARAMETER flag
+ *
+ * Types are stored by name, so file stays valid when types are added or reordered.
+*/
+class SchematicFile {
+public:
+    static const uint32_t VERSION = 1;
+
+    struct Entry {
+        uint16_t type;
+        uint16_t flags;
+        int32_t x;
+        int32_t y;
+        int32_t angle;
+    };
+
+    enum Flags : uint16_t {
+        HAS_PARAMETER = 1
+    };
+
+    //Maps file. Throws std::runtime_error if file can't be read or isn't valid binary schematic
+    explicit SchematicFile(const std::string& path);
+    ~SchematicFile();
+
+    SchematicFile(const SchematicFile&) = delete;
+    SchematicFile& operator=(const SchematicFile&) = delete;
+
+    //Checks magic number at the beginning of file
+    static bool isBinary(const std::string& path);
+
+    //Writes records to binary file. Throws std::runtime_error if file can't be written
+    static void write(const std::vector<ComponentRecord>& records, const std::string& path);
+
+    size_t size() const {
+        return _count;
+    }
+
+    //Entries are in mapped file
+    const Entry* entries() const {
+        return _entries;
+    }
+
+    const std::string& type(size_t i) const {
+        return _types[_entries[i].type];
+    }
+
+    //Registered type of component, nullptr if its type is unknown; type table is resolved once when file is opened
+    const ComponentType* componentType(size_t i) const {
+        return _registered[_entries[i].type];
+    }
+
+    double parameter(size_t i) const {
+        return _parameters[i];
+    }
+
+    //Copy of one component as record
+    ComponentRecord record(size_t i) const;
+
+    //Copies of all components
+    std::vector<ComponentRecord> records() const;
+
+private:
+    const char* _data = nullptr;
+    size_t _length = 0;
+    //memory of file read without mmap
+    std::vector<char> _buffer;
+    bool _mapped = false;
+
+    std::vector<std::string> _types;
+    std::vector<const ComponentType*> _registered;
+    const Entry* _entries = nullptr;
+    const double* _parameters = nullptr;
+    size_t _count = 0;
+};
+
+#endif /* SCHEMATIC_FILE_HPP */
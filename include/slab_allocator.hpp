@@ -0,0 +1,65 @@
+#ifndef SLAB_ALLOCATOR_HPP
+#define SLAB_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <new>
+
+/*
+ * Small objects of circuit (nodes with their control blocks, components) are allocated
+ * from slabs: big blocks of memory split into pieces of the same size.
+ * Freed piece goes to free list of its size and the next object of that size reuses it,
+ * so loading big circuit takes one allocation per slab instead of one per object,
+ * and deleting circuit only links its pieces back to free lists.
+ *
+ * Sizes are rounded up to ALIGNMENT, objects bigger than MAX_SIZE use operator new.
+ * Slabs are kept until program ends, the next circuit uses them again.
+ * Not thread-safe: circuits are built and destroyed on one thread.
+*/
+class SlabAllocator {
+public:
+    static const size_t ALIGNMENT = 16;
+    static const size_t MAX_SIZE = 512;
+    static const size_t SLAB_SIZE = 64 * 1024;
+
+    static void* allocate(size_t size);
+
+    //Size has to be the same as in allocate
+    static void deallocate(void* p, size_t size);
+
+    //Number of slabs taken from system
+    static size_t slabs();
+
+    //Number of pieces which are in use
+    static size_t used();
+};
+
+//Allocator for standard containers and std::allocate_shared
+template <class T>
+struct SlabAllocation {
+    typedef T value_type;
+
+    SlabAllocation() {}
+
+    template <class U>
+    SlabAllocation(const SlabAllocation<U>&) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(SlabAllocator::allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n) {
+        SlabAllocator::deallocate(p, n * sizeof(T));
+    }
+};
+
+template <class T, class U>
+bool operator==(const SlabAllocation<T>&, const SlabAllocation<U>&) {
+    return true;
+}
+
+template <class T, class U>
+bool operator!=(const SlabAllocation<T>&, const SlabAllocation<U>&) {
+    return false;
+}
+
+#endif /* SLAB_ALLOCATOR_HPP */
@@ -0,0 +1,57 @@
+#ifndef SPARSE_LU_HPP
+#define SPARSE_LU_HPP
+
+#include <cstddef>
+#include <vector>
+
+/*
+ * Sparse LU factorization of symmetric matrix, A = L * D * L^T (U is D * L^T).
+ * Nodal matrices of resistor networks are symmetric and diagonally dominant,
+ * so factorization needs no pivoting and only lower triangle is stored.
+ *
+ * Work is split like in other sparse solvers:
+ *  - analyze: fill-reducing ordering (nested dissection) and structure of L, only pattern is used
+ *  - factorize: numeric values, can be repeated for new values with the same pattern
+ *  - solve: forward and back substitution
+*/
+class SparseLU {
+public:
+    /*
+     * Matrix in compressed columns: rows of column j are rows[columns[j]] .. rows[columns[j+1] - 1].
+     * Pattern has to be symmetric and contain diagonal
+    */
+    void analyze(size_t n, const std::vector<size_t>& columns, const std::vector<unsigned>& rows);
+
+    //Calculates L and D for values in the same order as rows given to analyze, returns false if matrix is singular
+    bool factorize(const std::vector<double>& values);
+
+    //Solves A * x = b, b is replaced with x
+    void solve(std::vector<double>& b) const;
+
+    size_t size() const {
+        return _n;
+    }
+
+    //Number of non-zero values below diagonal of L
+    size_t factorSize() const {
+        return _lRows.size();
+    }
+
+private:
+    size_t _n = 0;
+    std::vector<size_t> _columns;
+    std::vector<unsigned> _rows;
+
+    //elimination order: _order[k] is original index of k-th pivot, _position is inverse
+    std::vector<unsigned> _order, _position;
+    //elimination tree of permuted matrix, -1 for roots
+    std::vector<int> _parent;
+
+    //L in compressed columns, without diagonal
+    std::vector<size_t> _lColumns;
+    std::vector<unsigned> _lRows;
+    std::vector<double> _lValues;
+    std::vector<double> _diagonal;
+};
+
+#endif /* SPARSE_LU_HPP */
@@ -0,0 +1,28 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <cstddef>
+#include <functional>
+
+/*
+ * Work-stealing pool shared by whole simulation.
+ * Every thread has its own queue of tasks, thread which finishes its queue takes tasks
+ * from the end of other queues. Thread which calls run works too.
+ * By default there is only one thread and tasks run one after another on caller thread.
+*/
+class ThreadPool {
+public:
+    //Number of threads including caller, 0 is number of CPU cores. Must not be called from task
+    static void setThreads(unsigned threads);
+
+    static unsigned threads();
+
+    /*
+     * Calls task(i) for every i from 0 to count - 1 and returns after all of them finish.
+     * Tasks have to be independent. Run called from task runs its tasks on the same thread.
+     * First exception thrown by task is rethrown after all tasks finish.
+    */
+    static void run(size_t count, const std::function<void(size_t)>& task);
+};
+
+#endif /* THREAD_POOL_HPP */
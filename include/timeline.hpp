@@ -0,0 +1,87 @@
+#ifndef TIMELINE_HPP
+#define TIMELINE_HPP
+
+#include <cstddef>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+class Clock;
+
+/*
+ * Simulated time, in milliseconds, shared by all clocks.
+ * Clock edges are kept in one min-heap of events instead of every clock having its own timer.
+ * Timeline doesn't wait for anything: owner decides how fast simulated time goes
+ * (GUI advances it from one timer by elapsed real time times rate, protosim as fast as possible).
+ * All edges at the same moment are ticked together and propagated in one scheduler run.
+ *
+ * Delayed changes of outputs (see Delays) are events too: they are applied at their moment
+ * together with clock edges at the same moment.
+ *
+ * Changes of levels of every moment are published to ChangeFeed.
+*/
+class Timeline {
+public:
+    //Current simulated time
+    static long long now() {
+        return _now;
+    }
+
+    //Time of next event (clock edge or delayed change), -1 if there is none
+    static long long nextEventTime();
+
+    //Time of next clock edge, -1 if there are no running clocks
+    static long long nextEdgeTime();
+
+    /*
+     * Moves to next event, applies delayed changes and ticks all clocks with edge at that moment.
+     * Returns false if there is no event
+    */
+    static bool step();
+
+    //Processes all events until 'time' (including it) and moves to 'time'. Returns number of processed moments
+    static size_t advanceTo(long long time);
+
+    //Starts time from 0, all clocks get their first edge after one time interval and delayed changes are dropped
+    static void reset();
+
+    //Number of registered clocks
+    static size_t clocks() {
+        return _clocks.size();
+    }
+
+private:
+    friend class Clock;
+
+    //Registers clock or changes its next edge to one time interval from now
+    static void schedule(Clock* clock);
+
+    //Unregisters clock, its events are ignored
+    static void remove(Clock* clock);
+
+    //Adds event for clock at 'time', clocks without positive time interval don't get events
+    static void push(Clock* clock, long long time);
+
+    //Removes events which belong to removed or rescheduled clocks from top of heap
+    static void discardStale();
+
+    struct Event {
+        long long time;
+        //increasing number, order of clocks at the same moment doesn't depend on addresses
+        unsigned long long id;
+        Clock* clock;
+
+        bool operator>(const Event& other) const {
+            return time > other.time || (time == other.time && id > other.id);
+        }
+    };
+
+    static long long _now;
+    static unsigned long long _nextId;
+    static std::priority_queue<Event, std::vector<Event>, std::greater<Event>> _events;
+    //id of valid event for every registered clock, 0 if clock doesn't have event
+    static std::unordered_map<Clock*, unsigned long long> _clocks;
+};
+
+#endif /* TIMELINE_HPP */
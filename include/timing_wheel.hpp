@@ -0,0 +1,187 @@
+#ifndef TIMING_WHEEL_HPP
+#define TIMING_WHEEL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+ * Queue of events ordered by time, T has to have member 'long long time'.
+ * Hierarchical timing wheel: LEVELS wheels of SLOTS slots, slot of level l covers SLOTS^l moments.
+ * Event goes to the lowest level where its time differs from current time only in bits of that level,
+ * so insert is constant time. When time reaches slot of higher level, its events are moved down
+ * (every event at most once per level), events beyond the last level wait in overflow list.
+ * Used slots are marked in bitmaps, so next used slot is found without walking empty ones.
+ *
+ * Events at the same moment come out in order of insertion.
+*/
+template <class T>
+class TimingWheel {
+public:
+    static const unsigned BITS = 8;
+    static const unsigned SLOTS = 1u << BITS;
+    static const unsigned LEVELS = 4;
+
+    explicit TimingWheel(long long now = 0)
+        :_now(now)
+    {}
+
+    size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+    //Time of the last taken events, new events can't be earlier
+    long long now() const {
+        return _now;
+    }
+
+    //Adds event, its time has to be at least now()
+    void insert(const T& event) {
+        place(event);
+        ++_size;
+        if (_next >= 0 && event.time < _next) _next = event.time;
+    }
+
+    //Time of the earliest event, -1 if wheel is empty
+    long long nextTime() {
+        if (_size == 0) return -1;
+        if (_next >= 0) return _next;
+
+        //Earliest event is in the first used slot of the lowest level which has any
+        for (unsigned level = 0; level < LEVELS; ++level) {
+            unsigned current = index(_now, level);
+            int slot = findUsed(level, level == 0 ? current : current + 1);
+            if (slot < 0) continue;
+
+            if (level == 0) {
+                _next = (_now & ~static_cast<long long>(SLOTS - 1)) | slot;
+            } else {
+                _next = earliest(_slots[level][slot]);
+            }
+            return _next;
+        }
+        _next = earliest(_overflow);
+        return _next;
+    }
+
+    //Moves all events at nextTime() to the end of 'out' and makes that time now()
+    void takeNext(std::vector<T>& out) {
+        long long time = nextTime();
+        if (time < 0) return;
+
+        advance(time);
+        std::vector<T>& slot = _slots[0][index(time, 0)];
+        out.insert(out.end(), slot.begin(), slot.end());
+        _size -= slot.size();
+        slot.clear();
+        markUsed(0, index(time, 0), false);
+        _next = -1;
+    }
+
+    //Removes all events and starts from time 'now'
+    void clear(long long now = 0) {
+        for (unsigned level = 0; level < LEVELS; ++level) {
+            for (unsigned slot = 0; slot < SLOTS; ++slot) _slots[level][slot].clear();
+            for (unsigned word = 0; word < SLOTS / 64; ++word) _used[level][word] = 0;
+        }
+        _overflow.clear();
+        _size = 0;
+        _now = now;
+        _next = -1;
+    }
+
+private:
+    static unsigned index(long long time, unsigned level) {
+        return static_cast<unsigned>(time >> (BITS * level)) & (SLOTS - 1);
+    }
+
+    static long long earliest(const std::vector<T>& events) {
+        long long time = events.front().time;
+        for (const T& e : events) time = std::min(time, e.time);
+        return time;
+    }
+
+    //Puts event on level where its time differs from now, without counting it
+    void place(const T& event) {
+        unsigned long long diff = static_cast<unsigned long long>(event.time ^ _now);
+        for (unsigned level = 0; level < LEVELS; ++level) {
+            if ((diff >> (BITS * (level + 1))) == 0) {
+                unsigned slot = index(event.time, level);
+                _slots[level][slot].push_back(event);
+                markUsed(level, slot, true);
+                return;
+            }
+        }
+        _overflow.push_back(event);
+    }
+
+    /*
+     * Moves current time to 'time', which is time of the earliest event.
+     * Slot which contains it is moved to lower levels until it is on level 0
+    */
+    void advance(long long time) {
+        while (true) {
+            unsigned long long diff = static_cast<unsigned long long>(time ^ _now);
+            if ((diff >> BITS) == 0) break;
+
+            unsigned level = 1;
+            while (level < LEVELS && (diff >> (BITS * (level + 1))) != 0) ++level;
+
+            //Nothing is earlier, so time can jump to the start of range of the slot (or of overflow)
+            _now = time & ~((static_cast<long long>(1) << (BITS * level)) - 1);
+            if (level == LEVELS) {
+                cascade(_overflow);
+            } else {
+                unsigned slot = index(time, level);
+                markUsed(level, slot, false);
+                cascade(_slots[level][slot]);
+            }
+        }
+        _now = time;
+    }
+
+    //Places events again relative to current time
+    void cascade(std::vector<T>& events) {
+        std::vector<T> moved;
+        moved.swap(events);
+        for (const T& e : moved) place(e);
+    }
+
+    void markUsed(unsigned level, unsigned slot, bool used) {
+        uint64_t bit = uint64_t(1) << (slot % 64);
+        if (used) _used[level][slot / 64] |= bit;
+        else _used[level][slot / 64] &= ~bit;
+    }
+
+    //First used slot of level from 'from' to the end of wheel, -1 if there is none
+    int findUsed(unsigned level, unsigned from) const {
+        for (unsigned word = from / 64; word < SLOTS / 64; ++word) {
+            uint64_t bits = _used[level][word];
+            if (word == from / 64) bits &= ~uint64_t(0) << (from % 64);
+            if (bits == 0) continue;
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<int>(word * 64 + __builtin_ctzll(bits));
+#else
+            unsigned bit = 0;
+            while (!(bits >> bit & 1)) ++bit;
+            return static_cast<int>(word * 64 + bit);
+#endif
+        }
+        return -1;
+    }
+
+    std::vector<T> _slots[LEVELS][SLOTS];
+    uint64_t _used[LEVELS][SLOTS / 64] = {};
+    std::vector<T> _overflow;
+    size_t _size = 0;
+    long long _now;
+    //cached result of nextTime, -1 if it has to be found again
+    long long _next = -1;
+};
+
+#endif /* TIMING_WHEEL_HPP */
@@ -0,0 +1,132 @@
+#ifndef TRACE_BUFFER_HPP
+#define TRACE_BUFFER_HPP
+
+#include "change_feed.hpp"
+#include "logic.hpp"
+#include "vcd_writer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ * In-memory trace of logic levels which works like logic analyzer.
+ * Probes are divided in groups, every group keeps only last 'depth' changes in its ring buffer,
+ * so long simulation can be traced without writing everything to disk.
+ *
+ * Trigger is condition on one probe. When it is met, recording continues for 'after' milliseconds
+ * of simulated time and then buffer freezes, so it holds window around the event which can be
+ * written as VCD file. Without trigger buffer holds last changes when simulation ends.
+ *
+ * Like VcdWriter, changes come from ChangeFeed.
+*/
+class TraceBuffer : private ChangeFeed::Subscriber {
+public:
+    enum class Condition : unsigned char {
+        //probe has given level
+        EQUALS,
+        //probe changes to given level (rising edge is change to ONE)
+        BECOMES,
+        //probe changes to any other level
+        TOGGLES
+    };
+
+    //Change of probe, probe is index in order in which probes were added
+    struct Record {
+        long long time;
+        uint32_t probe;
+        Logic::Value value;
+    };
+
+    /*
+     * Adds group of probes with ring buffer of 'depth' changes, returns index of its first probe.
+     * Throws std::invalid_argument if depth is 0 or recording already started
+    */
+    size_t addGroup(const std::vector<VcdWriter::Probe>& probes, size_t depth);
+
+    /*
+     * Arms trigger on probe 'probe' ('value' is ignored by TOGGLES), recording stops 'after'
+     * milliseconds after it. Throws std::invalid_argument if there is no such probe or 'after' is negative
+    */
+    void setTrigger(size_t probe, Condition condition, Logic::Value value = Logic::ONE, long long after = 0);
+
+    bool triggered() const {
+        return _triggerTime >= 0;
+    }
+
+    //Time when trigger was met, -1 if it wasn't
+    long long triggerTime() const {
+        return _triggerTime;
+    }
+
+    //True if trigger was met and time after it was recorded
+    bool frozen() const {
+        return _frozen;
+    }
+
+    //Number of probes in all groups
+    size_t probes() const {
+        return _probes.size();
+    }
+
+    /*
+     * Changes in buffers ordered by time. Every probe starts with its level before the oldest
+     * remaining change of its group, at time of that change
+    */
+    std::vector<Record> records() const;
+
+    /*
+     * Writes records as VCD file, trigger time is marked with comment.
+     * Throws std::runtime_error if file can't be written
+    */
+    void writeVcd(const std::string& path) const;
+
+    //Clears buffers and arms trigger again, next moment records all probes
+    void rearm();
+
+private:
+    struct Probe {
+        std::string name;
+        size_t group;
+        //level at last recorded change, 0xff before the first one
+        unsigned char last;
+        //level before the oldest change in ring, 0xff if nothing was dropped
+        unsigned char dropped;
+    };
+
+    struct Group {
+        std::vector<Record> ring;
+        //position of the oldest record and number of records
+        size_t head;
+        size_t size;
+    };
+
+    //Records change, does nothing after buffer froze
+    void changed(long long time, size_t probe, Logic::Value value) override;
+
+    //Checks trigger after moment
+    void published(long long time) override;
+
+    //Adds record to ring of its group, the oldest record is dropped when ring is full
+    void push(const Record& record);
+
+    //True if trigger is met by change of its probe from 'from' to 'to'
+    bool fires(unsigned char from, unsigned char to) const;
+
+    std::vector<Probe> _probes;
+    std::vector<Group> _groups;
+
+    //probe of trigger, -1 without trigger
+    long long _triggerProbe = -1;
+    Condition _condition = Condition::EQUALS;
+    Logic::Value _value = Logic::ONE;
+    long long _after = 0;
+    //level of trigger probe before last moment, 0xff before the first one
+    unsigned char _triggerLast = 0xff;
+    long long _triggerTime = -1;
+    bool _frozen = false;
+    bool _started = false;
+};
+
+#endif /* TRACE_BUFFER_HPP */
@@ -0,0 +1,97 @@
+#ifndef VCD_WRITER_HPP
+#define VCD_WRITER_HPP
+
+#include "change_feed.hpp"
+
+#include <condition_variable>
+#include <cstddef>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class Node;
+
+/*
+ * Value change dump (IEEE 1364 VCD) of logic levels of nets, for waveform viewers like GTKWave.
+ * Every probe is one 1-bit wire named by its node, time unit is 1 ms of simulated time.
+ *
+ * Changes come from ChangeFeed, so only probes whose level changed in a moment are recorded
+ * and the first moment records all of them. Changes are collected in buffer of fixed size, full buffers
+ * are formatted and written by background thread, so simulation only appends to buffer.
+ * If writer falls behind, simulation waits until one of few queued buffers is free.
+*/
+class VcdWriter : private ChangeFeed::Subscriber {
+public:
+    struct Probe {
+        //name of wire in file, without spaces
+        std::string name;
+        //probe stays on node at its coordinates
+        const Node* node;
+    };
+
+    /*
+     * Creates file and writes header with all probes.
+     * Throws std::runtime_error if file can't be created
+    */
+    VcdWriter(const std::string& path, const std::vector<Probe>& probes, size_t bufferSize = 1 << 16);
+
+    //Closes file, errors are ignored, call close() to see them
+    ~VcdWriter() override;
+
+    //Writes remaining changes and waits for writer. Throws std::runtime_error if file couldn't be written
+    void close();
+
+    //Number of recorded value changes
+    size_t changes() const {
+        return _changes;
+    }
+
+    //Short identifier of probe 'index' in file, printable characters from '!' to '~'
+    static std::string identifier(size_t index);
+
+    //Writes header with one wire for every name, their identifiers are identifier(i)
+    static void writeHeader(std::ostream& out, const std::vector<std::string>& names);
+
+private:
+    struct Change {
+        long long time;
+        unsigned probe;
+        unsigned char value;
+    };
+
+    void changed(long long time, size_t probe, Logic::Value value) override;
+
+    //Hands current buffer to writer, waits if too many buffers are queued
+    void flush();
+
+    //Body of writer thread
+    void write();
+
+    void format(const std::vector<Change>& changes, std::string& text);
+
+    std::string _path;
+    std::ofstream _out;
+    std::vector<std::string> _ids;
+    std::vector<Change> _buffer;
+    size_t _bufferSize;
+    size_t _changes = 0;
+
+    //shared with writer thread
+    std::mutex _mutex;
+    std::condition_variable _queued;
+    std::condition_variable _written;
+    std::vector<std::vector<Change>> _queue;
+    //written buffers which can be filled again
+    std::vector<std::vector<Change>> _spare;
+    bool _closing = false;
+    bool _failed = false;
+    bool _closed = false;
+
+    //used only by writer thread
+    long long _time = -1;
+    std::thread _writer;
+};
+
+#endif /* VCD_WRITER_HPP */
@@ -0,0 +1,112 @@
+#ifndef WAVEFORM_PANEL_H
+#define WAVEFORM_PANEL_H
+
+#include "change_log.hpp"
+
+#include <QWidget>
+#include <QGraphicsScene>
+#include <QPainter>
+#include <QPushButton>
+#include <QScrollBar>
+#include <QTimer>
+#include <QPaintEvent>
+#include <QWheelEvent>
+#include <QMouseEvent>
+
+#include <vector>
+
+// Draws levels of probes of change log, one summary column of history per pixel
+class WaveformView : public QWidget {
+    Q_OBJECT
+
+public:
+    explicit WaveformView(const ChangeLog& log, QWidget* parent = nullptr);
+
+    // Shows time from 'from' with 'msPerPixel' simulated milliseconds in one pixel
+    void setWindow(double from, double msPerPixel);
+
+    double from() const { return _from; }
+    double msPerPixel() const { return _msPerPixel; }
+
+    // Number of pixels which show history, without names of probes
+    int columns() const;
+
+    // Row selected by click, -1 if there is none
+    int selectedRow() const { return _selected; }
+    void setSelectedRow(int row);
+
+    static const int NAME_WIDTH = 110;
+    static const int ROW_HEIGHT = 24;
+    static const int AXIS_HEIGHT = 18;
+
+signals:
+    // Wheel turned over view: zoom around time under mouse, 'steps' > 0 zooms in
+    void zoomed(double time, int steps);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void wheelEvent(QWheelEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+
+private:
+    // Draws one probe in its row
+    void paintRow(QPainter& painter, size_t probe, int top);
+
+    // Draws times above rows
+    void paintAxis(QPainter& painter);
+
+    const ChangeLog& _log;
+    double _from = 0;
+    double _msPerPixel = 10;
+    int _selected = -1;
+    // reused for every row, so painting doesn't allocate
+    std::vector<ChangeLog::Column> _columns;
+};
+
+/*
+ * Logic analyzer docked in MainWindow: levels of selected nets over simulated time.
+ * Every moment of Timeline is recorded in ChangeLog and view asks log only for summary of its pixel columns,
+ * so repaint costs the same for short and for very long history.
+ * Scrollbar moves through history, wheel zooms around mouse. View follows the newest time
+ * while scrollbar is at its end.
+*/
+class WaveformPanel : public QWidget {
+    Q_OBJECT
+
+public:
+    // Nets of components selected in 'scene' are added by button
+    explicit WaveformPanel(QGraphicsScene* scene, QWidget* parent = nullptr);
+
+    // Removes all probes and history, for example when other schematic is opened
+    void reset();
+
+private slots:
+    void onAddSelected();
+    void onRemove();
+    void onClear();
+    void onRefresh();
+    void onScroll(int value);
+    void onZoomed(double time, int steps);
+
+private:
+    // Updates scrollbar range and window of view after history or zoom changed
+    void updateWindow();
+
+    QGraphicsScene* scene;
+    ChangeLog changeLog;
+    WaveformView* view;
+    QScrollBar* scrollBar;
+    QPushButton* addButton;
+    QPushButton* removeButton;
+    QPushButton* clearButton;
+    // Repaints view at most 60 times per second, only if something changed
+    QTimer* refreshTimer;
+
+    double msPerPixel = 10;
+    // View shows the newest time
+    bool following = true;
+    long long shownEnd = -1;
+    bool updatingScrollBar = false;
+};
+
+#endif // WAVEFORM_PANEL_H
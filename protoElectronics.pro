@@ -4,44 +4,15 @@
 #
 #-------------------------------------------------
 
-QT       += core gui
-
-greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
-
-TARGET = protoElectronics
-TEMPLATE = app
-
-# The following define makes your compiler emit warnings if you use
-# any feature of Qt which has been marked as deprecated (the exact warnings
-# depend on your compiler). Please consult the documentation of the
-# deprecated API in order to know how to port your code away from it.
-DEFINES += QT_DEPRECATED_WARNINGS
-
-# You can also make your code fail to compile if you use deprecated APIs.
-# In order to do so, uncomment the following line.
-# You can also select to disable deprecated APIs only up to a certain version of Qt.
-#DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
-
-CONFIG += c++11
-
-INCLUDEPATH += include
-
-SOURCES += \
-        src/main.cpp \
-        src/mainwindow.cpp \
-        src/scene.cpp \
-        src/components.cpp \
-    src/log_component.cpp \
-    src/dialog.cpp
-
-HEADERS += \
-        include/mainwindow.h \
-        include/scene.h \
-        include/components.hpp \
-    include/log_component.hpp \
-    include/dialog.h
-
-# Default rules for deployment.
-qnx: target.path = /tmp/$${TARGET}/bin
-else: unix:!android: target.path = /opt/$${TARGET}/bin
-!isEmpty(target.path): INSTALLS += target
+# Simulation core is built as a static library without Qt,
+# GUI application links it and only draws components,
+# protosim links it to simulate schematics from command line
+TEMPLATE = subdirs
+
+SUBDIRS = core app protosim
+
+core.file = core.pro
+app.file = app.pro
+app.depends = core
+protosim.file = protosim.pro
+protosim.depends = core
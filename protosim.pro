@@ -0,0 +1,21 @@
+#-------------------------------------------------
+#
+# Command line batch simulator, uses protoelectronics-core without Qt
+#
+#-------------------------------------------------
+
+TARGET = protosim
+TEMPLATE = app
+CONFIG += console c++11 thread
+CONFIG -= qt app_bundle
+
+INCLUDEPATH += include
+
+OBJECTS_DIR = obj/protosim
+
+LIBS += -L$$OUT_PWD -lprotoelectronics-core
+win32:!win32-g++: PRE_TARGETDEPS += $$OUT_PWD/protoelectronics-core.lib
+else: PRE_TARGETDEPS += $$OUT_PWD/libprotoelectronics-core.a
+
+SOURCES += \
+        src/protosim.cpp
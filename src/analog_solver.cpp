@@ -0,0 +1,345 @@
+#include "analog_solver.hpp"
+#include "components.hpp"
+#include "disjoint_set.hpp"
+#include "net.hpp"
+#include "scheduler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+//Position of value which is not in matrix, because one of its nets is fixed
+const size_t NONE = ~size_t(0);
+
+//More updates than this cost more than new numeric factorization
+const size_t MAX_UPDATES = 32;
+
+//Solves small dense system m * x = r (row-major, k x k) with partial pivoting, r is replaced with x
+bool solveDense(std::vector<double>& m, std::vector<double>& r, size_t k) {
+    for (size_t col = 0; col < k; ++col) {
+        size_t pivot = col;
+        for (size_t row = col + 1; row < k; ++row) {
+            if (std::fabs(m[row * k + col]) > std::fabs(m[pivot * k + col])) pivot = row;
+        }
+        if (m[pivot * k + col] == 0) return false;
+        if (pivot != col) {
+            for (size_t j = 0; j < k; ++j) std::swap(m[col * k + j], m[pivot * k + j]);
+            std::swap(r[col], r[pivot]);
+        }
+        for (size_t row = col + 1; row < k; ++row) {
+            double f = m[row * k + col] / m[col * k + col];
+            if (f == 0) continue;
+            for (size_t j = col; j < k; ++j) m[row * k + j] -= f * m[col * k + j];
+            r[row] -= f * r[col];
+        }
+    }
+    for (size_t col = k; col-- > 0;) {
+        for (size_t j = col + 1; j < k; ++j) r[col] -= m[col * k + j] * r[j];
+        r[col] /= m[col * k + col];
+    }
+    return true;
+}
+
+//Conductance of resistor, resistance so small that it has no finite conductance can't be solved
+double conductance(const Resistor* resistor) {
+    double g = 1 / resistor->resistance();
+    if (!std::isfinite(g) || g <= 0) {
+        throw std::runtime_error("Error: resistance of " + resistor->name() + " can't be solved");
+    }
+    return g;
+}
+
+}
+
+AnalogSolver::AnalogSolver(const std::vector<Component*>& components) {
+    for (auto c : components) {
+        if (c->kind() == ComponentKind::RESISTOR) _resistors.push_back(static_cast<Resistor*>(c));
+        else if (c->kind() == ComponentKind::SWITCH) _switches.push_back(static_cast<Switch*>(c));
+        else if (c->kind() == ComponentKind::WIRE) _wires.push_back(c);
+        else _sources.push_back(c);
+    }
+    _volatile.assign(_switches.size(), false);
+}
+
+AnalogSolver::Topology AnalogSolver::topology() const {
+    std::unordered_map<Node*, int> index;
+    DisjointSet sets;
+    auto id = [&index, &sets](Node* node) {
+        auto it = index.find(node);
+        if (it != index.end()) return it->second;
+        int i = sets.add();
+        index[node] = i;
+        return i;
+    };
+
+    //Same nets as NetList, except flipped switches
+    for (auto w : _wires) {
+        const auto& nodes = w->nodes();
+        for (size_t k = 1; k < nodes.size(); ++k) sets.unite(id(nodes[0].get()), id(nodes[k].get()));
+    }
+    for (size_t i = 0; i < _switches.size(); ++i) {
+        const auto& nodes = _switches[i]->nodes();
+        if (nodes.size() != 2) continue;
+        int a = id(nodes[0].get()), b = id(nodes[1].get());
+        if (!_volatile[i] && _switches[i]->isClosed()) sets.unite(a, b);
+    }
+
+    //Groups are numbered in order of components, so the same circuit gives the same topology
+    Topology t;
+    std::unordered_map<int, int> groups;
+    auto group = [&](Node* node) {
+        int root = sets.find(id(node));
+        auto it = groups.find(root);
+        if (it != groups.end()) return it->second;
+        int g = static_cast<int>(t.kinds.size());
+        groups[root] = g;
+        t.kinds.push_back(FREE);
+        t.nodes.push_back(node);
+        return g;
+    };
+    auto ends = [&group](const Component* c, std::vector<int>& out) {
+        const auto& nodes = c->nodes();
+        out.push_back(nodes.size() == 2 ? group(nodes[0].get()) : -1);
+        out.push_back(nodes.size() == 2 ? group(nodes[1].get()) : -1);
+    };
+    for (auto r : _resistors) ends(r, t.resistors);
+    for (auto s : _switches) ends(s, t.switches);
+
+    //Ground wins over other sources in the same group
+    for (auto c : _sources) {
+        const auto& nodes = c->nodes();
+        Kind kind = c->kind() == ComponentKind::GROUND ? GROUND : FIXED;
+        for (unsigned pin = 0; pin < nodes.size(); ++pin) {
+            if (c->isInput(pin)) continue;
+            Kind& k = t.kinds[group(nodes[pin].get())];
+            k = std::max(k, kind);
+        }
+    }
+    return t;
+}
+
+void AnalogSolver::build(const Topology& topology) {
+    _topology = topology;
+    _branches.clear();
+    _groups.clear();
+    ++_analyses;
+
+    //Free groups joined by resistors make clusters, cluster without fixed group is floating
+    size_t count = _topology.kinds.size();
+    DisjointSet clusters(static_cast<int>(count));
+    std::vector<bool> anchored(count, false);
+    for (size_t i = 0; i < _resistors.size(); ++i) {
+        int a = _topology.resistors[2 * i], b = _topology.resistors[2 * i + 1];
+        if (a < 0 || a == b) continue;
+        clusters.unite(a, b);
+    }
+    for (size_t g = 0; g < count; ++g) {
+        if (_topology.kinds[g] != FREE) anchored[clusters.find(static_cast<int>(g))] = true;
+    }
+
+    _unknowns.assign(count, -1);
+    for (size_t g = 0; g < count; ++g) {
+        if (_topology.kinds[g] != FREE || !anchored[clusters.find(static_cast<int>(g))]) continue;
+        _unknowns[g] = static_cast<int>(_groups.size());
+        _groups.push_back(static_cast<int>(g));
+    }
+
+    //Symmetric pattern: diagonal of every unknown and both positions of every resistor between unknowns
+    size_t n = _groups.size();
+    std::vector<std::vector<unsigned>> adjacent(n);
+    for (size_t i = 0; i < n; ++i) adjacent[i].push_back(static_cast<unsigned>(i));
+    for (size_t i = 0; i < _resistors.size(); ++i) {
+        Branch branch;
+        branch.resistor = _resistors[i];
+        branch.ga = _topology.resistors[2 * i];
+        branch.gb = _topology.resistors[2 * i + 1];
+        if (branch.ga < 0 || branch.ga == branch.gb) continue;
+        branch.ia = _unknowns[branch.ga];
+        branch.ib = _unknowns[branch.gb];
+        if (branch.ia < 0 && branch.ib < 0) continue;
+        if (branch.ia >= 0 && branch.ib >= 0) {
+            adjacent[branch.ia].push_back(branch.ib);
+            adjacent[branch.ib].push_back(branch.ia);
+        }
+        _branches.push_back(branch);
+    }
+
+    std::vector<size_t> columns(n + 1, 0);
+    std::vector<unsigned> rows;
+    for (size_t j = 0; j < n; ++j) {
+        auto& column = adjacent[j];
+        std::sort(column.begin(), column.end());
+        column.erase(std::unique(column.begin(), column.end()), column.end());
+        rows.insert(rows.end(), column.begin(), column.end());
+        columns[j + 1] = rows.size();
+    }
+
+    auto position = [&columns, &rows](int row, int column) {
+        if (row < 0 || column < 0) return NONE;
+        auto first = rows.begin() + columns[column];
+        auto last = rows.begin() + columns[column + 1];
+        return static_cast<size_t>(std::lower_bound(first, last, static_cast<unsigned>(row)) - rows.begin());
+    };
+    for (auto& branch : _branches) {
+        branch.values[0] = position(branch.ia, branch.ia);
+        branch.values[1] = position(branch.ib, branch.ib);
+        branch.values[2] = position(branch.ia, branch.ib);
+        branch.values[3] = position(branch.ib, branch.ia);
+    }
+
+    _lu.analyze(n, columns, rows);
+    _values.assign(rows.size(), 0);
+    _closed.clear();
+    for (auto s : _switches) _closed.push_back(s->isClosed());
+    factorize();
+}
+
+void AnalogSolver::factorize() {
+    ++_factorizations;
+    _built = false;
+    std::fill(_values.begin(), _values.end(), 0.0);
+    for (auto& branch : _branches) {
+        branch.base = branch.conductance = conductance(branch.resistor);
+        double g = branch.base;
+        if (branch.values[0] != NONE) _values[branch.values[0]] += g;
+        if (branch.values[1] != NONE) _values[branch.values[1]] += g;
+        if (branch.values[2] != NONE) _values[branch.values[2]] -= g;
+        if (branch.values[3] != NONE) _values[branch.values[3]] -= g;
+    }
+
+    //Cached solutions belong to old matrix
+    _z.clear();
+    _resistorZ.assign(_resistors.size(), -1);
+    _switchZ.assign(_switches.size(), -1);
+
+    if (!_lu.factorize(_values)) {
+        throw std::runtime_error("Error: resistor network can't be solved");
+    }
+    _built = true;
+}
+
+size_t AnalogSolver::cached(std::vector<int>& cache, size_t i, int a, int b) {
+    if (cache[i] < 0) {
+        std::vector<double> u(_groups.size(), 0);
+        if (a >= 0) u[a] = 1;
+        if (b >= 0) u[b] = -1;
+        _lu.solve(u);
+        cache[i] = static_cast<int>(_z.size());
+        _z.push_back(std::move(u));
+    }
+    return static_cast<size_t>(cache[i]);
+}
+
+bool AnalogSolver::collectUpdates() {
+    _updates.clear();
+    for (size_t i = 0; i < _branches.size(); ++i) {
+        Branch& branch = _branches[i];
+        branch.conductance = conductance(branch.resistor);
+        if (branch.conductance == branch.base) continue;
+        double inverse = 1 / (branch.conductance - branch.base);
+        _updates.push_back({branch.ia, branch.ib, inverse, 0, cached(_resistorZ, i, branch.ia, branch.ib)});
+    }
+
+    for (size_t i = 0; i < _switches.size(); ++i) {
+        if (!_volatile[i] || !_switches[i]->isClosed()) continue;
+        int ga = _topology.switches[2 * i], gb = _topology.switches[2 * i + 1];
+        if (ga < 0 || ga == gb) continue;
+        if (_topology.kinds[ga] != FREE && _topology.kinds[gb] != FREE) continue;
+
+        int a = _unknowns[ga], b = _unknowns[gb];
+        //Floating group joined with the rest needs its own unknowns, switch goes back to matrix
+        if ((_topology.kinds[ga] == FREE && a < 0) || (_topology.kinds[gb] == FREE && b < 0)) {
+            _volatile[i] = false;
+            return false;
+        }
+        //v(a) - v(b) = 0, fixed side moves to right side
+        double c = 0;
+        if (a < 0) c = -fixedVoltage(ga);
+        if (b < 0) c = fixedVoltage(gb);
+        _updates.push_back({a, b, 0, c, cached(_switchZ, i, a, b)});
+    }
+    return true;
+}
+
+double AnalogSolver::fixedVoltage(int group) const {
+    if (_topology.kinds[group] == GROUND) return 0;
+    return NetList::voltage(_topology.nodes[group]->net());
+}
+
+size_t AnalogSolver::solve() {
+    if (!_built || _version != NetList::version()) {
+        //Switch flipped since matrix was built stays out of matrix from now on
+        for (size_t i = 0; i < _switches.size() && _built; ++i) {
+            if (_switches[i]->isClosed() != _closed[i]) _volatile[i] = true;
+        }
+        Topology t = topology();
+        if (!_built || !(t == _topology)) build(t);
+        else _topology.nodes = t.nodes;
+        _version = NetList::version();
+    }
+
+    if (!collectUpdates()) {
+        build(topology());
+        collectUpdates();
+    }
+    if (_updates.size() > MAX_UPDATES) {
+        factorize();
+        collectUpdates();
+    }
+    if (_updates.size() > MAX_UPDATES) {
+        //Many closed switches: they go back to matrix
+        std::fill(_volatile.begin(), _volatile.end(), false);
+        build(topology());
+        collectUpdates();
+    }
+
+    //Current from fixed groups through resistors
+    _rhs.assign(_groups.size(), 0);
+    for (const auto& branch : _branches) {
+        if (branch.ia >= 0 && branch.ib < 0) _rhs[branch.ia] += branch.conductance * fixedVoltage(branch.gb);
+        if (branch.ib >= 0 && branch.ia < 0) _rhs[branch.ib] += branch.conductance * fixedVoltage(branch.ga);
+    }
+    _lu.solve(_rhs);
+
+    /*
+     * Woodbury: (A + U C^-1 U^T) x = b and constraints U^T x = c are solved by
+     * x = x0 - Z * l, where x0 = A^-1 b, Z = A^-1 U and (U^T Z + C) l = U^T x0 - c
+    */
+    size_t k = _updates.size();
+    if (k > 0) {
+        auto dot = [](const Update& u, const std::vector<double>& v) {
+            return (u.a >= 0 ? v[u.a] : 0) - (u.b >= 0 ? v[u.b] : 0);
+        };
+        std::vector<double> m(k * k), l(k);
+        for (size_t i = 0; i < k; ++i) {
+            for (size_t j = 0; j < k; ++j) m[i * k + j] = dot(_updates[i], _z[_updates[j].z]);
+            m[i * k + i] += _updates[i].inverse;
+            l[i] = dot(_updates[i], _rhs) - _updates[i].c;
+        }
+        if (!solveDense(m, l, k)) {
+            throw std::runtime_error("Error: resistor network can't be solved");
+        }
+        for (size_t j = 0; j < k; ++j) {
+            const auto& z = _z[_updates[j].z];
+            for (size_t i = 0; i < _rhs.size(); ++i) _rhs[i] -= z[i] * l[j];
+        }
+    }
+
+    //Voltages are written only when all of them are numbers
+    for (double v : _rhs) {
+        if (!std::isfinite(v)) throw std::runtime_error("Error: resistor network can't be solved");
+    }
+
+    Scheduler::hold();
+    for (size_t i = 0; i < _groups.size(); ++i) {
+        int net = _topology.nodes[_groups[i]]->net();
+        if (doubleEquals(NetList::voltage(net), _rhs[i])) continue;
+        NetList::setVoltage(net, _rhs[i]);
+        Scheduler::scheduleNet(net);
+    }
+    Scheduler::release();
+    return _groups.size();
+}
@@ -0,0 +1,92 @@
+#include "change_feed.hpp"
+#include "components.hpp"
+#include "net.hpp"
+
+#include <algorithm>
+
+std::vector<ChangeFeed::Subscriber*> ChangeFeed::_subscribers;
+std::vector<int> ChangeFeed::_nets;
+
+ChangeFeed::Subscriber::Subscriber() {
+    _subscribers.push_back(this);
+    NetList::watchLevels(true);
+}
+
+ChangeFeed::Subscriber::~Subscriber() {
+    _subscribers.erase(std::find(_subscribers.begin(), _subscribers.end(), this));
+    if (_subscribers.empty()) {
+        NetList::watchLevels(false);
+        NetList::takeChangedLevels(_nets);
+    }
+}
+
+size_t ChangeFeed::Subscriber::watch(int x, int y) {
+    _probes.push_back(Probe{x, y, -1, 0xff});
+    _stale = true;
+    return _probes.size() - 1;
+}
+
+void ChangeFeed::Subscriber::unwatch(size_t probe) {
+    _probes.erase(_probes.begin() + static_cast<std::ptrdiff_t>(probe));
+    _stale = true;
+}
+
+bool ChangeFeed::Subscriber::watches(size_t probe, int x, int y) const {
+    auto node = Node::find(x, y);
+    if (node == Node::_allNodes.end()) return false;
+    auto other = Node::find(_probes[probe].x, _probes[probe].y);
+    return other != Node::_allNodes.end() && (*other)->net() == (*node)->net();
+}
+
+void ChangeFeed::Subscriber::locate() {
+    _first.clear();
+    _next.assign(_probes.size(), -1);
+    for (size_t i = 0; i < _probes.size(); ++i) {
+        Probe& probe = _probes[i];
+        auto node = Node::find(probe.x, probe.y);
+        probe.net = node != Node::_allNodes.end() ? (*node)->net() : -1;
+        if (probe.net < 0) continue;
+
+        size_t net = static_cast<size_t>(probe.net);
+        if (net >= _first.size()) _first.resize(net + 1, -1);
+        //Probes of one net are listed backwards, touched probes are sorted anyway
+        _next[i] = _first[net];
+        _first[net] = static_cast<int>(i);
+    }
+    _version = NetList::version();
+    _stale = false;
+}
+
+void ChangeFeed::Subscriber::compare(long long time, size_t probe) {
+    Probe& p = _probes[probe];
+    unsigned char value = p.net >= 0 ? NetList::level(p.net) : Logic::floating();
+    if (value == p.last) return;
+    p.last = value;
+    changed(time, probe, static_cast<Logic::Value>(value));
+}
+
+void ChangeFeed::Subscriber::update(long long time, const std::vector<int>& nets) {
+    if (_stale || _version != NetList::version()) {
+        //Levels of nets which were made or joined aren't marked, so all probes are compared
+        locate();
+        for (size_t i = 0; i < _probes.size(); ++i) compare(time, i);
+    }
+    else {
+        _touched.clear();
+        for (int net : nets) {
+            if (static_cast<size_t>(net) >= _first.size()) continue;
+            for (int i = _first[static_cast<size_t>(net)]; i >= 0; i = _next[static_cast<size_t>(i)]) {
+                _touched.push_back(static_cast<size_t>(i));
+            }
+        }
+        std::sort(_touched.begin(), _touched.end());
+        for (size_t i : _touched) compare(time, i);
+    }
+    published(time);
+}
+
+void ChangeFeed::publish(long long time) {
+    if (_subscribers.empty()) return;
+    NetList::takeChangedLevels(_nets);
+    for (size_t i = 0; i < _subscribers.size(); ++i) _subscribers[i]->update(time, _nets);
+}
@@ -0,0 +1,88 @@
+#include "change_log.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+ChangeLog::ChangeLog(size_t limit)
+    :_limit(limit > 1 ? limit : 2)
+{}
+
+size_t ChangeLog::addProbe(const std::string& name, int x, int y) {
+    _probes.push_back(Probe{name, {}, {}, 0xff});
+    return watch(x, y);
+}
+
+void ChangeLog::removeProbe(size_t probe) {
+    _probes.erase(_probes.begin() + static_cast<std::ptrdiff_t>(probe));
+    unwatch(probe);
+}
+
+bool ChangeLog::probed(int x, int y) const {
+    for (size_t probe = 0; probe < _probes.size(); ++probe) {
+        if (watches(probe, x, y)) return true;
+    }
+    return false;
+}
+
+void ChangeLog::changed(long long time, size_t probe, Logic::Value value) {
+    Probe& p = _probes[probe];
+    if (p.times.size() == _limit) {
+        size_t half = _limit / 2;
+        p.dropped = p.values[half - 1];
+        p.times.erase(p.times.begin(), p.times.begin() + static_cast<std::ptrdiff_t>(half));
+        p.values.erase(p.values.begin(), p.values.begin() + static_cast<std::ptrdiff_t>(half));
+    }
+    p.times.push_back(time);
+    p.values.push_back(value);
+}
+
+void ChangeLog::clear() {
+    for (Probe& probe : _probes) {
+        probe.times.clear();
+        probe.values.clear();
+        probe.dropped = 0xff;
+    }
+    _end = -1;
+    //Current levels start new history at next moment
+    resend();
+}
+
+long long ChangeLog::begin() const {
+    long long oldest = -1, cut = -1;
+    for (const Probe& probe : _probes) {
+        if (probe.times.empty()) continue;
+        if (oldest < 0 || probe.times.front() < oldest) oldest = probe.times.front();
+        if (probe.dropped != 0xff && probe.times.front() > cut) cut = probe.times.front();
+    }
+    return std::max(oldest, cut);
+}
+
+Logic::Value ChangeLog::level(size_t probe, long long time) const {
+    const Probe& p = _probes[probe];
+    size_t index = static_cast<size_t>(std::upper_bound(p.times.begin(), p.times.end(), time) - p.times.begin());
+    return after(p, index);
+}
+
+void ChangeLog::summarize(size_t probe, long long from, long long to, std::vector<Column>& columns) const {
+    const Probe& p = _probes[probe];
+    size_t count = columns.size();
+    if (count == 0) return;
+    double width = static_cast<double>(to - from) / static_cast<double>(count);
+
+    //Columns go forward in time, so every search starts where previous one ended
+    auto position = p.times.begin();
+    auto index = [&p, &position](long long time) {
+        position = std::upper_bound(position, p.times.end(), time);
+        return static_cast<size_t>(position - p.times.begin());
+    };
+
+    //Column is empty when it is narrower than one millisecond
+    size_t start = index(from - 1);
+    for (size_t c = 0; c < count; ++c) {
+        //Column has moments from the first one at or after its start to the last one before next column
+        long long end = from + static_cast<long long>(std::ceil(width * static_cast<double>(c + 1))) - 1;
+        size_t last = end >= from + static_cast<long long>(std::ceil(width * static_cast<double>(c))) ? index(end) : start;
+        columns[c] = Column{after(p, start), after(p, last), static_cast<uint32_t>(last - start)};
+        start = last;
+    }
+}
@@ -1,4 +1,5 @@
 #include "circuit.hpp"
+#include "scheduler.hpp"
 #include <iostream>
 #include <stdexcept>
 
@@ -15,6 +16,8 @@ Circuit::Circuit() {
 }
 
 Circuit::~Circuit() {
+    //Unfinished batch would leave scheduler held for other circuits
+    while (_batches > 0) commit();
     removeComponents();
 }
 
@@ -23,6 +26,23 @@ void Circuit::addComponent(Component* c) {
     _components.push_back(c);
 }
 
+void Circuit::reserve(size_t count) {
+    _components.reserve(count);
+}
+
+void Circuit::begin() {
+    ++_batches;
+    Scheduler::hold();
+}
+
+void Circuit::commit() {
+    if (_batches == 0) {
+        throw std::logic_error("Circuit batch is committed without begin");
+    }
+    --_batches;
+    Scheduler::release();
+}
+
 void Circuit::removeComponents() {
     for (auto c : _components) {
         delete c;
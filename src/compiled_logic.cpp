@@ -0,0 +1,436 @@
+#include "compiled_logic.hpp"
+#include "log_component.hpp"
+#include "logic_kernel.hpp"
+#include "thread_pool.hpp"
+#include "disjoint_set.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+
+//Opcode for type of gate, false if gate can't be compiled
+bool opcodeOf(const Component* c, CompiledLogic::Opcode& op) {
+    switch (c->kind()) {
+    case ComponentKind::AND:  op = CompiledLogic::AND; return true;
+    case ComponentKind::OR:   op = CompiledLogic::OR; return true;
+    case ComponentKind::XOR:  op = CompiledLogic::XOR; return true;
+    case ComponentKind::NAND: op = CompiledLogic::NAND; return true;
+    case ComponentKind::NOR:  op = CompiledLogic::NOR; return true;
+    case ComponentKind::NXOR: op = CompiledLogic::NXOR; return true;
+    case ComponentKind::NOT:  op = CompiledLogic::NOT; return true;
+    default: return false;
+    }
+}
+
+//Instructions in one parallel task, big enough that threads don't wait for each other more than they work
+const size_t TASK_SIZE = 1024;
+
+//Runs part of program on bit values of slots, patterns in words are evaluated by LogicKernel
+void execute(const CompiledLogic::Instruction* begin, const CompiledLogic::Instruction* end, unsigned char* v) {
+    for (const auto* ins = begin; ins != end; ++ins) {
+        switch (ins->op) {
+        case CompiledLogic::AND:  v[ins->out] = v[ins->a] & v[ins->b]; break;
+        case CompiledLogic::OR:   v[ins->out] = v[ins->a] | v[ins->b]; break;
+        case CompiledLogic::XOR:  v[ins->out] = v[ins->a] ^ v[ins->b]; break;
+        case CompiledLogic::NAND: v[ins->out] = 1 ^ (v[ins->a] & v[ins->b]); break;
+        case CompiledLogic::NOR:  v[ins->out] = 1 ^ (v[ins->a] | v[ins->b]); break;
+        case CompiledLogic::NXOR: v[ins->out] = 1 ^ v[ins->a] ^ v[ins->b]; break;
+        case CompiledLogic::NOT:  v[ins->out] = 1 ^ v[ins->a]; break;
+        }
+    }
+}
+
+//Four-state results of instructions, index is opcode * 16 + a * 4 + b
+struct FourStateTable {
+    unsigned char out[7 * 16];
+
+    FourStateTable() {
+        for (unsigned op = CompiledLogic::AND; op <= CompiledLogic::NOT; ++op) {
+            for (unsigned i = 0; i < 16; ++i) {
+                Logic::Value a = static_cast<Logic::Value>(i >> 2);
+                Logic::Value b = static_cast<Logic::Value>(i & 3);
+                Logic::Value r;
+                switch (op) {
+                case CompiledLogic::AND:  r = Logic::andOf(a, b); break;
+                case CompiledLogic::OR:   r = Logic::orOf(a, b); break;
+                case CompiledLogic::XOR:  r = Logic::xorOf(a, b); break;
+                case CompiledLogic::NAND: r = Logic::notOf(Logic::andOf(a, b)); break;
+                case CompiledLogic::NOR:  r = Logic::notOf(Logic::orOf(a, b)); break;
+                case CompiledLogic::NXOR: r = Logic::notOf(Logic::xorOf(a, b)); break;
+                default:                  r = Logic::notOf(a); break;
+                }
+                out[op * 16 + i] = r;
+            }
+        }
+    }
+};
+
+const FourStateTable FOUR_STATE;
+
+//Same as execute, but slots have four-state values (Logic::Value)
+void executeFourState(const CompiledLogic::Instruction* begin, const CompiledLogic::Instruction* end, unsigned char* v) {
+    for (const auto* ins = begin; ins != end; ++ins) {
+        v[ins->out] = FOUR_STATE.out[ins->op * 16 + v[ins->a] * 4 + v[ins->b]];
+    }
+}
+
+//Checks that nothing except 'gate' can drive net: other pins only read it or join it with other nodes
+bool drivenOnlyBy(int net, const Component* gate) {
+    for (const Node* node : NetList::nodes(net)) {
+        for (Component* c : node->directComponents()) {
+            if (c->joinsNets()) continue;
+
+            const auto& nodes = c->nodes();
+            for (unsigned pin = 0; pin < nodes.size(); ++pin) {
+                if (nodes[pin].get() != node) continue;
+                bool output = c == gate && pin + 1 == nodes.size();
+                if (!output && !c->isInput(pin)) return false;
+            }
+        }
+    }
+    return true;
+}
+
+}
+
+CompiledLogic::CompiledLogic(const std::vector<Component*>& components) {
+    Opcode op;
+    for (auto c : components) {
+        if (opcodeOf(c, op)) _candidates.push_back(c);
+    }
+    compile();
+}
+
+CompiledLogic::~CompiledLogic() {
+    for (auto c : _candidates) c->_block = nullptr;
+}
+
+const std::vector<CompiledLogic::Instruction>& CompiledLogic::program() {
+    update();
+    return _program;
+}
+
+size_t CompiledLogic::fallbacks() {
+    update();
+    return _fallbacks;
+}
+
+unsigned CompiledLogic::levels() {
+    update();
+    return _levels;
+}
+
+void CompiledLogic::update() {
+    if (!_compiled || _version != NetList::version()) compile();
+}
+
+void CompiledLogic::remove(Component* gate) {
+    gate->_block = nullptr;
+    _candidates.erase(std::remove(_candidates.begin(), _candidates.end(), gate), _candidates.end());
+    _compiled = false;
+}
+
+void CompiledLogic::compile() {
+    struct Gate {
+        Component* component;
+        Opcode op;
+        std::vector<int> inputs;
+        int output;
+        unsigned level;
+    };
+
+    for (auto c : _candidates) c->_block = nullptr;
+    _program.clear();
+    _gates.clear();
+    _nets.clear();
+    _slots.clear();
+    _inputs.clear();
+    _levels = 0;
+
+    //Gates which have all pins connected and are the only drivers of their outputs
+    std::vector<Gate> gates;
+    for (auto c : _candidates) {
+        Gate g;
+        g.component = c;
+        opcodeOf(c, g.op);
+        g.level = 0;
+
+        //Program has no notion of time, gates with delay are evaluated by scheduler
+        if (c->delay().time > 0) continue;
+
+        const auto& nodes = c->nodes();
+        if (nodes.size() != (g.op == NOT ? 2u : 3u)) continue;
+        for (unsigned i = 0; i + 1 < nodes.size(); ++i) g.inputs.push_back(nodes[i]->net());
+        g.output = nodes.back()->net();
+        if (drivenOnlyBy(g.output, c)) gates.push_back(g);
+    }
+
+    std::unordered_map<int, size_t> driver;
+    for (size_t i = 0; i < gates.size(); ++i) driver[gates[i].output] = i;
+
+    //Edges from gate which drives net to gates which read it
+    std::vector<std::vector<size_t>> readers(gates.size()), drivers(gates.size());
+    for (size_t i = 0; i < gates.size(); ++i) {
+        for (int net : gates[i].inputs) {
+            auto it = driver.find(net);
+            if (it == driver.end()) continue;
+            readers[it->second].push_back(i);
+            drivers[i].push_back(it->second);
+        }
+    }
+
+    //Kahn's algorithm, 'in' are predecessors and 'out' successors of every gate, returns gates in topological order
+    auto peel = [&gates](const std::vector<std::vector<size_t>>& in,
+                         const std::vector<std::vector<size_t>>& out,
+                         const std::vector<bool>& skip) {
+        std::vector<unsigned> degree(gates.size(), 0);
+        for (size_t i = 0; i < gates.size(); ++i) {
+            if (skip[i]) continue;
+            for (size_t p : in[i]) if (!skip[p]) ++degree[i];
+        }
+        std::vector<size_t> order;
+        for (size_t i = 0; i < gates.size(); ++i) {
+            if (!skip[i] && degree[i] == 0) order.push_back(i);
+        }
+        for (size_t k = 0; k < order.size(); ++k) {
+            for (size_t next : out[order[k]]) {
+                if (!skip[next] && --degree[next] == 0) order.push_back(next);
+            }
+        }
+        return order;
+    };
+
+    //Gates left after peeling from both sides are in feedback loops (or between them), they stay event-driven
+    std::vector<bool> skip(gates.size(), false);
+    std::vector<bool> forward(gates.size(), false), backward(gates.size(), false);
+    for (size_t i : peel(drivers, readers, skip)) forward[i] = true;
+    for (size_t i : peel(readers, drivers, skip)) backward[i] = true;
+    for (size_t i = 0; i < gates.size(); ++i) skip[i] = !forward[i] && !backward[i];
+
+    std::vector<size_t> order = peel(drivers, readers, skip);
+    for (size_t i : order) {
+        for (size_t p : drivers[i]) {
+            if (!skip[p]) gates[i].level = std::max(gates[i].level, gates[p].level + 1);
+        }
+        _levels = std::max(_levels, gates[i].level + 1);
+    }
+    std::stable_sort(order.begin(), order.end(), [&gates](size_t a, size_t b) {
+        return gates[a].level < gates[b].level;
+    });
+
+    //Every net used by program gets one slot
+    auto slot = [this](int net) {
+        auto it = _slots.find(net);
+        if (it != _slots.end()) return it->second;
+        unsigned s = static_cast<unsigned>(_nets.size());
+        _slots[net] = s;
+        _nets.push_back(net);
+        return s;
+    };
+
+    std::vector<bool> driven;
+    std::vector<unsigned> levels;
+    for (size_t i : order) {
+        const Gate& g = gates[i];
+        Instruction ins;
+        ins.op = g.op;
+        ins.a = slot(g.inputs[0]);
+        ins.b = g.op == NOT ? ins.a : slot(g.inputs[1]);
+        ins.out = slot(g.output);
+        _program.push_back(ins);
+        _gates.push_back(g.component);
+        levels.push_back(g.level);
+        g.component->_block = this;
+
+        driven.resize(_nets.size(), false);
+        driven[ins.out] = true;
+    }
+    driven.resize(_nets.size(), false);
+    for (unsigned s = 0; s < _nets.size(); ++s) {
+        if (!driven[s]) _inputs.push_back(s);
+    }
+
+    partition(levels);
+
+    _values.assign(_nets.size(), 0);
+    _fallbacks = _candidates.size() - _program.size();
+    _version = NetList::version();
+    _compiled = true;
+}
+
+void CompiledLogic::partition(const std::vector<unsigned>& levels) {
+    //Gates connected through nets make clusters, different clusters never read each other
+    DisjointSet clusters(static_cast<int>(_nets.size()));
+    for (const auto& ins : _program) {
+        clusters.unite(ins.a, ins.out);
+        clusters.unite(ins.b, ins.out);
+    }
+    std::unordered_map<int, size_t> clusterOf;
+    std::vector<std::vector<size_t>> members;
+    for (size_t i = 0; i < _program.size(); ++i) {
+        auto it = clusterOf.emplace(clusters.find(_program[i].out), members.size()).first;
+        if (it->second == members.size()) members.emplace_back();
+        members[it->second].push_back(i);
+    }
+
+    std::vector<size_t> order;
+    _stages.assign(1, std::vector<Range>());
+    size_t begin = 0;
+    auto close = [&](std::vector<Range>& stage) {
+        if (order.size() > begin) stage.push_back({begin, order.size()});
+        begin = order.size();
+    };
+
+    //Small clusters are packed whole into tasks of the first stage
+    std::vector<std::vector<size_t>> byLevel(_levels);
+    for (const auto& cluster : members) {
+        if (cluster.size() > TASK_SIZE) {
+            for (size_t i : cluster) byLevel[levels[i]].push_back(i);
+            continue;
+        }
+        order.insert(order.end(), cluster.begin(), cluster.end());
+        if (order.size() - begin >= TASK_SIZE) close(_stages[0]);
+    }
+    close(_stages[0]);
+
+    /*
+     * Big clusters go level by level: wide level is split into tasks of its own stage,
+     * narrow levels in a row are one task, because waiting for threads would cost more
+    */
+    bool serial = false;
+    for (const auto& level : byLevel) {
+        if (level.size() < 2 * TASK_SIZE) {
+            order.insert(order.end(), level.begin(), level.end());
+            serial = serial || !level.empty();
+            continue;
+        }
+        if (serial) {
+            close(_stages.back());
+            _stages.emplace_back();
+            serial = false;
+        }
+        for (size_t k = 0; k < level.size(); k += TASK_SIZE) {
+            order.insert(order.end(), level.begin() + k, level.begin() + std::min(k + TASK_SIZE, level.size()));
+            close(_stages.back());
+        }
+        _stages.emplace_back();
+    }
+    close(_stages.back());
+    if (_stages.back().empty()) _stages.pop_back();
+
+    std::vector<Instruction> program;
+    std::vector<Component*> gates;
+    for (size_t i : order) {
+        program.push_back(_program[i]);
+        gates.push_back(_gates[i]);
+    }
+    _program.swap(program);
+    _gates.swap(gates);
+}
+
+void CompiledLogic::runTasks(const std::function<void(const Instruction*, const Instruction*)>& task) {
+    const Instruction* program = _program.data();
+    if (ThreadPool::threads() == 1) {
+        task(program, program + _program.size());
+        return;
+    }
+
+    for (const auto& stage : _stages) {
+        ThreadPool::run(stage.size(), [&stage, &task, program](size_t t) {
+            task(program + stage[t].begin, program + stage[t].end);
+        });
+    }
+}
+
+size_t CompiledLogic::tasks() {
+    update();
+    size_t count = 0;
+    for (const auto& stage : _stages) count += stage.size();
+    return count;
+}
+
+size_t CompiledLogic::stages() {
+    update();
+    return _stages.size();
+}
+
+void CompiledLogic::evaluate() {
+    if (!_compiled || _version != NetList::version()) {
+        compile();
+        //Gates which left block could miss change of their inputs
+        for (auto c : _candidates) {
+            if (c->_block == nullptr) c->evaluate();
+        }
+    }
+
+    for (unsigned s : _inputs) {
+        _values[s] = static_cast<unsigned char>(NetList::level(_nets[s]));
+    }
+
+    unsigned char* v = _values.data();
+    bool fourState = Logic::fourState();
+    runTasks([v, fourState](const Instruction* begin, const Instruction* end) {
+        if (fourState) executeFourState(begin, end, v);
+        else execute(begin, end, v);
+    });
+
+    //Only changed outputs are written back, readers of those nets inside block are already evaluated
+    for (size_t i = 0; i < _program.size(); ++i) {
+        int net = _nets[_program[i].out];
+        if (fourState) {
+            //Gate is the only driver of its output, but value is kept for resolution after nets change
+            const Component* gate = _gates[i];
+            gate->setDrive(static_cast<unsigned>(gate->nodes().size() - 1), static_cast<Logic::Value>(v[_program[i].out]));
+            if (!NetList::resolve(net, gate)) continue;
+        } else {
+            double voltage = v[_program[i].out] ? 5.0 : 0.0;
+            if (doubleEquals(NetList::voltage(net), voltage)) continue;
+            NetList::setVoltage(net, voltage, _gates[i]);
+        }
+
+        Scheduler::scheduleNet(net, _gates[i]);
+        _gates[i]->notifyObserver();
+    }
+}
+
+void CompiledLogic::evaluate(std::vector<uint64_t>& words, unsigned width) {
+    update();
+    words.resize(_nets.size() * width, 0);
+    uint64_t* v = words.data();
+    runTasks([v, width](const Instruction* begin, const Instruction* end) {
+        LogicKernel::run(begin, end, v, width);
+    });
+}
+
+void CompiledLogic::evaluate(std::vector<uint64_t>& values, std::vector<uint64_t>& unknown, unsigned width) {
+    update();
+    values.resize(_nets.size() * width, 0);
+    unknown.resize(_nets.size() * width, 0);
+    uint64_t* v = values.data();
+    uint64_t* u = unknown.data();
+    runTasks([v, u, width](const Instruction* begin, const Instruction* end) {
+        LogicKernel::run(begin, end, v, u, width);
+    });
+}
+
+size_t CompiledLogic::slots() {
+    update();
+    return _nets.size();
+}
+
+int CompiledLogic::slot(int net) {
+    update();
+    auto it = _slots.find(NetList::find(net));
+    return it == _slots.end() ? -1 : static_cast<int>(it->second);
+}
+
+int CompiledLogic::net(unsigned slot) {
+    update();
+    return _nets.at(slot);
+}
+
+const std::vector<unsigned>& CompiledLogic::inputs() {
+    update();
+    return _inputs;
+}
@@ -0,0 +1,427 @@
+#include "component_item.h"
+#include "mainwindow.h" // for propertiesMessage
+#include "dialog.h"
+
+#include <cmath>
+
+//ComponentItem
+ComponentItem::ComponentItem(Component* component)
+    : _component(component)
+{
+	// Components can accept hover actions
+    setAcceptHoverEvents(true);
+
+	// Setting some flags for components
+    setFlags(QGraphicsItem::ItemIsSelectable |
+            QGraphicsItem::ItemIsMovable |
+            QGraphicsItem::ItemSendsGeometryChanges);
+
+	// Creating different pens for drawing
+    penForLines = QPen(Qt::black, 3, Qt::SolidLine, Qt::RoundCap);
+    penForLinesWhite = QPen(Qt::white, 3, Qt::SolidLine, Qt::RoundCap);
+    penForDots = QPen(Qt::white, 6, Qt::SolidLine, Qt::RoundCap);
+    penForLeadsGreen = QPen(Qt::green, 3, Qt::SolidLine, Qt::RoundCap);
+    penForLeadsRed = QPen(Qt::red, 3, Qt::SolidLine, Qt::RoundCap);
+    penForDigit = QPen(Qt::darkRed, 5, Qt::SolidLine, Qt::RoundCap);
+
+    _component->setObserver(this);
+}
+
+ComponentItem::~ComponentItem() {
+    // Component is deleted before item, so it doesn't notify item anymore
+    _component->setObserver(nullptr);
+    _component.reset();
+}
+
+Component* ComponentItem::component() const {
+    return _component.get();
+}
+
+void ComponentItem::connect() {
+    _component->connect(_component->connectionPoints());
+}
+
+bool ComponentItem::connectedInPlace() const {
+    // Click without move keeps connections, so flipped switch stays an update of analog solver
+    std::vector<std::pair<int, int>> points = _component->connectionPoints();
+    const PinTable& nodes = _component->nodes();
+    if (nodes.size() != points.size()) return false;
+    size_t i = 0;
+    for (const auto& node : nodes) {
+        if (node->x() != points[i].first || node->y() != points[i].second) return false;
+        ++i;
+    }
+    return true;
+}
+
+void ComponentItem::rotate(int angle) {
+    _component->rotate(angle);
+    updateFromComponent();
+}
+
+void ComponentItem::updateFromComponent() {
+    // Size can be changed too (wire length)
+    prepareGeometryChange();
+    setPos(QPointF(_component->x(), _component->y()));
+
+    // Item is drawn with the same transformation which component uses for its connection points
+    const Transform& t = _component->transform();
+    setTransform(QTransform(t.m11, t.m12, t.m21, t.m22, t.dx, t.dy));
+}
+
+void ComponentItem::componentChanged(const Component& component) {
+    Q_UNUSED(component);
+    update();
+}
+
+double ComponentItem::nodeVoltage(unsigned id) const {
+    const auto& nodes = _component->nodes();
+    if (nodes.size() < id+1) return 0;
+    return nodes[id]->v();
+}
+
+QVariant ComponentItem::itemChange(GraphicsItemChange change, const QVariant &value) {
+    if (change == ItemPositionChange && scene()) {
+        QPointF newPos = value.toPointF();
+
+        if(QApplication::mouseButtons() == Qt::LeftButton &&
+                qobject_cast<GridZone*> (scene())){
+
+            GridZone* customScene = qobject_cast<GridZone*> (scene());
+            int gridSize = customScene->getGridSize();
+            qreal xV = round(newPos.x()/gridSize)*gridSize;
+            qreal yV = round(newPos.y()/gridSize)*gridSize;
+            return QPointF(xV, yV);
+        }
+
+        else {
+            return newPos;
+        }
+    }
+
+    // Component needs position for its connection points
+    else if (change == ItemPositionHasChanged) {
+        QPointF newPos = value.toPointF();
+        _component->setPosition(newPos.x(), newPos.y());
+        return QGraphicsItem::itemChange(change, value);
+    }
+
+    else {
+        return QGraphicsItem::itemChange(change, value);
+    }
+}
+
+void ComponentItem::mousePressEvent(QGraphicsSceneMouseEvent* event) {
+	// If mouse right button is pressed over component we rotate it
+	if(event->button() == Qt::RightButton) {
+        this->rotate(90);
+    }
+    QGraphicsItem::mousePressEvent(event);
+}
+
+void ComponentItem::mouseReleaseEvent(QGraphicsSceneMouseEvent* event) {
+	// If we released mouse left button then update current state: disconnect and connect
+    if(event->button() == Qt::LeftButton && !connectedInPlace()) {
+        _component->disconnect();
+        connect();
+        MainWindow::getMainWindow()->rebuildAnalog();
+    }
+    QGraphicsItem::mouseReleaseEvent(event);
+}
+
+void ComponentItem::mouseMoveEvent(QGraphicsSceneMouseEvent* event) {
+    QGraphicsItem::mouseMoveEvent(event);
+}
+
+void ComponentItem::hoverEnterEvent(QGraphicsSceneHoverEvent* event) {
+    setSelected(true);
+
+	// Changing color to blue if we put mouse over the component
+    penForLines.setColor(QColor(8, 246, 242));
+    penForLinesWhite.setColor(QColor(8, 246, 242));
+
+	// Also printing out properties of the component
+	// Since we have 2 more windows except main one (for resistor and dc voltage) we have to find the main one,
+	// because only main window has label propertiesMessage
+
+	// DONT MAKE GLOBAL, it will crash!
+	MainWindow * mw = MainWindow::getMainWindow();
+	mw->propertiesMessage->setText(QString::fromStdString(_component->toString()));
+	update();
+
+	QGraphicsItem::hoverEnterEvent(event);
+}
+
+void ComponentItem::hoverLeaveEvent(QGraphicsSceneHoverEvent* event) {
+    setSelected(false);
+
+	// Changing color back to default if we are not over the component with mouse
+    penForLines.setColor(QColor(Qt::black));
+    penForLinesWhite.setColor(Qt::white);
+
+	// Setting label back to empty
+	// DONT MAKE GLOBAL, it will crash!
+	MainWindow * mw = MainWindow::getMainWindow();
+	mw->propertiesMessage->setText("");
+	update();
+
+	QGraphicsItem::hoverLeaveEvent(event);
+}
+
+QRectF ComponentItem::boundingRect() const {
+	// Representing bounding rectangle for each component, we need this for drawing
+    return QRectF(0, 0, _component->width(), _component->height());
+}
+
+void ComponentItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+    painter->drawRect(boundingRect());
+}
+
+
+//GroundItem
+GroundItem::GroundItem()
+    : TypedComponentItem<Ground>(new Ground())
+{}
+
+void GroundItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+    //ComponentItem::paint(painter, option, widget);
+
+    // Setting color for drawing lines
+    painter->setPen(penForLines);
+
+    // Vertical line
+    painter->drawLine(50, 60, 50, 0);
+
+    // Horizontal lines, one beneath other
+    painter->drawLine(20, 60, 80, 60);
+    painter->drawLine(30, 70, 70, 70);
+    painter->drawLine(40, 80, 60, 80);
+
+    // Connection points
+    painter->setPen(penForDots);
+	QPointF up(50, 1);
+    painter->drawPoint(up);
+}
+
+
+//WireItem
+WireItem::WireItem()
+    : TypedComponentItem<Wire>(new Wire())
+{}
+
+void WireItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+	Q_UNUSED(option);
+	Q_UNUSED(widget);
+	// ComponentItem::paint(painter, option, widget);
+
+	// Setting color for drawing lines depending on voltage
+	if(nodeVoltage(0) > 0 || nodeVoltage(1) > 0)
+		painter->setPen(penForLeadsGreen);
+	else if(nodeVoltage(0) < 0 || nodeVoltage(1) < 0)
+		painter->setPen(penForLeadsRed);
+	else
+		painter->setPen(penForLines);
+
+	// Start/End point of a wire
+	double width = component()->length();
+	painter->drawLine(QLineF(QPointF(0, 50), QPointF(width, 50)));
+
+	// Connection points
+	painter->setPen(penForDots);
+	QPointF p1(0.8, 50);
+	QPointF p2(width-0.8, 50);
+	painter->drawPoint(p1);
+	painter->drawPoint(p2);
+}
+
+void WireItem::setLength(double length) {
+    prepareGeometryChange();
+    component()->setLength(length);
+    update();
+}
+
+void WireItem::mouseDoubleClickEvent(QGraphicsSceneMouseEvent* event) {
+	// Double click on wire makes her longer
+    double width = component()->length();
+    double scaleNumber = 10;
+    if(event->button() == Qt::LeftButton) {
+        if (event->modifiers() == Qt::ControlModifier) {
+            if (width - scaleNumber >= 10)
+                setLength(width - scaleNumber);
+        } else setLength(width + scaleNumber);
+	}
+	QGraphicsItem::mouseDoubleClickEvent(event);
+}
+
+
+//ResistorItem
+ResistorItem::ResistorItem()
+    : TypedComponentItem<Resistor>(new Resistor())
+{}
+
+void ResistorItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+    //ComponentItem::paint(painter, option, widget);
+
+    // Setting color for drawing lines
+    painter->setPen(penForLines);
+
+    // Input line
+    painter->drawLine(0, 50, 18, 50);
+
+    // Zigzag lines
+    painter->drawLine(18, 50, 25, 30);
+    painter->drawLine(25, 30, 35, 65);
+    painter->drawLine(35, 65, 45, 30);
+    painter->drawLine(45, 30, 55, 65);
+    painter->drawLine(55, 65, 65, 30);
+    painter->drawLine(65, 30, 75, 65);
+    painter->drawLine(75, 65, 82, 50);
+
+    // Output line
+    painter->drawLine(82, 50, 100, 50);
+
+    painter->setFont(QFont("Times", 12, QFont::Bold));
+    painter->drawText(boundingRect(), Qt::AlignHCenter, QString::number(component()->resistance()) + " Ohm");
+
+    // Connection points
+    painter->setPen(penForDots);
+	QPointF p1(1, 50);
+	QPointF p2(99, 50);
+    painter->drawPoint(p1);
+    painter->drawPoint(p2);
+}
+
+void ResistorItem::mouseDoubleClickEvent(QGraphicsSceneMouseEvent* event) {
+	// If we double click on resistor new dialog for property changing pops out
+	if(event->button() == Qt::LeftButton) {
+		Dialog* dialog = new Dialog(this);
+        //dialog->setModal(false);
+        dialog->show();
+
+		update();
+	}
+	QGraphicsItem::mouseDoubleClickEvent(event);
+}
+
+
+//SwitchItem
+SwitchItem::SwitchItem()
+    : TypedComponentItem<Switch>(new Switch())
+{}
+
+void SwitchItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+    // ComponentItem::paint(painter, option, widget);
+
+    // Setting color for drawing lines
+    painter->setPen(penForLines);
+
+    // Open/Closed line
+    painter->setPen(penForLinesWhite);
+    if(component()->isOpened()) {
+        painter->drawLine(35, 50, 65, 30);
+    } else {
+        painter->drawLine(35, 47, 65, 47);
+    }
+
+	// Input line
+	if(nodeVoltage(0) > 0)
+		painter->setPen(penForLeadsGreen);
+	else if(nodeVoltage(0) < 0)
+		painter->setPen(penForLeadsRed);
+	else
+		painter->setPen(penForLines);
+
+	painter->drawLine(0, 50, 35, 50);
+
+	// Output line
+	if(nodeVoltage(1) > 0)
+		painter->setPen(penForLeadsGreen);
+	else if(nodeVoltage(1) < 0)
+		painter->setPen(penForLeadsRed);
+	else
+		painter->setPen(penForLines);
+
+	painter->drawLine(65, 50, 100, 50);
+
+    // Connection points
+    painter->setPen(penForDots);
+	QPointF p1(1, 50);
+	QPointF p2(99, 50);
+    painter->drawPoint(p1);
+    painter->drawPoint(p2);
+}
+
+void SwitchItem::mousePressEvent(QGraphicsSceneMouseEvent* event) {
+	// If we press on switch it changes state: open/close
+    ComponentItem::mousePressEvent(event);
+    if(event->button() == Qt::LeftButton) {
+        component()->changeState();
+        MainWindow::getMainWindow()->solveAnalog();
+        update();
+    }
+
+    QGraphicsItem::mousePressEvent(event);
+}
+
+
+//DCVoltageItem
+DCVoltageItem::DCVoltageItem()
+    : TypedComponentItem<DCVoltage>(new DCVoltage())
+{}
+
+DCVoltageItem::DCVoltageItem(DCVoltage* source)
+    : TypedComponentItem<DCVoltage>(source)
+{}
+
+void DCVoltageItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+    // ComponentItem::paint(painter, option, widget);
+
+    // Setting color for drawing lines
+    painter->setPen(penForLines);
+
+    // Vertical line
+    double voltage = component()->voltage();
+    if(voltage > 0)
+        painter->setPen(penForLeadsGreen);
+    else if(voltage < 0)
+        painter->setPen(penForLeadsRed);
+    else
+        painter->setPen(penForLines);
+    painter->drawLine(50, 0, 50, 40);
+
+    // Connection points
+    painter->setPen(penForDots);
+	QPointF p(50, 1);
+    painter->drawPoint(p);
+
+    painter->setPen(QPen(Qt::black));
+    painter->setFont(QFont("Times", 12, QFont::Bold));
+    painter->drawText(boundingRect(), Qt::AlignCenter, QString::number(voltage) + " V");
+}
+
+void DCVoltageItem::mouseDoubleClickEvent(QGraphicsSceneMouseEvent* event) {
+	// If we double click on dc voltage new dialog for property changing pops out
+	if(event->button() == Qt::LeftButton) {
+		Dialog* dialog = new Dialog(this);
+		dialog->show();
+
+		update();
+	}
+	QGraphicsItem::mouseDoubleClickEvent(event);
+}
+
+
+//ClockItem
+ClockItem::ClockItem(double voltage, int timeInterval)
+	: DCVoltageItem(new Clock(voltage, timeInterval))
+{}
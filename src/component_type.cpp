@@ -0,0 +1,98 @@
+#include "component_type.hpp"
+#include "log_component.hpp"
+#include "schematic.hpp"
+
+#include <algorithm>
+
+namespace {
+
+template <class T>
+Component* make(const ComponentRecord& record) {
+    (void)record;
+    return new T();
+}
+
+Component* makeClock(const ComponentRecord& record) {
+    return record.hasParameter ? new Clock(5, static_cast<int>(record.parameter)) : new Clock();
+}
+
+//Saved parameter is 'isOpened', switches start opened
+void loadSwitch(Component* component, const ComponentRecord& record) {
+    if (record.parameter == 0) static_cast<Switch*>(component)->close();
+}
+
+double saveSwitch(const Component& component) {
+    return static_cast<const Switch&>(component).isOpened() ? 1 : 0;
+}
+
+void loadVoltage(Component* component, const ComponentRecord& record) {
+    if (record.hasParameter) static_cast<DCVoltage*>(component)->setVoltage(record.parameter);
+}
+
+double saveVoltage(const Component& component) {
+    return component.voltage();
+}
+
+double saveClock(const Component& component) {
+    return static_cast<const Clock&>(component).timeInterval();
+}
+
+//Wire is rotated with default length before, so it is only stretched to saved length
+void loadWire(Component* component, const ComponentRecord& record) {
+    if (record.hasParameter) static_cast<Wire*>(component)->setLength(record.parameter);
+}
+
+double saveWire(const Component& component) {
+    return static_cast<const Wire&>(component).length();
+}
+
+void loadResistor(Component* component, const ComponentRecord& record) {
+    if (record.hasParameter) static_cast<Resistor*>(component)->setResistance(record.parameter);
+}
+
+double saveResistor(const Component& component) {
+    return static_cast<const Resistor&>(component).resistance();
+}
+
+}
+
+const std::vector<ComponentType>& ComponentTypes::all() {
+    //Same order as ComponentKind
+    static const std::vector<ComponentType> types = {
+        {ComponentKind::AND, "and", "AND", 3, make<ANDGate>, nullptr, nullptr},
+        {ComponentKind::NAND, "nand", "NAND", 3, make<NANDGate>, nullptr, nullptr},
+        {ComponentKind::OR, "or", "OR", 3, make<ORGate>, nullptr, nullptr},
+        {ComponentKind::NOR, "nor", "NOR", 3, make<NORGate>, nullptr, nullptr},
+        {ComponentKind::XOR, "xor", "XOR", 3, make<XORGate>, nullptr, nullptr},
+        {ComponentKind::NXOR, "nxor", "NXOR", 3, make<NXORGate>, nullptr, nullptr},
+        {ComponentKind::NOT, "not", "NOT", 2, make<NOTGate>, nullptr, nullptr},
+        {ComponentKind::LCD, "lcd", "LCD Display", 7, make<LCDDisplay>, nullptr, nullptr},
+        {ComponentKind::DECODER, "decoder", "Decoder", 11, make<Decoder>, nullptr, nullptr},
+        {ComponentKind::FLIPFLOP, "flipflop", "JK Flip Flop", 5, make<JKFlipFlop>, nullptr, nullptr},
+        {ComponentKind::SWITCH, "switch", "Switch", 2, make<Switch>, loadSwitch, saveSwitch},
+        {ComponentKind::GROUND, "ground", "Ground", 1, make<Ground>, nullptr, nullptr},
+        {ComponentKind::CLOCK, "clock", "Clock", 1, makeClock, nullptr, saveClock},
+        {ComponentKind::WIRE, "wire", "Wire", 2, make<Wire>, loadWire, saveWire},
+        {ComponentKind::VOLTAGE, "voltage", "DC Voltage", 1, make<DCVoltage>, loadVoltage, saveVoltage},
+        {ComponentKind::RESISTOR, "resistor", "Resistor", 2, make<Resistor>, loadResistor, saveResistor}
+    };
+    return types;
+}
+
+const ComponentType* ComponentTypes::find(const std::string& name) {
+    const auto& types = all();
+    auto it = std::find_if(types.begin(), types.end(),
+            [&name](const ComponentType& type) { return type.name == name; });
+    return it == types.end() ? nullptr : &*it;
+}
+
+Component* ComponentTypes::create(ComponentKind kind) {
+    return get(kind).create(ComponentRecord());
+}
+
+const ComponentType* ComponentTypes::findLabel(const std::string& label) {
+    const auto& types = all();
+    auto it = std::find_if(types.begin(), types.end(),
+            [&label](const ComponentType& type) { return type.label == label; });
+    return it == types.end() ? nullptr : &*it;
+}
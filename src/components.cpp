@@ -1,17 +1,32 @@
 #include "components.hpp"
+#include "compiled_logic.hpp"
 #include <iostream>
 #include <stdexcept>
-
-#ifdef QTPAINT
-#include "mainwindow.h" // for propertiesMessage
-#include "dialog.h"
-#include <QObject>
-#endif
+#include <cmath>
 
 template<typename T>
 int Counter<T>::_counter(0);
 
-std::set<std::shared_ptr<Node>, Node::lex_node_cmp> Node::_allNodes;
+//Nets are defined before nodes, so they are destroyed after all nodes
+std::vector<double> NetList::_voltage;
+std::vector<unsigned char> NetList::_level;
+std::vector<const Component*> NetList::_driver;
+std::vector<long long> NetList::_changed;
+std::vector<std::vector<Node*>> NetList::_nodes;
+std::vector<unsigned char> NetList::_dirty;
+std::vector<const Component*> NetList::_dirtySource;
+bool NetList::_watching = false;
+std::vector<unsigned char> NetList::_levelChanged;
+std::vector<int> NetList::_changedLevels;
+std::vector<unsigned> NetList::_pinStart;
+std::vector<NetList::Pin> NetList::_pins;
+unsigned long NetList::_pinVersion = static_cast<unsigned long>(-1);
+DisjointSet NetList::_sets;
+std::vector<int> NetList::_free;
+size_t NetList::_size = 0;
+unsigned long NetList::_version = 0;
+
+NodeRegistry Node::_allNodes;
 
 std::string Component::toString() const {
     std::stringstream stream;
@@ -36,7 +51,7 @@ std::ostream& operator<<(std::ostream& out, const Component& c) {
 std::ostream& operator<<(std::ostream& out, const Node& n) {
 	out << "*  Node " << n.id() << ":" << std::endl
 		<< "(" << n.x() << ", " << n.y() << ")" << std::endl
-		<< "V = " << n._v << " V" << std::endl
+		<< "V = " << n.v() << " V" << std::endl
 		<< "Connected components: " << std::endl;
 
 	for (const auto& c : n.components()) {
@@ -50,6 +65,36 @@ bool doubleEquals(double a, double b, double epsilon) {
     return std::abs(a - b) < epsilon;
 }
 
+//Transform
+void Transform::rotate(int angle, double cx, double cy) {
+    //Right angles are exact, so connection points don't move because of rounding
+    double c, s;
+    switch ((angle % 360 + 360) % 360) {
+    case 0: c = 1; s = 0; break;
+    case 90: c = 0; s = 1; break;
+    case 180: c = -1; s = 0; break;
+    case 270: c = 0; s = -1; break;
+    default:
+        double radians = angle * std::acos(-1.0) / 180;
+        c = std::cos(radians);
+        s = std::sin(radians);
+    }
+
+    //Rotation around center: translate center to origin, rotate, translate back
+    double rdx = cx - (cx*c - cy*s);
+    double rdy = cy - (cx*s + cy*c);
+
+    //Rotation is applied first, then old transformation
+    Transform t;
+    t.m11 = c*m11 + s*m21;
+    t.m12 = c*m12 + s*m22;
+    t.m21 = -s*m11 + c*m21;
+    t.m22 = -s*m12 + c*m22;
+    t.dx = rdx*m11 + rdy*m21 + dx;
+    t.dy = rdx*m12 + rdy*m22 + dy;
+    *this = t;
+}
+
 //Node
 Node::Node(int x, int y, Component* const component = nullptr)
 :_x(x), _y(y)
@@ -59,43 +104,60 @@ Node::Node(int x, int y, Component* const component = nullptr)
 	if (component != nullptr) _components.push_back(component);
 }
 
+std::shared_ptr<Node> Node::create(int x, int y, Component* const component) {
+    return std::allocate_shared<Node>(SlabAllocation<Node>(), x, y, component);
+}
+
+Node::~Node() {
+    NetList::remove(this);
+}
+
 int Node::x() const { return _x; }
 int Node::y() const { return _y; }
 
+double Node::v() const {
+    return _net < 0 ? 0 : NetList::voltage(_net);
+}
+
+void Node::setV(double v) {
+    if (_net >= 0) NetList::setVoltage(_net, v);
+}
+
+Logic::Value Node::level() const {
+    return _net < 0 ? Logic::floating() : NetList::level(_net);
+}
+
+int Node::net() const {
+    return _net < 0 ? -1 : NetList::find(_net);
+}
+
 void Node::addComponent(Component* const e){
     //Node don't need multiple connection to the same component
-    if (e != nullptr && !isConnectedTo(e))
+    if (e != nullptr && !isConnectedTo(e)) {
         _components.push_back(e);
+        NetList::touch();
+    }
 }
 
-std::vector<Component*> Node::directComponents() const{
+const std::vector<Component*>& Node::directComponents() const{
 	return _components;
 }
 
-template<typename T>
-void append(T& a, T& b) {
-    a.reserve(a.size() + b.size());
-    std::move(b.begin(), b.end(), std::inserter(a, a.end()));
-    b.clear();
-}
-
 std::vector<Component*> Node::components() const{
 	std::vector<Component*> allComponents;
-    allComponents.reserve(_components.size());
 
-    for (const auto& c : _components) {
-        if ( c->componentType() != "wire" ) {
-            allComponents.push_back(c);
-        } else {
-            //If it's wire, we need to recursively take components from another side of wire
-            auto otherNode = (static_cast<Wire*>(c))->otherNode(this->id());
-            //To prevent infinite recursion,
-            //disconnect node from component through which we came to that node
-            //but after recursion establish removed connection
-            otherNode->disconnectFromComponent(c);
-            auto otherComponnets = otherNode->components();
-            append(allComponents, otherComponnets);
-            otherNode->addComponent(c);
+    //Node which is not registered has no net, only its own components are connected
+    if (_net < 0) {
+        for (const auto& c : _components) {
+            if (c->kind() != ComponentKind::WIRE) allComponents.push_back(c);
+        }
+        return allComponents;
+    }
+
+    //Wires are already collapsed into net, so components are taken from all nodes in net
+    for (const auto node : NetList::nodes(_net)) {
+        for (const auto& c : node->_components) {
+            if (c->kind() != ComponentKind::WIRE) allComponents.push_back(c);
         }
     }
 
@@ -103,10 +165,17 @@ std::vector<Component*> Node::components() const{
 }
 
 std::vector<Component*> Node::directComponents(const std::string& componentType) const {
+    //Name is looked up once, components are compared by kind
+    const ComponentType* type = ComponentTypes::find(componentType);
+    if (type == nullptr) return std::vector<Component*>();
+    return directComponents(type->kind);
+}
+
+std::vector<Component*> Node::directComponents(ComponentKind kind) const {
 	std::vector<Component*> filterd;
 
 	for (auto const& component : _components) {
-		if (component->componentType() == componentType) {
+		if (component->kind() == kind) {
 			filterd.push_back(component);
 		}
 	}
@@ -115,10 +184,16 @@ std::vector<Component*> Node::directComponents(const std::string& componentType)
 }
 
 std::vector<Component*> Node::components(const std::string& componentType) const {
+    const ComponentType* type = ComponentTypes::find(componentType);
+    if (type == nullptr) return std::vector<Component*>();
+    return components(type->kind);
+}
+
+std::vector<Component*> Node::components(ComponentKind kind) const {
 	std::vector<Component*> filterd;
 
 	for (auto const& component : components()) {
-		if (component->componentType() == componentType) {
+		if (component->kind() == kind) {
 			filterd.push_back(component);
 		}
 	}
@@ -155,8 +230,8 @@ bool Node::isConnectedTo(Component* const e) {
     return find(e) != _components.end() ? true : false;
 }
 
-std::set<std::shared_ptr<Node>, Node::lex_node_cmp>::iterator Node::find(int x, int y) {
-    return _allNodes.find(std::make_shared<Node>(x, y));
+NodeRegistry::iterator Node::find(int x, int y) {
+    return _allNodes.find(x, y);
 }
 
 void Node::disconnectFromComponent(Component* const e) {
@@ -165,137 +240,23 @@ void Node::disconnectFromComponent(Component* const e) {
     auto it = find(e);
     if (it != _components.end()){
         _components.erase(it);
+        NetList::touch();
+
+        //Values which component drove don't count anymore
+        if (Logic::fourState() && _net >= 0 && NetList::resolve(_net)) {
+            Scheduler::scheduleNet(net());
+            Scheduler::run();
+        }
     }
 }
 
 //Component
 Component::Component(const std::string &name)
     :_name(name), _rotationAngle(0)
-{
-    _nodes.clear();
-    _nodes.reserve(3);
-
-#ifdef QTPAINT
-	// Components can accept hover actions
-    setAcceptHoverEvents(true);
-
-	// Setting some flags for components
-    setFlags(QGraphicsItem::ItemIsSelectable |
-            QGraphicsItem::ItemIsMovable |
-            QGraphicsItem::ItemSendsGeometryChanges);
-
-	// Creating different pens for drawing
-    penForLines = QPen(Qt::black, 3, Qt::SolidLine, Qt::RoundCap);
-    penForLinesWhite = QPen(Qt::white, 3, Qt::SolidLine, Qt::RoundCap);
-    penForDots = QPen(Qt::white, 6, Qt::SolidLine, Qt::RoundCap);
-    penForLeadsGreen = QPen(Qt::green, 3, Qt::SolidLine, Qt::RoundCap);
-    penForLeadsRed = QPen(Qt::red, 3, Qt::SolidLine, Qt::RoundCap);
-    penForDigit = QPen(Qt::darkRed, 5, Qt::SolidLine, Qt::RoundCap);
-#endif
-}
-
-#ifdef QTPAINT
-QVariant Component::itemChange(GraphicsItemChange change, const QVariant &value) {
-    if (change == ItemPositionChange && scene()) {
-        QPointF newPos = value.toPointF();
-
-        if(QApplication::mouseButtons() == Qt::LeftButton &&
-                qobject_cast<GridZone*> (scene())){
-
-            GridZone* customScene = qobject_cast<GridZone*> (scene());
-            int gridSize = customScene->getGridSize();
-            qreal xV = round(newPos.x()/gridSize)*gridSize;
-            qreal yV = round(newPos.y()/gridSize)*gridSize;
-            return QPointF(xV, yV);
-        }
-
-        else {
-            return newPos;
-        }
-    }
-
-    else {
-        return QGraphicsItem::itemChange(change, value);
-    }
-}
-
-void Component::mousePressEvent(QGraphicsSceneMouseEvent* event) {	
-	// If mouse right button is pressed over component we rotate it
-	if(event->button() == Qt::RightButton) {
-        //QPointF center = boundingRect().center();
-        //QTransform rotation = QTransform().translate(center.x(), center.y()).rotate(90).translate(-center.x(), -center.y());
-        //setTransform(rotation, true);
-
-        //disconnect();
-        //connect(connectionPoints());
-        //int angle = (this->rotationAngle() + 90) % 360;
-        //this->setRotationAngle(angle);
-        this->rotate(90);
-    }
-    QGraphicsItem::mousePressEvent(event);
-}
-
-void Component::mouseReleaseEvent(QGraphicsSceneMouseEvent* event) {
-	// If we released mouse left button then update current state: disconnect and connect
-    if(event->button() == Qt::LeftButton) {
-        disconnect();
-        connect(connectionPoints());
-    }
-    QGraphicsItem::mouseReleaseEvent(event);
-}
-
-void Component::mouseMoveEvent(QGraphicsSceneMouseEvent* event) {
-    QGraphicsItem::mouseMoveEvent(event);
-}
-
-void Component::hoverEnterEvent(QGraphicsSceneHoverEvent* event) {
-    setSelected(true);
-
-	// Changing color to blue if we put mouse over the component
-    penForLines.setColor(QColor(8, 246, 242));
-    penForLinesWhite.setColor(QColor(8, 246, 242));
-
-	// Also printing out properties of the component
-	// Since we have 2 more windows except main one (for resistor and dc voltage) we have to find the main one,
-	// because only main window has label propertiesMessage
-
-	// DONT MAKE GLOBAL, it will crash!
-	MainWindow * mw = MainWindow::getMainWindow();
-	mw->propertiesMessage->setText(QString::fromStdString(this->toString()));
-	update();
-
-	QGraphicsItem::hoverEnterEvent(event);
-}
-
-void Component::hoverLeaveEvent(QGraphicsSceneHoverEvent* event) {
-    setSelected(false);
-
-	// Changing color back to default if we are not over the component with mouse
-    penForLines.setColor(QColor(Qt::black));
-    penForLinesWhite.setColor(Qt::white);
-
-	// Setting label back to empty
-	// DONT MAKE GLOBAL, it will crash!
-	MainWindow * mw = MainWindow::getMainWindow();
-	mw->propertiesMessage->setText("");
-	update();
-
-	QGraphicsItem::hoverLeaveEvent(event);
-}
-
-QRectF Component::boundingRect() const {
-	// Representing bounding rectangle for each component, we need this for drawing and some functions such as componentPoints
-    return QRectF(0,0,100,100);
-}
-
-void Component::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
-    Q_UNUSED(option);
-    Q_UNUSED(widget);
-    painter->drawRect(boundingRect());
-}
-#endif
+{}
 
 Component::~Component() {
+    retire();
     disconnect();
     /*
     for (auto it = _nodes.begin(); it != _nodes.end(); ++it) {
@@ -323,22 +284,61 @@ int Component::rotationAngle() const {
 void Component::setRotationAngle(int angle){
     _rotationAngle = (_rotationAngle+angle) % 360;
 }
-#ifdef QTPAINT
+
 void Component::rotate(int angle){
-    QPointF center = boundingRect().center();
-    QTransform rotation = QTransform().translate(center.x(), center.y()).rotate(angle).translate(-center.x(), -center.y());
-    setTransform(rotation, true);
+    orient(angle);
 
     disconnect();
     connect(connectionPoints());
+}
+
+void Component::orient(int angle) {
+    _transform.rotate(angle, width()/2, height()/2);
     this->setRotationAngle(angle);
 }
-#endif
-std::vector<std::shared_ptr<Node>> Component::nodes() const {
+
+double Component::x() const {
+    return _x;
+}
+
+double Component::y() const {
+    return _y;
+}
+
+void Component::setPosition(double x, double y) {
+    _x = x;
+    _y = y;
+}
+
+const Transform& Component::transform() const {
+    return _transform;
+}
+
+std::vector<std::pair<int, int>> Component::connectionPoints() const {
+    auto local = localConnectionPoints();
+
+    std::vector<std::pair<int, int>> dots;
+    dots.reserve(local.size());
+    for (const auto& point : local) {
+        auto mapped = _transform.map(point.first, point.second);
+        dots.push_back(std::pair<int, int>(_x + mapped.first, _y + mapped.second));
+    }
+    return dots;
+}
+
+void Component::setObserver(ComponentObserver* observer) {
+    _observer = observer;
+}
+
+void Component::notifyObserver() const {
+    if (_observer != nullptr) _observer->componentChanged(*this);
+}
+
+const PinTable& Component::nodes() const {
 	return _nodes;
 }
 
-std::vector<std::shared_ptr<Node>>::iterator Component::find(int x, int y)  {
+PinTable::iterator Component::find(int x, int y)  {
     return std::find_if(_nodes.begin(), _nodes.end(),
             [x, y](const std::shared_ptr<Node>& node_ptr){
                     return node_ptr->x() == x && node_ptr->y() == y; });
@@ -351,16 +351,17 @@ bool Component::isConnectedTo(int x, int y) {
 }
 
 void Component::addNode(int x, int y) {
+    //Existing node is shared, new one is made only if there is no node on these coordinates
+    auto existing = Node::find(x, y);
+    if (existing != Node::_allNodes.end()) {
+        _nodes.push_back(*existing);
+        _nodes.back()->addComponent(this);
+        return;
+    }
 
-    auto new_node = std::make_shared<Node>(x, y, this);
-	_nodes.push_back(new_node);
-
-	auto res = Node::_allNodes.insert(new_node);
-    //node already exists
-	if (res.second == false) {
-		_nodes.back() = *res.first;
-		_nodes.back()->addComponent(this);
-	}
+    _nodes.push_back(Node::create(x, y, this));
+    Node::_allNodes.insert(_nodes.back());
+    NetList::create(_nodes.back().get());
 }
 
 void Component::connect(const std::vector<std::pair<int, int>> &connPts) {
@@ -381,7 +382,9 @@ void Component::disconnect(int x, int y) {
             //node doesn't point to component anymore
             (*it)->disconnectFromComponent(this);
 
-            //and component doesn't point to node
+            //and component doesn't point to node, changes scheduled for old pins are cancelled
+            removeDrive(static_cast<unsigned>(it - _nodes.begin()));
+            Delays::forget(this);
             it = _nodes.erase(it);
         } else {
             ++it;
@@ -401,6 +404,8 @@ void Component::disconnect() {
         //and component doesn't point to node
         it = _nodes.erase(it);
     }
+    _drives = ~uint32_t(0);
+    Delays::forget(this);
 }
 
 template <typename Iter>
@@ -416,6 +421,8 @@ void Component::disconnectAndPreserveEmptyPlace(Iter &it) {
 
         //and component doesn't point to node
         *it = nullptr;
+        setDrive(static_cast<unsigned>(it - _nodes.begin()), Logic::Z);
+        Delays::forget(this);
 }
 
 template <typename Iter>
@@ -423,14 +430,16 @@ void Component::addNodeAt(Iter &pos, int x, int y) {
     assert(pos != _nodes.end());
     assert(*pos == nullptr);
 
-    *pos = std::make_shared<Node>(x, y, this);
-
-    auto res = Node::_allNodes.insert((*pos));
-    //Node already exists
-    if (res.second == false) {
-        (*pos) = *res.first;
+    auto existing = Node::find(x, y);
+    if (existing != Node::_allNodes.end()) {
+        *pos = *existing;
         (*pos)->addComponent(this);
-	}
+        return;
+    }
+
+    *pos = Node::create(x, y, this);
+    Node::_allNodes.insert(*pos);
+    NetList::create(pos->get());
 }
 
 void Component::reconnect(int xFrom, int yFrom, int xTo, int yTo) {
@@ -455,59 +464,112 @@ void Component::reconnect(int xFrom, int yFrom, int xTo, int yTo) {
 }
 
 void Component::updateVoltages(const std::shared_ptr<Node>& node) const {
-    for (const auto& component : node->directComponents()) {
-        if (component != this) {
-            component->voltage();
-#ifdef QTPAINT
-            component->update();
-#endif
-        }
+    Scheduler::schedule(node, this);
+    Scheduler::run();
+}
+
+void Component::retire() {
+    _retired = true;
+    Delays::forget(this);
+    for (const auto& node : _nodes) {
+        if (node != nullptr && node->net() >= 0) NetList::forget(this, node->net());
     }
+    if (_block != nullptr) _block->remove(this);
 }
 
+void Component::driveNode(const std::shared_ptr<Node>& node, double v) const {
+    //Four-state nets take voltage from their resolved level, delayed changes keep only logical value
+    if (Logic::fourState() || delay().time > 0) {
+        driveNode(node, Logic::fromVoltage(v));
+        return;
+    }
 
-//Ground
-Ground::Ground()
-	:Component("GND" + std::to_string(_counter+1))
-{}
+    if (doubleEquals(node->v(), v)) return;
+    if (node->net() >= 0) NetList::setVoltage(node->net(), v, this);
+    updateVoltages(node);
+}
 
-#ifdef QTPAINT
-void Ground::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
-    Q_UNUSED(option);
-    Q_UNUSED(widget);
-    //Component::paint(painter, option, widget);
+void Component::driveNode(const std::shared_ptr<Node>& node, Logic::Value value) const {
+    Delay d = delay();
+    if (d.time > 0) {
+        for (unsigned pin = 0; pin < _nodes.size(); ++pin) {
+            if (_nodes[pin] == node) Delays::drive(this, pin, value, d);
+        }
+        return;
+    }
+    applyDrive(node, value);
+}
 
-    // Setting color for drawing lines
-    painter->setPen(penForLines);
+void Component::applyDrive(const std::shared_ptr<Node>& node, Logic::Value value) const {
+    if (!Logic::fourState()) {
+        double v = Logic::voltage(value);
+        if (doubleEquals(node->v(), v)) return;
+        if (node->net() >= 0) NetList::setVoltage(node->net(), v, this);
+        updateVoltages(node);
+        return;
+    }
 
-    // Vertical line
-    painter->drawLine(50, 60, 50, 0);
+    for (unsigned pin = 0; pin < _nodes.size(); ++pin) {
+        if (_nodes[pin] == node) setDrive(pin, value);
+    }
+    if (node->net() >= 0 && NetList::resolve(node->net(), this)) updateVoltages(node);
+}
 
-    // Horizontal lines, one beneath other
-    painter->drawLine(20, 60, 80, 60);
-    painter->drawLine(30, 70, 70, 70);
-    painter->drawLine(40, 80, 60, 80);
+void Component::setDelay(Delay delay) {
+    if (!Delays::delayable(kind())) {
+        throw std::invalid_argument("Error: " + componentType() + " can't have delay");
+    }
+    if (delay.time < 0) {
+        throw std::invalid_argument("Error: delay can't be negative");
+    }
+    _delay = delay.time;
+    _delayModel = delay.model;
+    //Compiled blocks take gate out if it has delay now
+    NetList::touch();
+}
 
-    // Connection points
-    painter->setPen(penForDots);
-	QPointF up(50, 1);
-    painter->drawPoint(up);
+void Component::clearDelay() {
+    _delay = -1;
+    NetList::touch();
 }
 
-std::vector<std::pair<int, int>> Ground::connectionPoints(void) const {
-    std::vector<std::pair<int, int>> dots;
+void Component::setDrive(unsigned pin, Logic::Value value) const {
+    if (pin >= MAX_DRIVEN_PINS) return;
+    _drives = (_drives & ~(uint32_t(3) << (2 * pin))) | uint32_t(value) << (2 * pin);
+}
 
-    // Find local coordinates of connection point
-    QPointF localPoint(boundingRect().x()+boundingRect().width()/2,
-                       boundingRect().y());
+void Component::removeDrive(unsigned pin) {
+    if (pin >= MAX_DRIVEN_PINS) return;
+    uint32_t below = pin == 0 ? 0 : _drives & (~uint32_t(0) >> (32 - 2 * pin));
+    uint32_t above = pin + 1 == MAX_DRIVEN_PINS ? 0 : _drives >> (2 * pin + 2) << (2 * pin);
+    //Last pin becomes Z
+    _drives = below | above | uint32_t(3) << (2 * (MAX_DRIVEN_PINS - 1));
+}
 
-    // And then map to scene coordinates
-    auto scenePoint = mapToScene(localPoint);
-    dots.push_back(std::pair<int, int>(scenePoint.x(), scenePoint.y()));
-    return dots;
+void Component::joinNodes() const {
+    if (_nodes.size() < 2) return;
+
+    for (size_t i = 1; i < _nodes.size(); ++i) {
+        NetList::merge(_nodes[0].get(), _nodes[i].get());
+    }
+    updateVoltages(_nodes[0]);
+}
+
+void Component::splitNet(int net) const {
+    if (net < 0) return;
+    NetList::split(net);
+    Scheduler::run();
 }
 
-#endif
+
+//Ground
+Ground::Ground()
+	:Component("GND" + std::to_string(_counter+1))
+{}
+
+std::vector<std::pair<double, double>> Ground::localConnectionPoints() const {
+    return {{width()/2, 0}};
+}
 
 double Ground::voltage() const {
 	return 0;
@@ -519,7 +581,8 @@ void Ground::addNode(int x, int y) {
     }
 
     Component::addNode(x, y);
-    _nodes.back()->_v = 0;
+    _nodes.back()->setV(0);
+    if (Logic::fourState() && NetList::resolve(_nodes.back()->net(), this)) updateVoltages(_nodes.back());
 }
 
 
@@ -527,135 +590,44 @@ void Ground::addNode(int x, int y) {
 //Wire
 Wire::Wire()
     :Component("W" + std::to_string(_counter+1)),
-      _leftV(0), _rightV(0),
-      _nodeVoltageChanged(-1)
-{
-#ifdef QTPAINT
-	// Default values for wire
-	changingBoundingRec = QRectF(0,0,100,100);
-	startWire = QPointF(0,50);
-	endWire = QPointF(100,50);
-#endif
-}
+    _length(100)
+{}
 
 Wire::~Wire() {
+    retire();
     disconnect();
 }
 
-#ifdef QTPAINT
-QRectF Wire::boundingRect() const {
-	// Wire must have her own changing bounding rectangle since it is different every time we make wire longer
-	return changingBoundingRec;
-}
-
-void Wire::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
-	Q_UNUSED(option);
-	Q_UNUSED(widget);
-	// Component::paint(painter, option, widget);
-
-	// Setting color for drawing lines depending on voltage
-	if(_nodes[0]->_v > 0 || _nodes[1]->_v > 0)
-		painter->setPen(penForLeadsGreen);
-	else if(_nodes[0]->_v < 0 || _nodes[1]->_v < 0)
-		painter->setPen(penForLeadsRed);
-	else
-		painter->setPen(penForLines);
-
-	line.setPoints(startWire, endWire);
-	painter->drawLine(line);
-
-	// Connection points
-	painter->setPen(penForDots);
-	QPointF p1(0.8, 50);
-	QPointF p2(changingBoundingRec.width()-0.8, 50);
-	painter->drawPoint(p1);
-	painter->drawPoint(p2);
+double Wire::width() const {
+    return _length;
 }
 
-std::vector<std::pair<int, int>> Wire::connectionPoints(void) const {
-    std::vector<std::pair<int, int>> dots;
-    dots.reserve(2);
-
-    // Find local coordinates of connection point
-    QPointF localPoint1(boundingRect().x(),
-                       boundingRect().y()+boundingRect().height()/2);
-
-    QPointF localPoint2(boundingRect().x()+boundingRect().width(),
-                       boundingRect().y()+boundingRect().height()/2);
-
-    // And then map to scene coordinates
-    auto scenePoint1 = mapToScene(localPoint1);
-    auto scenePoint2 = mapToScene(localPoint2);
-    dots.push_back(std::pair<int, int>(scenePoint1.x(), scenePoint1.y()));
-    dots.push_back(std::pair<int, int>(scenePoint2.x(), scenePoint2.y()));
-
-    return dots;
+double Wire::length() const {
+    return _length;
 }
 
-void Wire::setBoundingRect(double width) {
-    endWire.setX(width);
-    changingBoundingRec.setWidth(width);
-    update();
+void Wire::setLength(double length) {
+    _length = length;
 }
 
-void Wire::mouseDoubleClickEvent(QGraphicsSceneMouseEvent* event) {
-	// Double click on wire makes her longer
-    double width = changingBoundingRec.width();
-    double scaleNumber = 10;
-    if(event->button() == Qt::LeftButton) {
-        if (event->modifiers() == Qt::ControlModifier) {
-            if (width - scaleNumber >= 10)
-                setBoundingRect(width - scaleNumber);
-        } else setBoundingRect(width + scaleNumber);
-	}
-	QGraphicsItem::mouseDoubleClickEvent(event);
+std::vector<std::pair<double, double>> Wire::localConnectionPoints() const {
+    return {{0, height()/2}, {width(), height()/2}};
 }
 
-#endif
-
 std::shared_ptr<Node> Wire::otherNode(int id) const {
     return _nodes[0]->id() == id ? _nodes[1] : _nodes[0];
 }
 
 
+bool Wire::joinsNets() const {
+    return _nodes.size() == 2;
+}
+
 double Wire::voltage() const {
     if (_nodes.size() != 2) return 0;
 
-    //left node is changed
-    if (!doubleEquals(_leftV, _nodes[0]->_v)) {
-        //update old value
-        _leftV = _nodes[0]->_v;
-
-        //delegate to another node
-        _nodes[1]->_v = _leftV;
-        _rightV = _leftV;
-        _nodeVoltageChanged = 1;
-
-        //update other components
-        updateVoltages(_nodes[1]);
-    }
-    //right node is changed
-    if (!doubleEquals(_rightV, _nodes[1]->_v)) {
-        //update old value
-        _rightV = _nodes[1]->_v;
-
-        //delegate to another node
-        _nodes[0]->_v = _rightV;
-        _leftV = _rightV;
-        _nodeVoltageChanged = 0;
-
-        //update other components
-        updateVoltages(_nodes[0]);
-    }
-
-    //both nodes have the same voltage
-    return _nodes[0]->_v;
-}
-
-void Wire::connect(const std::vector<std::pair<int, int>> &connPts) {
-    Component::connect(connPts);
-    voltage();
-    //update();
+    //both nodes are in the same net, so they have the same voltage
+    return _nodes[0]->v();
 }
 
 void Wire::addNode(int x, int y) {
@@ -664,50 +636,29 @@ void Wire::addNode(int x, int y) {
     }
     //update();
     Component::addNode(x, y);
+    if (joinsNets()) joinNodes();
 }
 
 void Wire::disconnect(int x, int y) {
-    auto it = Node::find(x, y);
-    if (it == Node::_allNodes.end()) return;
-
-    if ((*it) == _nodes[0] && _nodeVoltageChanged == 0) {
-        (*it)->_v = 0;
-        _leftV = 0;
-        _nodeVoltageChanged = -1;
-        updateVoltages(_nodes[0]);
-    }
-    if ((*it) == _nodes[1] && _nodeVoltageChanged == 1) {
-        (*it)->_v = 0;
-        _rightV = 0;
-        _nodeVoltageChanged = -1;
-        updateVoltages(_nodes[1]);
-    }
-
+    int net = joinsNets() && isConnectedTo(x, y) ? _nodes[0]->net() : -1;
     Component::disconnect(x, y);
+    splitNet(net);
 }
 
 void Wire::disconnect() {
-    for (unsigned i = 0; i < _nodes.size() ; ++i) {
-        if (_nodeVoltageChanged == int(i)) {
-            _nodes[i]->_v = 0;
-            updateVoltages(_nodes[i]);
-        }
-    }
-    _leftV = 0;
-    _rightV = 0;
-    _nodeVoltageChanged = -1;
+    int net = joinsNets() ? _nodes[0]->net() : -1;
     //update();
     Component::disconnect();
+    splitNet(net);
 }
 
 //NOTE not used
 void Wire::reconnect(int xFrom, int yFrom, int xTo, int yTo) {
-    auto start = Node::find(xFrom, yFrom);
-    if (start != Node::_allNodes.end()) {
-        voltage();
-    }
+    int net = joinsNets() ? _nodes[0]->net() : -1;
     //update();
     Component::reconnect(xFrom, yFrom, xTo, yTo);
+    splitNet(net);
+    if (joinsNets()) joinNodes();
 }
 
 
@@ -717,89 +668,29 @@ Resistor::Resistor(double resistance)
 	:Component("R" + std::to_string(_counter+1)),
 	_resistance(resistance)
 {
-    if (_resistance <= 0) {
+    if (!(_resistance > 0)) {
         throw std::invalid_argument("Resistance must be positive");
     }
 }
 
-#ifdef QTPAINT
-void Resistor::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
-    Q_UNUSED(option);
-    Q_UNUSED(widget);
-    //Component::paint(painter, option, widget);
-
-    // Setting color for drawing lines
-    painter->setPen(penForLines);
-
-    // Input line
-    painter->drawLine(0, 50, 18, 50);
-
-    // Zigzag lines
-    painter->drawLine(18, 50, 25, 30);
-    painter->drawLine(25, 30, 35, 65);
-    painter->drawLine(35, 65, 45, 30);
-    painter->drawLine(45, 30, 55, 65);
-    painter->drawLine(55, 65, 65, 30);
-    painter->drawLine(65, 30, 75, 65);
-    painter->drawLine(75, 65, 82, 50);
-
-    // Output line
-    painter->drawLine(82, 50, 100, 50);
-
-    painter->setFont(QFont("Times", 12, QFont::Bold));
-    painter->drawText(boundingRect(), Qt::AlignHCenter, QString::number(_resistance) + " Ohm");
-
-    // Connection points
-    painter->setPen(penForDots);
-	QPointF p1(1, 50);
-	QPointF p2(99, 50);
-    painter->drawPoint(p1);
-    painter->drawPoint(p2);
+std::vector<std::pair<double, double>> Resistor::localConnectionPoints() const {
+    return {{0, height()/2}, {width(), height()/2}};
 }
 
-std::vector<std::pair<int, int>> Resistor::connectionPoints(void) const {
-    std::vector<std::pair<int, int>> dots;
-    dots.reserve(2);
-
-    // Find local coordinates of connection point
-    QPointF localPoint1(boundingRect().x(),
-                       boundingRect().y()+boundingRect().height()/2);
-
-    QPointF localPoint2(boundingRect().x()+boundingRect().width(),
-                       boundingRect().y()+boundingRect().height()/2);
-
-    // And then map to scene coordinates
-    auto scenePoint1 = mapToScene(localPoint1);
-    auto scenePoint2 = mapToScene(localPoint2);
-    dots.push_back(std::pair<int, int>(scenePoint1.x(), scenePoint1.y()));
-    dots.push_back(std::pair<int, int>(scenePoint2.x(), scenePoint2.y()));
-    return dots;
-}
-
-void Resistor::mouseDoubleClickEvent(QGraphicsSceneMouseEvent* event) {
-	// If we double click on resistor new dialog for property changing pops out
-	if(event->button() == Qt::LeftButton) {
-		Dialog* dialog = new Dialog(this);
-        //dialog->setModal(false);
-        dialog->show();
-
-		update();
-	}
-	QGraphicsItem::mouseDoubleClickEvent(event);
-}
-#endif
-
 double Resistor::resistance() const {
 	return _resistance;
 }
 
 void Resistor::setResistance(double resistance) {
+    if (!(resistance > 0)) {
+        throw std::invalid_argument("Resistance must be positive");
+    }
 	_resistance = resistance;
 }
 
 double Resistor::voltage() const {
     if (_nodes.size() != 2) return 0;
-	return _nodes[1]->_v - _nodes[0]->_v;
+	return _nodes[1]->v() - _nodes[0]->v();
 }
 
 double Resistor::current() const {
@@ -831,68 +722,21 @@ DCVoltage::DCVoltage(double voltage)
 {}
 
 DCVoltage::~DCVoltage() {
+    retire();
     disconnect();
 }
 
-#ifdef QTPAINT
-void DCVoltage::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
-    Q_UNUSED(option);
-    Q_UNUSED(widget);
-    // Component::paint(painter, option, widget);
-
-    // Setting color for drawing lines
-    painter->setPen(penForLines);
-
-    // Vertical line
-    if(voltage() > 0)
-        painter->setPen(penForLeadsGreen);
-    else if(voltage() < 0)
-        painter->setPen(penForLeadsRed);
-    else
-        painter->setPen(penForLines);
-    painter->drawLine(50, 0, 50, 40);
-
-    // Connection points
-    painter->setPen(penForDots);
-	QPointF p(50, 1);
-    painter->drawPoint(p);
-
-    painter->setPen(QPen(Qt::black));
-    painter->setFont(QFont("Times", 12, QFont::Bold));
-    painter->drawText(boundingRect(), Qt::AlignCenter, QString::number(_voltage) + " V");
-}
-
-std::vector<std::pair<int, int>> DCVoltage::connectionPoints(void) const {
-    std::vector<std::pair<int, int>> dots;
-
-    // Find local coordinates of connection point
-    QPointF localPoint(boundingRect().x()+boundingRect().width()/2,
-                       boundingRect().y());
-
-    // And then map to scene coordinates
-    auto scenePoint = mapToScene(localPoint);
-    dots.push_back(std::pair<int, int>(scenePoint.x(), scenePoint.y()));
-    return dots;
-}
-
-void DCVoltage::mouseDoubleClickEvent(QGraphicsSceneMouseEvent* event) {
-	// If we double click on dc voltage new dialog for property changing pops out
-	if(event->button() == Qt::LeftButton) {
-		Dialog* dialog = new Dialog(this);
-		dialog->show();
-
-		update();
-	}
-	QGraphicsItem::mouseDoubleClickEvent(event);
+std::vector<std::pair<double, double>> DCVoltage::localConnectionPoints() const {
+    return {{width()/2, 0}};
 }
-#endif
 
 void DCVoltage::addNode(int x, int y) {
     if (_nodes.size() >= 1) {
         throw std::runtime_error("DCVoltage already connected!");
     }
     Component::addNode(x, y);
-    _nodes.back()->_v = _voltage;
+    NetList::setVoltage(_nodes.back()->net(), _voltage, this);
+    if (Logic::fourState()) NetList::resolve(_nodes.back()->net(), this);
     updateVoltages(_nodes.back());
 }
 
@@ -900,11 +744,16 @@ double DCVoltage::voltage() const {
 	return _voltage;
 }
 
+void DCVoltage::evaluate() const {
+    if (_nodes.size() != 0) driveNode(_nodes.back(), _voltage);
+}
+
 void DCVoltage::setVoltage(double voltage) {
     _voltage = voltage;
     //if connected to node, set voltage in node
     if (_nodes.size() != 0) {
-        _nodes.back()->_v = voltage;
+        NetList::setVoltage(_nodes.back()->net(), voltage, this);
+        if (Logic::fourState()) NetList::resolve(_nodes.back()->net(), this);
         updateVoltages(_nodes.back());
     }
 }
@@ -952,14 +801,14 @@ void DCVoltage::disconnect(int x, int y) {
     auto it = Node::find(x, y);
     if (it == Node::_allNodes.end()) return;
 
-    (*it)->_v = 0;
+    (*it)->setV(0);
     updateVoltages((*it));
     Component::disconnect(x, y);
 }
 
 void DCVoltage::disconnect() {
     for (const auto& node : _nodes) {
-        node->_v = 0;
+        node->setV(0);
         updateVoltages(node);
     }
     Component::disconnect();
@@ -967,23 +816,22 @@ void DCVoltage::disconnect() {
 
 void DCVoltage::reconnect(int xFrom, int yFrom, int xTo, int yTo) {
     auto start = Node::find(xFrom, yFrom);
-    if (start != Node::_allNodes.end()) (*start)->_v = 0;
-    updateVoltages(*start);
+    if (start != Node::_allNodes.end()) {
+        (*start)->setV(0);
+        updateVoltages(*start);
+    }
     Component::reconnect(xFrom, yFrom, xTo, yTo);
 }
 
-#ifdef QTPAINT
 //Clock
 Clock::Clock(double voltage, int timeInterval)
 	: DCVoltage(voltage), _oldVoltage(voltage), _timeInterval(timeInterval)
 {
-	// Start timer
-	_timerId = startTimer(_timeInterval);
+    Timeline::schedule(this);
 }
 
 Clock::~Clock() {
-	// Kill timer
-	killTimer(_timerId);
+    Timeline::remove(this);
 }
 
 int Clock::timeInterval() const {
@@ -992,6 +840,7 @@ int Clock::timeInterval() const {
 
 void Clock::setTimeInterval(int timeInterval) {
 	_timeInterval = timeInterval;
+    Timeline::schedule(this);
 }
 double Clock::oldVoltage() const{
     return _oldVoltage;
@@ -1007,43 +856,23 @@ std::string Clock::toString() const {
     return str.str();
 }
 
-void Clock::mouseDoubleClickEvent(QGraphicsSceneMouseEvent* event) {
-	// If we double click on clock new dialog for property changing pops out
-
-	killTimer(_timerId);
-
-	if(event->button() == Qt::LeftButton) {
-		Dialog* dialog = new Dialog(this);
-		dialog->show();
-
-		// Start timer again with new _timeInterval value
-		_timerId = startTimer(_timeInterval);
-        update();
-    }
-    QGraphicsItem::mouseDoubleClickEvent(event);
-}
-
-void Clock::timerEvent(QTimerEvent *event) {
-    Q_UNUSED(event);
+void Clock::tick() {
 	if(voltage() == 0.0)
 		setVoltage(_oldVoltage);
 	else
 		setVoltage(0.0);
-	update();
 }
-#endif
 
 //Switch
 Switch::Switch(state s)
 :Component("S" + std::to_string(_counter+1)),
-    _state(s),
-    _leftV(0), _rightV(0),
-    _nodeVoltageChanged(-1)
+    _state(s)
 {
 
 }
 
 Switch::~Switch() {
+    retire();
     disconnect();
 }
 
@@ -1059,27 +888,42 @@ std::string Switch::toString() const {
     return str.str();
 }
 
+bool Switch::joinsNets() const {
+    return _state == CLOSE && _nodes.size() == 2;
+}
+
 void Switch::addNode(int x, int y) {
     if (_nodes.size() >= 2) {
         throw std::runtime_error("Switch already connected!");
     }
     Component::addNode(x, y);
+    if (joinsNets()) joinNodes();
 }
 
-void Switch::open() {
-    _state = OPEN;
+void Switch::disconnect(int x, int y) {
+    int net = joinsNets() && isConnectedTo(x, y) ? _nodes[LEFT]->net() : -1;
+    Component::disconnect(x, y);
+    splitNet(net);
+}
 
-    //Switch should be connected
-    if (_nodes.size() != 2 || _nodeVoltageChanged == -1) return;
+void Switch::disconnect() {
+    int net = joinsNets() ? _nodes[LEFT]->net() : -1;
+    Component::disconnect();
+    splitNet(net);
+}
 
-    if (_nodeVoltageChanged == LEFT) {
-        _leftV = _nodes[LEFT]->_v = 0;
-        updateVoltages(_nodes[LEFT]);
-    }
-    else if (_nodeVoltageChanged == RIGHT) {
-        _rightV = _nodes[RIGHT]->_v = 0;
-        updateVoltages(_nodes[RIGHT]);
-    }
+void Switch::reconnect(int xFrom, int yFrom, int xTo, int yTo) {
+    int net = joinsNets() ? _nodes[LEFT]->net() : -1;
+    Component::reconnect(xFrom, yFrom, xTo, yTo);
+    splitNet(net);
+    if (joinsNets()) joinNodes();
+}
+
+void Switch::open() {
+    //Switch should be connected and closed
+    int net = joinsNets() ? _nodes[LEFT]->net() : -1;
+    _state = OPEN;
+    splitNet(net);
 }
 
 bool Switch::isOpened() const {
@@ -1087,8 +931,9 @@ bool Switch::isOpened() const {
 }
 
 void Switch::close() {
+    if (_state == CLOSE) return;
     _state = CLOSE;
-    voltage();
+    if (joinsNets()) joinNodes();
 }
 
 bool Switch::isClosed() const {
@@ -1101,138 +946,13 @@ void Switch::changeState() {
 }
 
 double Switch::voltage() const {
-    if (_nodes.size() != 2) return 0;
-    if (_state == OPEN) {
-        //if voltage on node is disconnected
-        _leftV = doubleEquals(_nodes[LEFT]->_v, .0) ? _nodes[LEFT]->_v : _leftV;
-        _rightV = doubleEquals(_nodes[RIGHT]->_v, .0) ? _nodes[RIGHT]->_v : _rightV;
-        return 0;
-    }
-
-    //left node is changed from outside
-    //delegate to another side
-    if (!doubleEquals(_leftV, _nodes[LEFT]->_v)) {
-        //update old value
-        _leftV = _nodes[LEFT]->_v;
-
-        //delegate voltage to another node
-        _nodes[RIGHT]->_v = _leftV;
-        _rightV = _leftV;
-        _nodeVoltageChanged = RIGHT;
-
-        //update other components
-        updateVoltages(_nodes[RIGHT]);
-    }
-    //left node is changed from "inside" -> with opening switch
-    //take voltage from another node
-    else if (_nodeVoltageChanged == LEFT) {
-        _nodes[LEFT]->_v = _rightV;
-        _leftV = _rightV;
-
-        //update other components
-        updateVoltages(_nodes[LEFT]);
-    }
-    //right node is changed from outside
-    //delegate to another side
-    if (!doubleEquals(_rightV, _nodes[RIGHT]->_v)) {
-        //update old value
-        _rightV = _nodes[RIGHT]->_v;
-
-        //delegate to another node
-        _nodes[LEFT]->_v = _rightV;
-        _leftV = _rightV;
-        _nodeVoltageChanged = LEFT;
-
-        //update other components
-        updateVoltages(_nodes[LEFT]);
-    }
-    //right node is changed from "inside" -> with opening switch
-    //take voltage from another node
-    else if(_nodeVoltageChanged == RIGHT) {
-        //take from another node
-        _nodes[RIGHT]->_v = _leftV;
-        _rightV = _leftV;
-
-        //update other components
-        updateVoltages(_nodes[RIGHT]);
-    }
-
-    return _nodes[LEFT]->_v;
-}
-
-#ifdef QTPAINT
-void Switch::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
-    Q_UNUSED(option);
-    Q_UNUSED(widget);
-    // Component::paint(painter, option, widget);
-
-    // Setting color for drawing lines
-    painter->setPen(penForLines);
-
-    // Open/Closed line
-    painter->setPen(penForLinesWhite);
-    if(this->_state == OPEN) {
-        painter->drawLine(35, 50, 65, 30);
-    } else {
-        painter->drawLine(35, 47, 65, 47);
-    }
-
-	// Input line
-	if(_nodes[0]->_v > 0)
-		painter->setPen(penForLeadsGreen);
-	else if(_nodes[0]->_v < 0)
-		painter->setPen(penForLeadsRed);
-	else
-		painter->setPen(penForLines);
-
-	painter->drawLine(0, 50, 35, 50);
-
-	// Output line
-	if(_nodes[1]->_v > 0)
-		painter->setPen(penForLeadsGreen);
-	else if(_nodes[1]->_v < 0)
-		painter->setPen(penForLeadsRed);
-	else
-		painter->setPen(penForLines);
-
-	painter->drawLine(65, 50, 100, 50);
+    if (_nodes.size() != 2 || _state == OPEN) return 0;
 
-    // Connection points
-    painter->setPen(penForDots);
-	QPointF p1(1, 50);
-	QPointF p2(99, 50);
-    painter->drawPoint(p1);
-    painter->drawPoint(p2);
+    //both nodes are in the same net
+    return _nodes[LEFT]->v();
 }
 
-std::vector<std::pair<int, int>> Switch::connectionPoints(void) const{
-    std::vector<std::pair<int, int>> dots;
-    dots.reserve(2);
-
-    // Find local coordinates of connection point
-    QPointF localPoint1(boundingRect().x(),
-                       boundingRect().y()+boundingRect().height()/2);
-
-    QPointF localPoint2(boundingRect().x()+boundingRect().width(),
-                       boundingRect().y()+boundingRect().height()/2);
-
-    // And then map to scene coordinates
-    auto scenePoint1 = mapToScene(localPoint1);
-    auto scenePoint2 = mapToScene(localPoint2);
-    dots.push_back(std::pair<int, int>(scenePoint1.x(), scenePoint1.y()));
-    dots.push_back(std::pair<int, int>(scenePoint2.x(), scenePoint2.y()));
-    return dots;
+std::vector<std::pair<double, double>> Switch::localConnectionPoints() const {
+    return {{0, height()/2}, {width(), height()/2}};
 }
 
-void Switch::mousePressEvent(QGraphicsSceneMouseEvent* event) {
-	// If we press on switch it changes state: open/close
-    Component::mousePressEvent(event);
-    if(event->button() == Qt::LeftButton) {
-        this->changeState();
-        update();
-    }
-
-    QGraphicsItem::mousePressEvent(event);
-}
-#endif
-
@@ -0,0 +1,69 @@
+#include "delay.hpp"
+#include "components.hpp"
+
+#include <stdexcept>
+
+Delay Delays::_defaults[COMPONENT_KINDS];
+TimingWheel<Delays::Change> Delays::_wheel;
+std::unordered_map<const Component*, std::vector<Delays::PinState>> Delays::_pins;
+unsigned long long Delays::_nextId = 0;
+
+void Delays::set(ComponentKind kind, Delay delay) {
+    if (!delayable(kind)) {
+        throw std::invalid_argument("Error: " + ComponentTypes::get(kind).name + " can't have delay");
+    }
+    if (delay.time < 0) {
+        throw std::invalid_argument("Error: delay can't be negative");
+    }
+    _defaults[static_cast<size_t>(kind)] = delay;
+    //Compiled blocks are built again without gates which have delay
+    NetList::touch();
+}
+
+void Delays::setAll(Delay delay) {
+    for (const auto& type : ComponentTypes::all()) {
+        if (delayable(type.kind)) set(type.kind, delay);
+    }
+}
+
+void Delays::drive(const Component* component, unsigned pin, Logic::Value value, Delay delay) {
+    //Pins which are new (or component which is new at address of destroyed one) don't accept older changes
+    auto& states = _pins[component];
+    if (states.size() <= pin) {
+        states.resize(component->nodes().size() > pin ? component->nodes().size() : pin + 1,
+                      PinState{_nextId + 1, 0, Logic::Z});
+    }
+    PinState& state = states[pin];
+
+    Logic::Value current = Logic::fourState() ? component->drive(pin) : component->nodes()[pin]->level();
+    if (delay.model == DelayModel::INERTIAL) {
+        //Change which didn't happen yet is cancelled, so pulse shorter than delay doesn't get to output
+        state.validFrom = _nextId + 1;
+        state.pending = 0;
+        if (value == current) return;
+    } else if (value == (state.pending > 0 ? state.projected : current)) {
+        return;
+    }
+
+    _wheel.insert(Change{Timeline::now() + delay.time, ++_nextId, component, pin, value});
+    ++state.pending;
+    state.projected = value;
+}
+
+void Delays::applyNext() {
+    std::vector<Change> due;
+    _wheel.takeNext(due);
+
+    for (const Change& change : due) {
+        auto it = _pins.find(change.component);
+        if (it == _pins.end() || change.id < it->second[change.pin].validFrom) continue;
+
+        --it->second[change.pin].pending;
+        change.component->applyDrive(change.component->nodes()[change.pin], change.value);
+    }
+}
+
+void Delays::clear(long long now) {
+    _wheel.clear(now);
+    _pins.clear();
+}
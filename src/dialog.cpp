@@ -1,14 +1,15 @@
 #include "dialog.h"
+#include "mainwindow.h"
 #include <QVBoxLayout>
 #include <QDebug>
 
 Dialog::~Dialog() {}
 
-Dialog::Dialog(Component* component, QWidget* parent)
-	: QDialog (parent), component(component)
+Dialog::Dialog(ComponentItem* item, QWidget* parent)
+	: QDialog (parent), item(item), component(item->component())
 {
 	// Making dialog for resistor
-	if(component->componentType()=="resistor") {
+	if(component->kind() == ComponentKind::RESISTOR) {
 		nameLabel = new QLabel(tr("Resistance:"));
 		setWindowTitle(tr("Resistor edit"));
 		r = dynamic_cast<Resistor*>(component);
@@ -16,7 +17,7 @@ Dialog::Dialog(Component* component, QWidget* parent)
 	}
 
 	// Making dialog for dc voltage
-	else if(component->componentType() == "voltage") {
+	else if(component->kind() == ComponentKind::VOLTAGE) {
 		nameLabel = new QLabel(tr("Voltage:"));
 		setWindowTitle(tr("DC Voltage edit"));
 		v = dynamic_cast<DCVoltage*>(component);
@@ -24,7 +25,7 @@ Dialog::Dialog(Component* component, QWidget* parent)
 	}
 
 	// Making dialog for clock
-	else if(component->componentType() == "clock") {
+	else if(component->kind() == ComponentKind::CLOCK) {
 		nameLabel = new QLabel(tr("Clock:"));
 		setWindowTitle(tr("Clock's time interval edit"));
 		cl = dynamic_cast<Clock*>(component);
@@ -98,7 +99,8 @@ void Dialog::onOkButtonInDialog() {
 			applyHappened = true;
 			oldResistanceValue = r->resistance();
 			r->setResistance(newResistanceValue);
-            r->update();
+			MainWindow::getMainWindow()->solveAnalog();
+            item->update();
 			this->close();
 		}
 
@@ -106,7 +108,8 @@ void Dialog::onOkButtonInDialog() {
 		applyHappened = true;
 		oldVoltageValue = v->voltage();
 		v->setVoltage(this->lineEdit->text().toDouble());
-        v->update();
+		MainWindow::getMainWindow()->solveAnalog();
+        item->update();
 		this->close();
 	}
 
@@ -121,7 +124,7 @@ void Dialog::onOkButtonInDialog() {
 			applyHappened = true;
 			oldTimeIntervalValue = cl->timeInterval();
 			cl->setTimeInterval(newTimeIntervalValue);
-			cl->update();
+			item->update();
 			this->close();
 		}
 	}
@@ -143,6 +146,8 @@ void Dialog::onCancelButtonInDialog() {
 		v->setVoltage(oldVoltageValue);
 	else if(isClock)
 		cl->setTimeInterval(oldTimeIntervalValue);
+	if(isResistor || isDCVoltage)
+		MainWindow::getMainWindow()->solveAnalog();
 
 	this->close();
 }
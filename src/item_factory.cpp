@@ -0,0 +1,41 @@
+#include "item_factory.h"
+#include "log_component_item.h"
+
+namespace {
+
+typedef ComponentItem* (*Factory)(const ComponentRecord& record);
+
+template <class T>
+ComponentItem* make(const ComponentRecord& record) {
+    Q_UNUSED(record);
+    return new T();
+}
+
+ComponentItem* makeClock(const ComponentRecord& record) {
+    return record.hasParameter ? new ClockItem(5, static_cast<int>(record.parameter)) : new ClockItem();
+}
+
+}
+
+ComponentItem* ItemFactory::create(ComponentKind kind, const ComponentRecord& record) {
+    //Indexed by kind, in the same order as ComponentKind
+    static const Factory factories[] = {
+        make<ANDGateItem>, make<NANDGateItem>, make<ORGateItem>, make<NORGateItem>,
+        make<XORGateItem>, make<NXORGateItem>, make<NOTGateItem>, make<LCDDisplayItem>,
+        make<DecoderItem>, make<JKFlipFlopItem>, make<SwitchItem>, make<GroundItem>,
+        makeClock, make<WireItem>, make<DCVoltageItem>, make<ResistorItem>
+    };
+    static_assert(sizeof(factories) / sizeof(factories[0]) == COMPONENT_KINDS, "every kind of component needs item factory");
+    return factories[static_cast<size_t>(kind)](record);
+}
+
+const std::vector<ComponentKind>& ItemFactory::palette() {
+    static const std::vector<ComponentKind> kinds = {
+        ComponentKind::WIRE, ComponentKind::RESISTOR, ComponentKind::GROUND,
+        ComponentKind::VOLTAGE, ComponentKind::CLOCK, ComponentKind::SWITCH,
+        ComponentKind::AND, ComponentKind::OR, ComponentKind::XOR,
+        ComponentKind::NAND, ComponentKind::NOR, ComponentKind::NXOR, ComponentKind::NOT,
+        ComponentKind::FLIPFLOP, ComponentKind::DECODER, ComponentKind::LCD
+    };
+    return kinds;
+}
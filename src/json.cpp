@@ -0,0 +1,136 @@
+#include "json.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+void JsonReader::error(const std::string& message) const {
+    throw std::runtime_error("JSON error at position " + std::to_string(_pos - _begin) + ": " + message);
+}
+
+char JsonReader::peek() {
+    skipSpaces();
+    if (_pos == _end) error("unexpected end of text");
+    return *_pos;
+}
+
+bool JsonReader::accept(char c) {
+    skipSpaces();
+    if (_pos == _end || *_pos != c) return false;
+    ++_pos;
+    return true;
+}
+
+void JsonReader::expect(char c) {
+    if (peek() != c) error(std::string("expected '") + c + "'");
+    ++_pos;
+}
+
+void JsonReader::expectEnd() {
+    skipSpaces();
+    if (_pos != _end) error("unexpected character after document");
+}
+
+void JsonReader::expectWord(const char* word) {
+    for (const char* w = word; *w != '\0'; ++w, ++_pos) {
+        if (_pos == _end || *_pos != *w) error(std::string("expected ") + word);
+    }
+}
+
+bool JsonReader::readBool() {
+    if (peek() == 't') {
+        expectWord("true");
+        return true;
+    }
+    expectWord("false");
+    return false;
+}
+
+void JsonReader::readNull() {
+    peek();
+    expectWord("null");
+}
+
+double JsonReader::readNumber() {
+    peek();
+    //Text may not end with '\0', so number is copied before conversion
+    char buffer[64];
+    size_t length = 0;
+    while (_pos + length != _end && length + 1 < sizeof(buffer) &&
+           _pos[length] != '\0' && std::strchr("+-.0123456789eE", _pos[length]) != nullptr) {
+        buffer[length] = _pos[length];
+        ++length;
+    }
+    buffer[length] = '\0';
+
+    char* end;
+    double number = std::strtod(buffer, &end);
+    if (end == buffer) error("invalid number");
+    _pos += end - buffer;
+    return number;
+}
+
+//Schematic files have only ASCII names, so \u escapes are kept only for ASCII characters
+std::string JsonReader::readString() {
+    expect('"');
+    std::string result;
+    while (true) {
+        if (_pos == _end) error("unterminated string");
+        char c = *_pos++;
+        if (c == '"') return result;
+        if (c != '\\') {
+            result += c;
+            continue;
+        }
+
+        if (_pos == _end) error("unterminated string");
+        c = *_pos++;
+        switch (c) {
+        case 'n': result += '\n'; break;
+        case 't': result += '\t'; break;
+        case 'r': result += '\r'; break;
+        case 'b': result += '\b'; break;
+        case 'f': result += '\f'; break;
+        case 'u': {
+            if (_end - _pos < 4) error("invalid escape");
+            int code = std::strtol(std::string(_pos, 4).c_str(), nullptr, 16);
+            _pos += 4;
+            result += code < 128 ? static_cast<char>(code) : '?';
+            break;
+        }
+        default: result += c;
+        }
+    }
+}
+
+void JsonReader::skipValue() {
+    char c = peek();
+    if (c == '{') {
+        ++_pos;
+        if (accept('}')) return;
+        do {
+            if (peek() != '"') error("expected member name");
+            readString();
+            expect(':');
+            skipValue();
+        } while (accept(','));
+        expect('}');
+    } else if (c == '[') {
+        ++_pos;
+        if (accept(']')) return;
+        do {
+            skipValue();
+        } while (accept(','));
+        expect(']');
+    } else if (c == '"') {
+        readString();
+    } else if (c == 't' || c == 'f') {
+        readBool();
+    } else if (c == 'n') {
+        readNull();
+    } else if (c == '-' || (c >= '0' && c <= '9')) {
+        readNumber();
+    } else {
+        error(std::string("unexpected character '") + c + "'");
+    }
+}
@@ -1,9 +1,5 @@
 #include "log_component.hpp"
 
-#ifdef QTPAINT
-#include <QFontMetrics>
-#endif
-
 template <typename T>
 int Counter<T>::_counter(0);
 LogicGate::LogicGate(const std::string &name)
@@ -11,6 +7,7 @@ LogicGate::LogicGate(const std::string &name)
 {}
 
 LogicGate::~LogicGate() {
+    retire();
     disconnect();
 }
 
@@ -19,7 +16,7 @@ void LogicGate::disconnect(int x, int y) {
     if (it == Node::_allNodes.end()) return;
 
     //Remove possible voltage on output node
-    if (_nodes.size() == 3 && (*it) == _nodes[2]) (*it)->_v = 0;
+    if (_nodes.size() == 3 && (*it) == _nodes[2]) (*it)->setV(0);
     updateVoltages((*it));
     Component::disconnect(x, y);
 }
@@ -29,12 +26,16 @@ void LogicGate::disconnect() {
         reconnect(_nodes[0]->x(), _nodes[0]->y(), 1000, 1000);
         reconnect(_nodes[1]->x(), _nodes[1]->y(), 1001, 1001);
         //Remove possible voltage on output node
-        _nodes[2]->_v = 0;
+        _nodes[2]->setV(0);
         updateVoltages(_nodes[2]);
     }
     Component::disconnect();
 }
 
+bool LogicGate::isInput(unsigned pin) const {
+    return pin + 1 < _nodes.size();
+}
+
 bool LogicGate::getBoolVoltage(double v){
     if(v >= 2.5){
         return true;
@@ -46,7 +47,13 @@ bool LogicGate::getBoolVoltage(double v){
 
 void LogicGate::connect(const std::vector<std::pair<int, int>>& connPts) {
     Component::connect(connPts);
-    voltage();
+    //During batch edit inputs aren't settled yet, gate is evaluated once when scheduler runs
+    if (Scheduler::isHeld()) {
+        if (!_nodes.empty()) Scheduler::schedule(_nodes[0]);
+    }
+    else {
+        voltage();
+    }
 }
 
 std::string LogicGate::toString() const {
@@ -54,9 +61,9 @@ std::string LogicGate::toString() const {
     str << name() << std::endl;
 
     str << std::fixed << std::setprecision(2);
-    str << "in1: " << _nodes[0]->_v << " V" << std::endl;
-    str << "in2: " << _nodes[1]->_v << " V" << std::endl;
-    str << "out: " << _nodes[2]->_v << " V" << std::endl;
+    str << "in1: " << _nodes[0]->v() << " V" << std::endl;
+    str << "in2: " << _nodes[1]->v() << " V" << std::endl;
+    str << "out: " << _nodes[2]->v() << " V" << std::endl;
     return str.str();
 }
 
@@ -68,11 +75,10 @@ ANDGate::ANDGate()
 double ANDGate::voltage() const {
     if (_nodes.size() != 3) return 0;
 
-    bool a = LogicGate::getBoolVoltage(_nodes[0]->_v);
-    bool b = LogicGate::getBoolVoltage(_nodes[1]->_v);
-    _nodes[2]->_v = (a && b ? 5.0 : 0.0);
-    updateVoltages(_nodes[2]);
-    return _nodes[2]->_v;
+    Logic::Value a = _nodes[0]->level();
+    Logic::Value b = _nodes[1]->level();
+    driveNode(_nodes[2], Logic::andOf(a, b));
+    return _nodes[2]->v();
 }
 
 
@@ -84,11 +90,10 @@ ORGate::ORGate()
 double ORGate::voltage() const {
     if (_nodes.size() != 3) return 0;
 
-    bool a = LogicGate::getBoolVoltage(_nodes[0]->_v);
-    bool b = LogicGate::getBoolVoltage(_nodes[1]->_v);
-    _nodes[2]->_v = (a || b ? 5.0 : 0.0);
-    updateVoltages(_nodes[2]);
-    return _nodes[2]->_v;
+    Logic::Value a = _nodes[0]->level();
+    Logic::Value b = _nodes[1]->level();
+    driveNode(_nodes[2], Logic::orOf(a, b));
+    return _nodes[2]->v();
 }
 
 
@@ -99,11 +104,10 @@ XORGate::XORGate()
 double XORGate::voltage() const {
     if (_nodes.size() != 3) return 0;
 
-    bool a = LogicGate::getBoolVoltage(_nodes[0]->_v);
-    bool b = LogicGate::getBoolVoltage(_nodes[1]->_v);
-    _nodes[2]->_v = (a == b ? 0.0 : 5.0);
-    updateVoltages(_nodes[2]);
-    return _nodes[2]->_v;
+    Logic::Value a = _nodes[0]->level();
+    Logic::Value b = _nodes[1]->level();
+    driveNode(_nodes[2], Logic::xorOf(a, b));
+    return _nodes[2]->v();
 }
 
 
@@ -114,11 +118,10 @@ NORGate::NORGate()
 double NORGate::voltage() const {
     if (_nodes.size() != 3) return 0;
 
-    bool a = LogicGate::getBoolVoltage(_nodes[0]->_v);
-    bool b = LogicGate::getBoolVoltage(_nodes[1]->_v);
-    _nodes[2]->_v = (a || b ? 0.0 : 5.0);
-    updateVoltages(_nodes[2]);
-    return _nodes[2]->_v;
+    Logic::Value a = _nodes[0]->level();
+    Logic::Value b = _nodes[1]->level();
+    driveNode(_nodes[2], Logic::notOf(Logic::orOf(a, b)));
+    return _nodes[2]->v();
 }
 
 
@@ -129,11 +132,10 @@ NANDGate::NANDGate()
 double NANDGate::voltage() const {
     if (_nodes.size() != 3) return 0;
 
-    bool a = LogicGate::getBoolVoltage(_nodes[0]->_v);
-    bool b = LogicGate::getBoolVoltage(_nodes[1]->_v);
-    _nodes[2]->_v = (a && b ? 0.0 : 5.0);
-    updateVoltages(_nodes[2]);
-    return _nodes[2]->_v;
+    Logic::Value a = _nodes[0]->level();
+    Logic::Value b = _nodes[1]->level();
+    driveNode(_nodes[2], Logic::notOf(Logic::andOf(a, b)));
+    return _nodes[2]->v();
 }
 
 
@@ -144,11 +146,10 @@ NXORGate::NXORGate()
 double NXORGate::voltage() const {
     if (_nodes.size() != 3) return 0;
 
-    bool a = LogicGate::getBoolVoltage(_nodes[0]->_v);
-    bool b = LogicGate::getBoolVoltage(_nodes[1]->_v);
-    _nodes[2]->_v = (a == b ? 5.0 : 0.0);
-    updateVoltages(_nodes[2]);
-    return _nodes[2]->_v;
+    Logic::Value a = _nodes[0]->level();
+    Logic::Value b = _nodes[1]->level();
+    driveNode(_nodes[2], Logic::notOf(Logic::xorOf(a, b)));
+    return _nodes[2]->v();
 }
 
 
@@ -157,16 +158,15 @@ NOTGate::NOTGate()
     {}
 
 NOTGate::~NOTGate() {
+    retire();
     disconnect();
 }
 
 double NOTGate::voltage() const {
     if (_nodes.size() != 2) return 0;
 
-    bool in = LogicGate::getBoolVoltage(_nodes[0]->_v);
-    _nodes[1]->_v = (in ? 0.0 : 5.0);
-    updateVoltages(_nodes[1]);
-    return _nodes[1]->_v;
+    driveNode(_nodes[1], Logic::notOf(_nodes[0]->level()));
+    return _nodes[1]->v();
 }
 
 
@@ -175,7 +175,7 @@ void NOTGate::disconnect(int x, int y) {
     if (it == Node::_allNodes.end()) return;
 
     //Remove possible voltage on output node
-    if (_nodes.size() == 2 && (*it) == _nodes[1]) (*it)->_v = 0;
+    if (_nodes.size() == 2 && (*it) == _nodes[1]) (*it)->setV(0);
     updateVoltages((*it));
     Component::disconnect(x, y);
 }
@@ -183,7 +183,7 @@ void NOTGate::disconnect(int x, int y) {
 void NOTGate::disconnect() {
     if (_nodes.size() == 2) {
         //Remove possible voltage on output node
-        _nodes.back()->_v = 0;
+        _nodes.back()->setV(0);
         updateVoltages(_nodes.back());
     }
     Component::disconnect();
@@ -192,10 +192,13 @@ void NOTGate::disconnect() {
 
 JKFlipFlop::JKFlipFlop()
     : LogicGate ("JKFlipFlop" + std::to_string(_counter+1)),
-      _old_clk(false)
-    {}
+      _old_clk(Logic::ZERO), _state(-1)
+{
+    _nodes.reserve(5);
+}
 
 JKFlipFlop::~JKFlipFlop() {
+    retire();
     disconnect();
 }
 
@@ -203,56 +206,83 @@ std::string JKFlipFlop::toString() const {
     std::stringstream str;
     str << name() << std::endl;
 
-    str << "J = " << _nodes[J]->_v << " V" << std::endl;
-    str << "K = " << _nodes[K]->_v << " V" << std::endl;
-    str << "Q = " << _nodes[Q]->_v << " V" << std::endl;
+    str << "J = " << _nodes[J]->v() << " V" << std::endl;
+    str << "K = " << _nodes[K]->v() << " V" << std::endl;
+    str << "Q = " << _nodes[Q]->v() << " V" << std::endl;
     return str.str();
 }
 
 void JKFlipFlop::set() const {
-    _nodes[Q]->_v = 5;
-    _nodes[Qc]->_v = 0;
-    updateVoltages(_nodes[Q]);
-    updateVoltages(_nodes[Qc]);
+    _state = 1;
+    driveNode(_nodes[Q], 5);
+    driveNode(_nodes[Qc], 0);
 }
 
 void JKFlipFlop::reset() const {
-    _nodes[Q]->_v = 0;
-    _nodes[Qc]->_v = 5;
-    updateVoltages(_nodes[Q]);
-    updateVoltages(_nodes[Qc]);
+    _state = 0;
+    driveNode(_nodes[Q], 0);
+    driveNode(_nodes[Qc], 5);
+}
+
+void JKFlipFlop::unknown() const {
+    _state = UNKNOWN;
+    driveNode(_nodes[Q], Logic::X);
+    driveNode(_nodes[Qc], Logic::X);
+}
+
+int JKFlipFlop::nextState(Logic::Value j, Logic::Value k) const {
+    //Unknown input could be 0 or 1, all combinations have to lead to the same state
+    int next = -2;
+    for (int new_j = 0; new_j <= 1; ++new_j) {
+        if (Logic::isKnown(j) && j != new_j) continue;
+        for (int new_k = 0; new_k <= 1; ++new_k) {
+            if (Logic::isKnown(k) && k != new_k) continue;
+
+            int state = _state;
+            //set J=1, K=0
+            if (new_j && !new_k) state = 1;
+            //reset J=0, K=1
+            else if (!new_j && new_k) state = 0;
+            //change state J=1, K=1
+            else if (new_j && new_k) state = _state == UNKNOWN ? UNKNOWN : _state == 1 ? 0 : 1;
+            //keep old state J=0, K=0
+
+            if (next != -2 && next != state) return UNKNOWN;
+            next = state;
+        }
+    }
+    return next;
 }
 
 double JKFlipFlop::voltage() const {
     //take new input values
-    int new_j = getBoolVoltage(_nodes[J]->_v);
-    int new_k = getBoolVoltage(_nodes[K]->_v);
-    int new_clk = getBoolVoltage(_nodes[CLK]->_v);
+    Logic::Value new_j = _nodes[J]->level();
+    Logic::Value new_k = _nodes[K]->level();
+    Logic::Value new_clk = _nodes[CLK]->level();
 
     //we can set or reset flip-flip
     //this is down edge of clock: from 1 to 0
-    if (_old_clk && !new_clk) {
-        //set J=1, K=0
-        if(new_j && !new_k) {
-            set();
-        }
-        //reset J=0, K=1
-        else if(!new_j && new_k) {
-            reset();
-        }
-        //change state J=1, K=1
-        else if(new_j && new_k) {
-            //state was set
-            if (getBoolVoltage(_nodes[Q]->_v)) {
-                reset();
-            } else {
-                set();
-            }
-        }
-        //keep old state J=0, K=0
+    bool edge = _old_clk == Logic::ONE && new_clk == Logic::ZERO;
+    //unknown clock before or after (four-state mode) could be an edge too
+    bool maybeEdge = (_old_clk == Logic::ONE && !Logic::isKnown(new_clk))
+                  || (!Logic::isKnown(_old_clk) && new_clk == Logic::ZERO);
+
+    int state = _state;
+    if (edge || maybeEdge) {
+        state = nextState(new_j, new_k);
+        if (maybeEdge && state != _state) state = UNKNOWN;
+    }
+
+    //outputs could be cleared by rebuilding of their nets, drive them again
+    if (state == 1) {
+        set();
+    } else if (state == 0) {
+        reset();
+    } else if (state == UNKNOWN) {
+        unknown();
     }
     _old_clk = new_clk;
-    return _nodes[Q]->_v;
+    return _nodes[Q]->v();
 }
 
 void JKFlipFlop::disconnect(int x, int y) {
@@ -260,7 +290,7 @@ void JKFlipFlop::disconnect(int x, int y) {
     if (it == Node::_allNodes.end()) return;
 
     //Remove possible voltage on output nodes
-    if (_nodes.size() == 5 && ((*it) == _nodes[Q] || *(it) == _nodes[Qc])) (*it)->_v = 0;
+    if (_nodes.size() == 5 && ((*it) == _nodes[Q] || *(it) == _nodes[Qc])) (*it)->setV(0);
     updateVoltages((*it));
     Component::disconnect(x, y);
 }
@@ -268,889 +298,114 @@ void JKFlipFlop::disconnect(int x, int y) {
 void JKFlipFlop::disconnect() {
     if (_nodes.size() == 5) {
         //Remove possible voltage on output nodes
-        _nodes[Q]->_v = 0;
-        _nodes[Qc]->_v = 0;
+        _nodes[Q]->setV(0);
+        _nodes[Qc]->setV(0);
         updateVoltages(_nodes[Q]);
         updateVoltages(_nodes[Qc]);
     }
     Component::disconnect();
 }
 
-#ifdef QTPAINT
-QRectF LogicGate::boundingRect() const {
-    return QRectF(0, 0, 180, 120);
-}
-
-void LogicGate::voltageDependedSetPen(QPainter* painter, unsigned id) {
-    if(nodes().size() < id+1) {
-        painter->setPen(penForLines);
-        return;
-    }
-
-	// Setting color for painter depended on voltage
-    if(nodes()[id]->_v > 0)
-        painter->setPen(penForLeadsGreen);
-    else if(nodes()[id]->_v < 0)
-        painter->setPen(penForLeadsRed);
-    else
-        painter->setPen(penForLines);
-}
-
-void LogicGate::voltageDependedDrawLine(QLineF line, QPainter* painter, unsigned id) {
-	// Draw line depending on voltage
-    voltageDependedSetPen(painter, id);
-    painter->drawLine(line);
-    update();
-
-	// Set color of line back to default
-    painter->setPen(penForLines);
-}
-
-std::vector<std::pair<int, int>> LogicGate::connectionPoints(void) const {
-    std::vector<std::pair<int, int>> dots;
-    dots.reserve(3);
-
-    // Find local coordinates of connection point
-    QPointF localPoint1(boundingRect().x(),
-                       boundingRect().y()+30);
-
-    QPointF localPoint2(boundingRect().x(),
-                       boundingRect().y()+90);
-
-    QPointF localPoint3(boundingRect().x()+boundingRect().width(),
-                       boundingRect().y()+boundingRect().height()/2);
-
-    // And then map to scene coordinates
-    auto scenePoint1 = mapToScene(localPoint1);
-    auto scenePoint2 = mapToScene(localPoint2);
-    auto scenePoint3 = mapToScene(localPoint3);
-    dots.push_back(std::pair<int, int>(scenePoint1.x(), scenePoint1.y()));
-    dots.push_back(std::pair<int, int>(scenePoint2.x(), scenePoint2.y()));
-    dots.push_back(std::pair<int, int>(scenePoint3.x(), scenePoint3.y()));
-
-    return dots;
-}
-
-void ANDGate::paint(QPainter* painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
-    Q_UNUSED(option);
-    Q_UNUSED(widget);
-    //painter->drawRect(boundingRect());
-
-    // First input lead
-    voltageDependedDrawLine(QLineF(0,30,50,30), painter, 0);
-
-    // Second input
-    voltageDependedDrawLine(QLineF(0,90,50,90), painter, 1);
-
-    // Component body
-    painter->drawLine(50,10,50,110);
-    painter->drawLine(50,10,100,10);
-    painter->drawLine(50,110,100,110);
-    painter->drawArc(QRect(62,10,75,100), -90*16, 180*16);
-
-    // Output lead
-    voltageDependedDrawLine(QLineF(137,60,180,60), painter, 2);
-
-    // Connection points
-    painter->setPen(penForDots);
-	QPointF in1(1, 30);
-	QPointF in2(1, 90);
-	QPointF out(179, 60);
-    painter->drawPoint(in1);
-    painter->drawPoint(in2);
-    painter->drawPoint(out);
-}
-
-void ORGate::paint(QPainter* painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
-    Q_UNUSED(option);
-    Q_UNUSED(widget);
-    //LOGComponent::paint(painter, option, widget);
-
-    // First input lead
-    voltageDependedDrawLine(QLineF(0,30,58,30), painter, 0);
-
-    // Second input
-    voltageDependedDrawLine(QLineF(0,90,58,90), painter, 1);
-
-    // Component body
-    painter->drawArc(QRect(15,10,50,100), -90*16, 180*16);
-    painter->drawLine(45,10,80,10);
-    painter->drawLine(45,110,80,110);
-
-    // Up and bottom arc
-    painter->drawArc(QRect(10,10,140,110), 0, 90*16);
-    painter->drawArc(QRect(10,10,140,100), -90*16, 90*16);
-
-    // Output lead
-    voltageDependedDrawLine(QLineF(150,60,180,60), painter, 2);
-
-    // Connection points
-    painter->setPen(penForDots);
-	QPointF in1(1, 30);
-	QPointF in2(1, 90);
-	QPointF out(179, 60);
-    painter->drawPoint(in1);
-    painter->drawPoint(in2);
-    painter->drawPoint(out);
-}
-
-void XORGate::paint(QPainter* painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
-    Q_UNUSED(option);
-    Q_UNUSED(widget);
-    //LOGComponent::paint(painter, option, widget);
-
-    // First input lead
-    voltageDependedDrawLine(QLineF(0,30,58,30), painter, 0);
-
-    // Second input
-    voltageDependedDrawLine(QLineF(0,90,58,90), painter, 1);
-
-    // Component body
-    painter->drawArc(QRect(15,10,50,100), -90*16, 180*16);
-    painter->drawLine(45,10,80,10);
-    painter->drawLine(45,110,80,110);
-
-    // Up and bottom arc
-    painter->drawArc(QRect(10,10,140,110), 0, 90*16);
-    painter->drawArc(QRect(10,10,140,100), -90*16, 90*16);
-
-    // Xor input arc
-    painter->drawArc(QRect(8,10,50,100), -90*16, 180*16);
-
-    // Output lead
-    voltageDependedDrawLine(QLineF(150,60,180,60), painter, 2);
-
-    // Connection points
-    painter->setPen(penForDots);
-	QPointF in1(1, 30);
-	QPointF in2(1, 90);
-	QPointF out(179, 60);
-    painter->drawPoint(in1);
-    painter->drawPoint(in2);
-    painter->drawPoint(out);
-}
-
-void NORGate::paint(QPainter* painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
-    Q_UNUSED(option);
-    Q_UNUSED(widget);
-    //LOGComponent::paint(painter, option, widget);
-
-    // First input lead
-    voltageDependedDrawLine(QLineF(0,30,58,30), painter, 0);
-
-    // Second input
-    voltageDependedDrawLine(QLineF(0,90,58,90), painter, 1);
-
-    // Component body
-    painter->drawArc(QRect(15,10,50,100), -90*16, 180*16);
-    painter->drawLine(45,10,80,10);
-    painter->drawLine(45,110,80,110);
-
-    // Up and bottom arc
-    painter->drawArc(QRect(10,10,140,110), 0, 90*16);
-    painter->drawArc(QRect(10,10,140,100), -90*16, 90*16);
-
-    // Output lead
-    voltageDependedDrawLine(QLineF(150,60,180,60), painter, 2);
-
-    // Connection points
-    painter->setPen(penForDots);
-	QPointF in1(1, 30);
-	QPointF in2(1, 90);
-	QPointF out(179, 60);
-    painter->drawPoint(in1);
-    painter->drawPoint(in2);
-    painter->drawPoint(out);
-
-    // Negation at the end
-    QPainterPath path;
-    path.addEllipse(QPointF(150, 60), 1, 1);
-    painter->drawPath(path);
+std::vector<std::pair<double, double>> LogicGate::localConnectionPoints() const {
+    return {{0, 30}, {0, 90}, {width(), height()/2}};
 }
 
-void NANDGate::paint(QPainter* painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
-    Q_UNUSED(option);
-    Q_UNUSED(widget);
-    //LOGComponent::paint(painter, option, widget);
-
-    // First input lead
-    voltageDependedDrawLine(QLineF(0,30,50,30), painter, 0);
-
-    // Second input
-    voltageDependedDrawLine(QLineF(0,90,50,90), painter, 1);
-
-    // Component body
-    painter->drawLine(50,10,50,110);
-    painter->drawLine(50,10,100,10);
-    painter->drawLine(50,110,100,110);
-    painter->drawArc(QRect(62,10, 75,100), -90*16, 180*16);
-
-    // Output lead
-    voltageDependedDrawLine(QLineF(140,60,180,60), painter, 2);
-
-    // Connection points
-    painter->setPen(penForDots);
-	QPointF in1(1, 30);
-	QPointF in2(1, 90);
-	QPointF out(179, 60);
-    painter->drawPoint(in1);
-    painter->drawPoint(in2);
-    painter->drawPoint(out);
-
-    // Negation at the end
-    QPainterPath path;
-    path.addEllipse(QPointF(139, 60), 1, 1);
-    painter->drawPath(path);
+std::vector<std::pair<double, double>> NOTGate::localConnectionPoints() const {
+    return {{0, height()/2}, {width(), height()/2}};
 }
 
-void NXORGate::paint(QPainter* painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
-    Q_UNUSED(option);
-    Q_UNUSED(widget);
-    //LOGComponent::paint(painter, option, widget);
-
-    // First input lead
-    voltageDependedDrawLine(QLineF(0,30,58,30), painter, 0);
-
-    // Second input
-    voltageDependedDrawLine(QLineF(0,90,58,90), painter, 1);
-
-    // Component body
-    painter->drawArc(QRect(15,10,50,100), -90*16, 180*16);
-    painter->drawLine(45,10,80,10);
-    painter->drawLine(45,110,80,110);
-
-    // Up and bottom arc
-    painter->drawArc(QRect(10,10,140,110), 0, 90*16);
-    painter->drawArc(QRect(10,10,140,100), -90*16, 90*16);
-
-    // Xor input arc
-    painter->drawArc(QRect(8,10,50,100), -90*16, 180*16);
-
-    // Output lead
-    voltageDependedDrawLine(QLineF(150,60,180,60), painter, 2);
-
-    // Connection points
-    painter->setPen(penForDots);
-	QPointF in1(1, 30);
-	QPointF in2(1, 90);
-	QPointF out(179, 60);
-    painter->drawPoint(in1);
-    painter->drawPoint(in2);
-    painter->drawPoint(out);
-
-    // Negation at the end
-    QPainterPath path;
-    path.addEllipse(QPointF(150, 60), 1, 1);
-    painter->drawPath(path);
-}
-
-void NOTGate::paint(QPainter* painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
-    Q_UNUSED(option);
-    Q_UNUSED(widget);
-    //LogicGate::paint(painter, option, widget);
-
-    // Input lead
-    voltageDependedDrawLine(QLineF(0,60,60,60), painter, 0);
-
-    // Component body
-    static const QPointF points[3] = {
-        QPointF(60, 30),
-        QPointF(120, 60),
-        QPointF(60, 90)
+std::vector<std::pair<double, double>> JKFlipFlop::localConnectionPoints() const {
+    return {
+        {0, 40}, {0, height()/2}, {0, 140},
+        {width(), 40}, {width(), 140}
     };
-    painter->drawPolygon(points, 3);
-
-    // Output lead
-    voltageDependedDrawLine(QLineF(120,60,180,60), painter, 1);
-
-    // Connection points
-    painter->setPen(penForDots);
-	QPointF in(1, 60);
-	QPointF out(179, 60);
-    painter->drawPoint(in);
-    painter->drawPoint(out);
-
-    // Negation at the end
-    QPainterPath path;
-    path.addEllipse(QPointF(120, 60), 1, 1);
-    painter->drawPath(path);
 }
 
-std::vector<std::pair<int, int>> NOTGate::connectionPoints(void) const {
-    std::vector<std::pair<int, int>> dots;
-    dots.reserve(2);
-
-	// Find local coordinates of connection point
-	QPointF localPoint1(boundingRect().x(),
-						boundingRect().y()+boundingRect().height()/2);
-
-	QPointF localPoint2(boundingRect().x()+boundingRect().width(),
-						boundingRect().y()+boundingRect().height()/2);
-
-	// And then map to scene coordinates
-	auto scenePoint1 = mapToScene(localPoint1);
-	auto scenePoint2 = mapToScene(localPoint2);
-	dots.push_back(std::pair<int, int>(scenePoint1.x(), scenePoint1.y()));
-	dots.push_back(std::pair<int, int>(scenePoint2.x(), scenePoint2.y()));
-
-	return dots;
-}
-
-QRectF JKFlipFlop::boundingRect() const {
-	return QRectF(0, 0, 160, 180);
-}
-
-void JKFlipFlop::paint(QPainter* painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
-	Q_UNUSED(option);
-	Q_UNUSED(widget);
-
-	// Input lines
-	voltageDependedDrawLine(QLineF(0, 40, 20, 40), painter, 0);
-	voltageDependedDrawLine(QLineF(0, 90, 20, 90), painter, 1);
-	voltageDependedDrawLine(QLineF(0, 140, 20, 140), painter, 2);
-
-	// Output liness
-	voltageDependedDrawLine(QLineF(140, 40, 160, 40), painter, 3);
-	voltageDependedDrawLine(QLineF(140, 140, 160, 140), painter, 4);
-
-	// Body
-	QRectF rect(20, 15, 120, 150);
-	painter->drawRect(rect);
-
-	// Letters
-    painter->setFont(QFont("Times", 25, QFont::Bold));
-    painter->drawText(rect, Qt::AlignLeft, " J");
-    painter->drawText(rect, Qt::AlignRight, "Q ");
-    painter->drawText(rect, Qt::AlignBottom , " K");
-    painter->drawText(rect, Qt::AlignBottom | Qt::AlignRight, "Qc ");
-
-	// Connection points
-	painter->setPen(penForDots);
-    QPointF in1(1, 40);
-	QPointF in2(1, 90);
-    QPointF in3(1, 140);
-    QPointF out1(159, 40);
-    QPointF out2(159, 140);
-	painter->drawPoint(in1);
-	painter->drawPoint(in2);
-	painter->drawPoint(in3);
-	painter->drawPoint(out1);
-	painter->drawPoint(out2);
-
-	// Circle on middle line
-	QPainterPath path;
-	path.addEllipse(QPointF(20, 90), 1, 1);
-	painter->drawPath(path);
-}
-
-std::vector<std::pair<int, int>> JKFlipFlop::connectionPoints(void) const {
-	std::vector<std::pair<int, int>> dots;
-	dots.reserve(5);
-
-	// Find local coordinates of connection point
-	QPointF localPoint1(boundingRect().x(),
-                        boundingRect().y()+40);
-
-	QPointF localPoint2(boundingRect().x(),
-						boundingRect().y()+boundingRect().height()/2);
-
-	QPointF localPoint3(boundingRect().x(),
-                        boundingRect().y()+140);
-
-	QPointF localPoint4(boundingRect().x()+boundingRect().width(),
-                        boundingRect().y()+40);
-
-	QPointF localPoint5(boundingRect().x()+boundingRect().width(),
-                        boundingRect().y()+140);
-
-	// And then map to scene coordinates
-	auto scenePoint1 = mapToScene(localPoint1);
-	auto scenePoint2 = mapToScene(localPoint2);
-	auto scenePoint3 = mapToScene(localPoint3);
-	auto scenePoint4 = mapToScene(localPoint4);
-	auto scenePoint5 = mapToScene(localPoint5);
-
-	dots.push_back(std::pair<int, int>(scenePoint1.x(), scenePoint1.y()));
-	dots.push_back(std::pair<int, int>(scenePoint2.x(), scenePoint2.y()));
-	dots.push_back(std::pair<int, int>(scenePoint3.x(), scenePoint3.y()));
-	dots.push_back(std::pair<int, int>(scenePoint4.x(), scenePoint4.y()));
-	dots.push_back(std::pair<int, int>(scenePoint5.x(), scenePoint5.y()));
-
-	return dots;
-}
-
-QRectF Decoder::boundingRect() const {
-	return QRectF(0, 0, 150, 180);
-}
-
-void Decoder::paint(QPainter* painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
-	Q_UNUSED(option);
-	Q_UNUSED(widget);
-//	LogicGate::paint(painter, option, widget);
-
-	// Setting color for drawing lines
-	painter->setPen(penForLines);
-
-	// Input lines
-	voltageDependedDrawLine(QLineF(0, 30, 10, 30), painter, 0);
-	voltageDependedDrawLine(QLineF(0, 50, 10, 50), painter, 1);
-	voltageDependedDrawLine(QLineF(0, 70, 10, 70), painter, 2);
-	voltageDependedDrawLine(QLineF(0, 90, 10, 90), painter, 3);
-
-	// Output lines
-	voltageDependedDrawLine(QLineF(140, 30, 150, 30), painter, 4);
-	voltageDependedDrawLine(QLineF(140, 50, 150, 50), painter, 5);
-	voltageDependedDrawLine(QLineF(140, 70, 150, 70), painter, 6);
-	voltageDependedDrawLine(QLineF(140, 90, 150, 90), painter, 7);
-	voltageDependedDrawLine(QLineF(140, 110, 150, 110), painter, 8);
-	voltageDependedDrawLine(QLineF(140, 130, 150, 130), painter, 9);
-	voltageDependedDrawLine(QLineF(140, 150, 150, 150), painter, 10);
-
-	// Body
-	QRectF rect(10, 5, 130, 170);
-	painter->drawRect(rect);
-
-	// Connection points
-	painter->setPen(penForDots);
-	QPointF in1(1, 30);
-	QPointF in2(1, 50);
-	QPointF in3(1, 70);
-	QPointF in4(1, 90);
-	QPointF out1(149, 30);
-	QPointF out2(149, 50);
-	QPointF out3(149, 70);
-	QPointF out4(149, 90);
-	QPointF out5(149, 110);
-	QPointF out6(149, 130);
-	QPointF out7(149, 150);
-
-	painter->drawPoint(in1);
-	painter->drawPoint(in2);
-	painter->drawPoint(in3);
-	painter->drawPoint(in4);
-	painter->drawPoint(out1);
-	painter->drawPoint(out2);
-	painter->drawPoint(out3);
-	painter->drawPoint(out4);
-	painter->drawPoint(out5);
-	painter->drawPoint(out6);
-	painter->drawPoint(out7);
-
-    // Letters
-    painter->setPen(penForLines);
-    painter->setFont(QFont("Times", 18, QFont::Thin));
-    painter->drawText(in1 + QPointF(15, 5), "I3");
-    painter->drawText(in2 + QPointF(15, 5), "I2");
-    painter->drawText(in3 + QPointF(15, 5), "I1");
-    painter->drawText(in4 + QPointF(15, 5), "I0");
-    painter->drawText(out1 - QPointF(30, -5), "a");
-    painter->drawText(out2 - QPointF(30, -5), "b");
-    painter->drawText(out3 - QPointF(30, -5), "c");
-    painter->drawText(out4 - QPointF(30, -5), "d");
-    painter->drawText(out5 - QPointF(30, -5), "e");
-    painter->drawText(out6 - QPointF(30, -5), "f");
-    painter->drawText(out7 - QPointF(30, -5), "g");
-}
-
-std::vector<std::pair<int, int>> Decoder::connectionPoints(void) const {
-	std::vector<std::pair<int, int>> dots;
-	dots.reserve(11);
-
-	// Find local coordinates of connection point
-	QPointF localPoint1(boundingRect().x(),
-						boundingRect().y()+30);
-
-	QPointF localPoint2(boundingRect().x(),
-						boundingRect().y()+50);
-
-	QPointF localPoint3(boundingRect().x(),
-						boundingRect().y()+70);
-
-	QPointF localPoint4(boundingRect().x(),
-						boundingRect().y()+90);
-
-	QPointF localPoint5(boundingRect().x()+boundingRect().width(),
-						boundingRect().y()+30);
-
-	QPointF localPoint6(boundingRect().x()+boundingRect().width(),
-						boundingRect().y()+50);
-
-	QPointF localPoint7(boundingRect().x()+boundingRect().width(),
-						boundingRect().y()+70);
-
-	QPointF localPoint8(boundingRect().x()+boundingRect().width(),
-						boundingRect().y()+90);
-
-	QPointF localPoint9(boundingRect().x()+boundingRect().width(),
-						boundingRect().y()+110);
-
-	QPointF localPoint10(boundingRect().x()+boundingRect().width(),
-						boundingRect().y()+130);
-
-	QPointF localPoint11(boundingRect().x()+boundingRect().width(),
-						boundingRect().y()+150);
-
-	// And then map to scene coordinates
-	auto scenePoint1 = mapToScene(localPoint1);
-	auto scenePoint2 = mapToScene(localPoint2);
-	auto scenePoint3 = mapToScene(localPoint3);
-	auto scenePoint4 = mapToScene(localPoint4);
-	auto scenePoint5 = mapToScene(localPoint5);
-	auto scenePoint6 = mapToScene(localPoint6);
-	auto scenePoint7 = mapToScene(localPoint7);
-	auto scenePoint8 = mapToScene(localPoint8);
-	auto scenePoint9 = mapToScene(localPoint9);
-	auto scenePoint10 = mapToScene(localPoint10);
-	auto scenePoint11 = mapToScene(localPoint11);
-
-	dots.push_back(std::pair<int, int>(scenePoint1.x(), scenePoint1.y()));
-	dots.push_back(std::pair<int, int>(scenePoint2.x(), scenePoint2.y()));
-	dots.push_back(std::pair<int, int>(scenePoint3.x(), scenePoint3.y()));
-	dots.push_back(std::pair<int, int>(scenePoint4.x(), scenePoint4.y()));
-	dots.push_back(std::pair<int, int>(scenePoint5.x(), scenePoint5.y()));
-	dots.push_back(std::pair<int, int>(scenePoint6.x(), scenePoint6.y()));
-	dots.push_back(std::pair<int, int>(scenePoint7.x(), scenePoint7.y()));
-	dots.push_back(std::pair<int, int>(scenePoint8.x(), scenePoint8.y()));
-	dots.push_back(std::pair<int, int>(scenePoint9.x(), scenePoint9.y()));
-	dots.push_back(std::pair<int, int>(scenePoint10.x(), scenePoint10.y()));
-	dots.push_back(std::pair<int, int>(scenePoint11.x(), scenePoint11.y()));
-
-	return dots;
-}
-
-QRectF LCDDisplay::boundingRect() const {
-	return QRectF(0, 0, 150, 180);
-}
-
-void LCDDisplay::paint(QPainter* painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
-	Q_UNUSED(option);
-	Q_UNUSED(widget);
-//	LogicGate::paint(painter, option, widget);
-
-	// Setting color for drawing lines
-	painter->setPen(penForLines);
-
-	// Input lines
-	voltageDependedDrawLine(QLineF(0, 30, 10, 30), painter, 0);
-	voltageDependedDrawLine(QLineF(0, 50, 10, 50), painter, 1);
-	voltageDependedDrawLine(QLineF(0, 70, 10, 70), painter, 2);
-	voltageDependedDrawLine(QLineF(0, 90, 10, 90), painter, 3);
-	voltageDependedDrawLine(QLineF(0, 110, 10, 110), painter, 4);
-	voltageDependedDrawLine(QLineF(0, 130, 10, 130), painter, 5);
-	voltageDependedDrawLine(QLineF(0, 150, 10, 150), painter, 6);
-
-	// Body
-	QRectF rect(10, 5, 130, 170);
-	painter->drawRect(rect);
-
-	// Drawing digits
-	painter->setPen(penForDigit);
-	if(getBoolVoltage(_nodes[a]->_v)) {
-        painter->drawLine(70, 30, 100, 30);
-		update();
-	}
-	if(getBoolVoltage(_nodes[b]->_v)) {
-        painter->drawLine(100, 30, 100, 60);
-		update();
-	}
-	if(getBoolVoltage(_nodes[c]->_v)) {
-        painter->drawLine(100, 60, 100, 90);
-		update();
-	}
-	if(getBoolVoltage(_nodes[d]->_v)) {
-        painter->drawLine(70, 90, 100, 90);
-		update();
-	}
-	if(getBoolVoltage(_nodes[e]->_v)) {
-        painter->drawLine(70, 60, 70, 90);
-		update();
-	}
-	if(getBoolVoltage(_nodes[f]->_v)) {
-        painter->drawLine(70, 30, 70, 60);
-		update();
-	}
-	if(getBoolVoltage(_nodes[g]->_v)) {
-        painter->drawLine(70, 60, 100, 60);
-		update();
-	}
-
-	// Connection points
-	painter->setPen(penForDots);
-	QPointF in1(1, 30);
-	QPointF in2(1, 50);
-	QPointF in3(1, 70);
-	QPointF in4(1, 90);
-	QPointF in5(1, 110);
-	QPointF in6(1, 130);
-	QPointF in7(1, 150);
-
-	painter->drawPoint(in1);
-	painter->drawPoint(in2);
-	painter->drawPoint(in3);
-	painter->drawPoint(in4);
-	painter->drawPoint(in5);
-	painter->drawPoint(in6);
-	painter->drawPoint(in7);
-
-	// Letters
-    painter->setPen(penForLines);
-    painter->setFont(QFont("Times", 18, QFont::Thin));
-    painter->drawText(in1 + QPointF(20, 5), "a");
-    painter->drawText(in2 + QPointF(20, 5), "b");
-    painter->drawText(in3 + QPointF(20, 5), "c");
-    painter->drawText(in4 + QPointF(20, 5), "d");
-    painter->drawText(in5 + QPointF(20, 5), "e");
-    painter->drawText(in6 + QPointF(20, 5), "f");
-    painter->drawText(in7 + QPointF(20, 5), "g");
+std::vector<std::pair<double, double>> Decoder::localConnectionPoints() const {
+    return {
+        {0, 30}, {0, 50}, {0, 70}, {0, 90},
+        {width(), 30}, {width(), 50}, {width(), 70}, {width(), 90},
+        {width(), 110}, {width(), 130}, {width(), 150}
+    };
 }
 
-std::vector<std::pair<int, int>> LCDDisplay::connectionPoints(void) const {
-	std::vector<std::pair<int, int>> dots;
-	dots.reserve(7);
-
-	// Find local coordinates of connection point
-	QPointF localPoint1(boundingRect().x(),
-						boundingRect().y()+30);
-
-	QPointF localPoint2(boundingRect().x(),
-						boundingRect().y()+50);
-
-	QPointF localPoint3(boundingRect().x(),
-						boundingRect().y()+70);
-
-	QPointF localPoint4(boundingRect().x(),
-						boundingRect().y()+90);
-
-	QPointF localPoint5(boundingRect().x(),
-						boundingRect().y()+110);
-
-	QPointF localPoint6(boundingRect().x(),
-						boundingRect().y()+130);
-
-	QPointF localPoint7(boundingRect().x(),
-						boundingRect().y()+150);
-
-	// And then map to scene coordinates
-	auto scenePoint1 = mapToScene(localPoint1);
-	auto scenePoint2 = mapToScene(localPoint2);
-	auto scenePoint3 = mapToScene(localPoint3);
-	auto scenePoint4 = mapToScene(localPoint4);
-	auto scenePoint5 = mapToScene(localPoint5);
-	auto scenePoint6 = mapToScene(localPoint6);
-	auto scenePoint7 = mapToScene(localPoint7);
-
-	dots.push_back(std::pair<int, int>(scenePoint1.x(), scenePoint1.y()));
-	dots.push_back(std::pair<int, int>(scenePoint2.x(), scenePoint2.y()));
-	dots.push_back(std::pair<int, int>(scenePoint3.x(), scenePoint3.y()));
-	dots.push_back(std::pair<int, int>(scenePoint4.x(), scenePoint4.y()));
-	dots.push_back(std::pair<int, int>(scenePoint5.x(), scenePoint5.y()));
-	dots.push_back(std::pair<int, int>(scenePoint6.x(), scenePoint6.y()));
-	dots.push_back(std::pair<int, int>(scenePoint7.x(), scenePoint7.y()));
-
-	return dots;
+std::vector<std::pair<double, double>> LCDDisplay::localConnectionPoints() const {
+    return {{0, 30}, {0, 50}, {0, 70}, {0, 90}, {0, 110}, {0, 130}, {0, 150}};
 }
 
-#endif
-
 std::string NOTGate::toString() const {
     std::stringstream str;
     str << name() << std::endl;
 
     str << std::fixed << std::setprecision(2);
-    str << "in: " << _nodes[0]->_v << " V" << std::endl;
-    str << "out: " << _nodes[1]->_v << " V" << std::endl;
+    str << "in: " << _nodes[0]->v() << " V" << std::endl;
+    str << "out: " << _nodes[1]->v() << " V" << std::endl;
     return str.str();
 }
 
 
 Decoder::Decoder()
     :LogicGate("Decoder" + std::to_string(_counter+1))
-{}
+{
+    _nodes.reserve(11);
+}
 
 std::string Decoder::toString() const {
     std::stringstream str;
     str << name() << std::endl;
 
-    str << "I3: " << _nodes[I3]->_v << " V; " << "I2: " << _nodes[I2]->_v << " V" << std::endl;
-    str << "I1: " << _nodes[I1]->_v << " V; " << "I0: " << _nodes[I0]->_v << " V" << std::endl;
-    str << "a: " << _nodes[a]->_v << " V; " << "b: " << _nodes[b]->_v << " V" << std::endl;
-    str << "c: " << _nodes[c]->_v << " V; " << "d: " << _nodes[d]->_v << " V" << std::endl;
-    str << "e: " << _nodes[e]->_v << " V; " << "f: " << _nodes[f]->_v << " V" << std::endl;
-    str << "g: " << _nodes[g]->_v << " V" << std::endl;
+    str << "I3: " << _nodes[I3]->v() << " V; " << "I2: " << _nodes[I2]->v() << " V" << std::endl;
+    str << "I1: " << _nodes[I1]->v() << " V; " << "I0: " << _nodes[I0]->v() << " V" << std::endl;
+    str << "a: " << _nodes[a]->v() << " V; " << "b: " << _nodes[b]->v() << " V" << std::endl;
+    str << "c: " << _nodes[c]->v() << " V; " << "d: " << _nodes[d]->v() << " V" << std::endl;
+    str << "e: " << _nodes[e]->v() << " V; " << "f: " << _nodes[f]->v() << " V" << std::endl;
+    str << "g: " << _nodes[g]->v() << " V" << std::endl;
     return str.str();
 }
 
 Decoder::~Decoder() {
+	retire();
 	disconnect();
 }
 
 void Decoder::updateVoltages() const {
 	for(unsigned i = a; i <= g; ++i) {
-		LogicGate::updateVoltages(_nodes[i]);
+		Scheduler::schedule(_nodes[i], this);
 	}
+	Scheduler::run();
 }
 
-int Decoder::inputToBinaryInt(double a, double b, double c, double d) const {
-	int in = getBoolVoltage(a) * 1000
-		   + getBoolVoltage(b) * 100
-		   + getBoolVoltage(c) * 10
-		   + getBoolVoltage(d);
+namespace {
 
-	return in;
+//Segments of every digit on seven-segment display, bit 6 is segment 'a' and bit 0 segment 'g'
+const unsigned char SEGMENTS[16] = {
+    0x7E, 0x30, 0x6D, 0x79, 0x33, 0x5B, 0x5F, 0x70,
+    0x7F, 0x73, 0x77, 0x1F, 0x4E, 0x3D, 0x4F, 0x47
+};
+
+}
+
+int Decoder::inputToBinaryInt(Logic::Value a, Logic::Value b, Logic::Value c, Logic::Value d) const {
+	if (!Logic::isKnown(a) || !Logic::isKnown(b) || !Logic::isKnown(c) || !Logic::isKnown(d))
+		return -1;
+
+	return a * 8 + b * 4 + c * 2 + d;
 }
 
 void Decoder::decodeOutput(int input) const {
-	switch (input) {
-		case 0:
-				_nodes[a]->_v = 5;
-				_nodes[b]->_v = 5;
-				_nodes[c]->_v = 5;
-				_nodes[d]->_v = 5;
-				_nodes[e]->_v = 5;
-				_nodes[f]->_v = 5;
-				_nodes[g]->_v = 0;
-		break;
-		case 1:
-				_nodes[a]->_v = 0;
-				_nodes[b]->_v = 5;
-				_nodes[c]->_v = 5;
-				_nodes[d]->_v = 0;
-				_nodes[e]->_v = 0;
-				_nodes[f]->_v = 0;
-				_nodes[g]->_v = 0;
-		break;
-		case 10:
-				_nodes[a]->_v = 5;
-				_nodes[b]->_v = 5;
-				_nodes[c]->_v = 0;
-				_nodes[d]->_v = 5;
-				_nodes[e]->_v = 5;
-				_nodes[f]->_v = 0;
-				_nodes[g]->_v = 5;
-		break;
-		case 11:
-				_nodes[a]->_v = 5;
-				_nodes[b]->_v = 5;
-				_nodes[c]->_v = 5;
-				_nodes[d]->_v = 5;
-				_nodes[e]->_v = 0;
-				_nodes[f]->_v = 0;
-				_nodes[g]->_v = 5;
-		break;
-		case 100:
-				_nodes[a]->_v = 0;
-				_nodes[b]->_v = 5;
-				_nodes[c]->_v = 5;
-				_nodes[d]->_v = 0;
-				_nodes[e]->_v = 0;
-				_nodes[f]->_v = 5;
-				_nodes[g]->_v = 5;
-		break;
-		case 101:
-				_nodes[a]->_v = 5;
-				_nodes[b]->_v = 0;
-				_nodes[c]->_v = 5;
-				_nodes[d]->_v = 5;
-				_nodes[e]->_v = 0;
-				_nodes[f]->_v = 5;
-				_nodes[g]->_v = 5;
-		break;
-		case 110:
-				_nodes[a]->_v = 5;
-				_nodes[b]->_v = 0;
-				_nodes[c]->_v = 5;
-				_nodes[d]->_v = 5;
-				_nodes[e]->_v = 5;
-				_nodes[f]->_v = 5;
-				_nodes[g]->_v = 5;
-		break;
-		case 111:
-				_nodes[a]->_v = 5;
-				_nodes[b]->_v = 5;
-				_nodes[c]->_v = 5;
-				_nodes[d]->_v = 0;
-				_nodes[e]->_v = 0;
-				_nodes[f]->_v = 0;
-				_nodes[g]->_v = 0;
-		break;
-		case 1000:
-				_nodes[a]->_v = 5;
-				_nodes[b]->_v = 5;
-				_nodes[c]->_v = 5;
-				_nodes[d]->_v = 5;
-				_nodes[e]->_v = 5;
-				_nodes[f]->_v = 5;
-				_nodes[g]->_v = 5;
-		break;
-		case 1001:
-				_nodes[a]->_v = 5;
-				_nodes[b]->_v = 5;
-				_nodes[c]->_v = 5;
-				_nodes[d]->_v = 0;
-				_nodes[e]->_v = 0;
-				_nodes[f]->_v = 5;
-				_nodes[g]->_v = 5;
-		break;
-		case 1010:
-				_nodes[a]->_v = 5;
-				_nodes[b]->_v = 5;
-				_nodes[c]->_v = 5;
-				_nodes[d]->_v = 0;
-				_nodes[e]->_v = 5;
-				_nodes[f]->_v = 5;
-				_nodes[g]->_v = 5;
-		break;
-		case 1011:
-				_nodes[a]->_v = 0;
-				_nodes[b]->_v = 0;
-				_nodes[c]->_v = 5;
-				_nodes[d]->_v = 5;
-				_nodes[e]->_v = 5;
-				_nodes[f]->_v = 5;
-				_nodes[g]->_v = 5;
-		break;
-		case 1100:
-				_nodes[a]->_v = 5;
-				_nodes[b]->_v = 0;
-				_nodes[c]->_v = 0;
-				_nodes[d]->_v = 5;
-				_nodes[e]->_v = 5;
-				_nodes[f]->_v = 5;
-				_nodes[g]->_v = 0;
-		break;
-		case 1101:
-				_nodes[a]->_v = 0;
-				_nodes[b]->_v = 5;
-				_nodes[c]->_v = 5;
-				_nodes[d]->_v = 5;
-				_nodes[e]->_v = 5;
-				_nodes[f]->_v = 0;
-				_nodes[g]->_v = 5;
-		break;
-		case 1110:
-				_nodes[a]->_v = 5;
-				_nodes[b]->_v = 0;
-				_nodes[c]->_v = 0;
-				_nodes[d]->_v = 5;
-				_nodes[e]->_v = 5;
-				_nodes[f]->_v = 5;
-				_nodes[g]->_v = 5;
-		break;
-		case 1111:
-				_nodes[a]->_v = 5;
-				_nodes[b]->_v = 0;
-				_nodes[c]->_v = 0;
-				_nodes[d]->_v = 0;
-				_nodes[e]->_v = 5;
-				_nodes[f]->_v = 5;
-				_nodes[g]->_v = 5;
-		break;
+	//Outputs change together, readers see only the whole new digit
+	Scheduler::hold();
+	for (unsigned i = a; i <= g; ++i) {
+		if (input < 0)
+			driveNode(_nodes[i], Logic::X);
+		else
+			driveNode(_nodes[i], (SEGMENTS[input] >> (g - i) & 1) ? Logic::ONE : Logic::ZERO);
 	}
-	updateVoltages();
+	Scheduler::release();
 }
 
 double Decoder::voltage() const {
-	int in = inputToBinaryInt(_nodes[I3]->_v, _nodes[I2]->_v, _nodes[I1]->_v, _nodes[I0]->_v);
+	int in = inputToBinaryInt(_nodes[I3]->level(), _nodes[I2]->level(), _nodes[I1]->level(), _nodes[I0]->level());
 	decodeOutput(in);
 	return 0;
 }
@@ -1163,7 +418,7 @@ void Decoder::disconnect(int x, int y) {
     if (_nodes.size() == 11) {
         for (unsigned i = a; i <= g; ++i) {
             if ((*it) == _nodes[i])
-                (*it)->_v = 0;
+                (*it)->setV(0);
         }
     }
     LogicGate::updateVoltages((*it));
@@ -1174,7 +429,7 @@ void Decoder::disconnect() {
     if (_nodes.size() == 11) {
         //Remove possible voltage on output node
         for (unsigned i = a; i <= g; ++i) {
-            _nodes[i]->_v = 0;
+            _nodes[i]->setV(0);
         }
         updateVoltages();
     }
@@ -1183,9 +438,12 @@ void Decoder::disconnect() {
 
 LCDDisplay::LCDDisplay()
     :LogicGate("LCD display" + std::to_string(_counter+1))
-{}
+{
+    _nodes.reserve(7);
+}
 
 LCDDisplay::~LCDDisplay() {
+    retire();
     disconnect();
 }
 
@@ -1193,9 +451,9 @@ std::string LCDDisplay::toString() const {
     std::stringstream str;
     str << name() << std::endl;
 
-    str << "a: " << _nodes[a]->_v << " V; " << "b: " << _nodes[b]->_v << " V" << std::endl;
-    str << "c: " << _nodes[c]->_v << " V; " << "d: " << _nodes[d]->_v << " V" << std::endl;
-    str << "e: " << _nodes[e]->_v << " V; " << "f: " << _nodes[f]->_v << " V" << std::endl;
-    str << "g: " << _nodes[g]->_v << " V" << std::endl;
+    str << "a: " << _nodes[a]->v() << " V; " << "b: " << _nodes[b]->v() << " V" << std::endl;
+    str << "c: " << _nodes[c]->v() << " V; " << "d: " << _nodes[d]->v() << " V" << std::endl;
+    str << "e: " << _nodes[e]->v() << " V; " << "f: " << _nodes[f]->v() << " V" << std::endl;
+    str << "g: " << _nodes[g]->v() << " V" << std::endl;
     return str.str();
 }
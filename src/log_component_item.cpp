@@ -0,0 +1,507 @@
+#include "log_component_item.h"
+
+#include <QFontMetrics>
+
+LogicGateItem::LogicGateItem(LogicGate* gate)
+    : ComponentItem(gate)
+{}
+
+ANDGateItem::ANDGateItem()
+    : LogicGateItem(new ANDGate())
+{}
+
+ORGateItem::ORGateItem()
+    : LogicGateItem(new ORGate())
+{}
+
+XORGateItem::XORGateItem()
+    : LogicGateItem(new XORGate())
+{}
+
+NANDGateItem::NANDGateItem()
+    : LogicGateItem(new NANDGate())
+{}
+
+NORGateItem::NORGateItem()
+    : LogicGateItem(new NORGate())
+{}
+
+NXORGateItem::NXORGateItem()
+    : LogicGateItem(new NXORGate())
+{}
+
+NOTGateItem::NOTGateItem()
+    : LogicGateItem(new NOTGate())
+{}
+
+JKFlipFlopItem::JKFlipFlopItem()
+    : LogicGateItem(new JKFlipFlop())
+{}
+
+DecoderItem::DecoderItem()
+    : LogicGateItem(new Decoder())
+{}
+
+LCDDisplayItem::LCDDisplayItem()
+    : LogicGateItem(new LCDDisplay())
+{}
+
+void LogicGateItem::voltageDependedSetPen(QPainter* painter, unsigned id) {
+	// Setting color for painter depended on voltage, not connected node has no voltage
+    double v = nodeVoltage(id);
+    if(v > 0)
+        painter->setPen(penForLeadsGreen);
+    else if(v < 0)
+        painter->setPen(penForLeadsRed);
+    else
+        painter->setPen(penForLines);
+}
+
+void LogicGateItem::voltageDependedDrawLine(QLineF line, QPainter* painter, unsigned id) {
+	// Draw line depending on voltage
+    voltageDependedSetPen(painter, id);
+    painter->drawLine(line);
+    update();
+
+	// Set color of line back to default
+    painter->setPen(penForLines);
+}
+
+void ANDGateItem::paint(QPainter* painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+    //painter->drawRect(boundingRect());
+
+    // First input lead
+    voltageDependedDrawLine(QLineF(0,30,50,30), painter, 0);
+
+    // Second input
+    voltageDependedDrawLine(QLineF(0,90,50,90), painter, 1);
+
+    // Component body
+    painter->drawLine(50,10,50,110);
+    painter->drawLine(50,10,100,10);
+    painter->drawLine(50,110,100,110);
+    painter->drawArc(QRect(62,10,75,100), -90*16, 180*16);
+
+    // Output lead
+    voltageDependedDrawLine(QLineF(137,60,180,60), painter, 2);
+
+    // Connection points
+    painter->setPen(penForDots);
+	QPointF in1(1, 30);
+	QPointF in2(1, 90);
+	QPointF out(179, 60);
+    painter->drawPoint(in1);
+    painter->drawPoint(in2);
+    painter->drawPoint(out);
+}
+
+void ORGateItem::paint(QPainter* painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+    //LogicGateItem::paint(painter, option, widget);
+
+    // First input lead
+    voltageDependedDrawLine(QLineF(0,30,58,30), painter, 0);
+
+    // Second input
+    voltageDependedDrawLine(QLineF(0,90,58,90), painter, 1);
+
+    // Component body
+    painter->drawArc(QRect(15,10,50,100), -90*16, 180*16);
+    painter->drawLine(45,10,80,10);
+    painter->drawLine(45,110,80,110);
+
+    // Up and bottom arc
+    painter->drawArc(QRect(10,10,140,110), 0, 90*16);
+    painter->drawArc(QRect(10,10,140,100), -90*16, 90*16);
+
+    // Output lead
+    voltageDependedDrawLine(QLineF(150,60,180,60), painter, 2);
+
+    // Connection points
+    painter->setPen(penForDots);
+	QPointF in1(1, 30);
+	QPointF in2(1, 90);
+	QPointF out(179, 60);
+    painter->drawPoint(in1);
+    painter->drawPoint(in2);
+    painter->drawPoint(out);
+}
+
+void XORGateItem::paint(QPainter* painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+    //LogicGateItem::paint(painter, option, widget);
+
+    // First input lead
+    voltageDependedDrawLine(QLineF(0,30,58,30), painter, 0);
+
+    // Second input
+    voltageDependedDrawLine(QLineF(0,90,58,90), painter, 1);
+
+    // Component body
+    painter->drawArc(QRect(15,10,50,100), -90*16, 180*16);
+    painter->drawLine(45,10,80,10);
+    painter->drawLine(45,110,80,110);
+
+    // Up and bottom arc
+    painter->drawArc(QRect(10,10,140,110), 0, 90*16);
+    painter->drawArc(QRect(10,10,140,100), -90*16, 90*16);
+
+    // Xor input arc
+    painter->drawArc(QRect(8,10,50,100), -90*16, 180*16);
+
+    // Output lead
+    voltageDependedDrawLine(QLineF(150,60,180,60), painter, 2);
+
+    // Connection points
+    painter->setPen(penForDots);
+	QPointF in1(1, 30);
+	QPointF in2(1, 90);
+	QPointF out(179, 60);
+    painter->drawPoint(in1);
+    painter->drawPoint(in2);
+    painter->drawPoint(out);
+}
+
+void NORGateItem::paint(QPainter* painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+    //LogicGateItem::paint(painter, option, widget);
+
+    // First input lead
+    voltageDependedDrawLine(QLineF(0,30,58,30), painter, 0);
+
+    // Second input
+    voltageDependedDrawLine(QLineF(0,90,58,90), painter, 1);
+
+    // Component body
+    painter->drawArc(QRect(15,10,50,100), -90*16, 180*16);
+    painter->drawLine(45,10,80,10);
+    painter->drawLine(45,110,80,110);
+
+    // Up and bottom arc
+    painter->drawArc(QRect(10,10,140,110), 0, 90*16);
+    painter->drawArc(QRect(10,10,140,100), -90*16, 90*16);
+
+    // Output lead
+    voltageDependedDrawLine(QLineF(150,60,180,60), painter, 2);
+
+    // Connection points
+    painter->setPen(penForDots);
+	QPointF in1(1, 30);
+	QPointF in2(1, 90);
+	QPointF out(179, 60);
+    painter->drawPoint(in1);
+    painter->drawPoint(in2);
+    painter->drawPoint(out);
+
+    // Negation at the end
+    QPainterPath path;
+    path.addEllipse(QPointF(150, 60), 1, 1);
+    painter->drawPath(path);
+}
+
+void NANDGateItem::paint(QPainter* painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+    //LogicGateItem::paint(painter, option, widget);
+
+    // First input lead
+    voltageDependedDrawLine(QLineF(0,30,50,30), painter, 0);
+
+    // Second input
+    voltageDependedDrawLine(QLineF(0,90,50,90), painter, 1);
+
+    // Component body
+    painter->drawLine(50,10,50,110);
+    painter->drawLine(50,10,100,10);
+    painter->drawLine(50,110,100,110);
+    painter->drawArc(QRect(62,10, 75,100), -90*16, 180*16);
+
+    // Output lead
+    voltageDependedDrawLine(QLineF(140,60,180,60), painter, 2);
+
+    // Connection points
+    painter->setPen(penForDots);
+	QPointF in1(1, 30);
+	QPointF in2(1, 90);
+	QPointF out(179, 60);
+    painter->drawPoint(in1);
+    painter->drawPoint(in2);
+    painter->drawPoint(out);
+
+    // Negation at the end
+    QPainterPath path;
+    path.addEllipse(QPointF(139, 60), 1, 1);
+    painter->drawPath(path);
+}
+
+void NXORGateItem::paint(QPainter* painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+    //LogicGateItem::paint(painter, option, widget);
+
+    // First input lead
+    voltageDependedDrawLine(QLineF(0,30,58,30), painter, 0);
+
+    // Second input
+    voltageDependedDrawLine(QLineF(0,90,58,90), painter, 1);
+
+    // Component body
+    painter->drawArc(QRect(15,10,50,100), -90*16, 180*16);
+    painter->drawLine(45,10,80,10);
+    painter->drawLine(45,110,80,110);
+
+    // Up and bottom arc
+    painter->drawArc(QRect(10,10,140,110), 0, 90*16);
+    painter->drawArc(QRect(10,10,140,100), -90*16, 90*16);
+
+    // Xor input arc
+    painter->drawArc(QRect(8,10,50,100), -90*16, 180*16);
+
+    // Output lead
+    voltageDependedDrawLine(QLineF(150,60,180,60), painter, 2);
+
+    // Connection points
+    painter->setPen(penForDots);
+	QPointF in1(1, 30);
+	QPointF in2(1, 90);
+	QPointF out(179, 60);
+    painter->drawPoint(in1);
+    painter->drawPoint(in2);
+    painter->drawPoint(out);
+
+    // Negation at the end
+    QPainterPath path;
+    path.addEllipse(QPointF(150, 60), 1, 1);
+    painter->drawPath(path);
+}
+
+void NOTGateItem::paint(QPainter* painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+    //LogicGateItem::paint(painter, option, widget);
+
+    // Input lead
+    voltageDependedDrawLine(QLineF(0,60,60,60), painter, 0);
+
+    // Component body
+    static const QPointF points[3] = {
+        QPointF(60, 30),
+        QPointF(120, 60),
+        QPointF(60, 90)
+    };
+    painter->drawPolygon(points, 3);
+
+    // Output lead
+    voltageDependedDrawLine(QLineF(120,60,180,60), painter, 1);
+
+    // Connection points
+    painter->setPen(penForDots);
+	QPointF in(1, 60);
+	QPointF out(179, 60);
+    painter->drawPoint(in);
+    painter->drawPoint(out);
+
+    // Negation at the end
+    QPainterPath path;
+    path.addEllipse(QPointF(120, 60), 1, 1);
+    painter->drawPath(path);
+}
+
+void JKFlipFlopItem::paint(QPainter* painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+	Q_UNUSED(option);
+	Q_UNUSED(widget);
+
+	// Input lines
+	voltageDependedDrawLine(QLineF(0, 40, 20, 40), painter, 0);
+	voltageDependedDrawLine(QLineF(0, 90, 20, 90), painter, 1);
+	voltageDependedDrawLine(QLineF(0, 140, 20, 140), painter, 2);
+
+	// Output liness
+	voltageDependedDrawLine(QLineF(140, 40, 160, 40), painter, 3);
+	voltageDependedDrawLine(QLineF(140, 140, 160, 140), painter, 4);
+
+	// Body
+	QRectF rect(20, 15, 120, 150);
+	painter->drawRect(rect);
+
+	// Letters
+    painter->setFont(QFont("Times", 25, QFont::Bold));
+    painter->drawText(rect, Qt::AlignLeft, " J");
+    painter->drawText(rect, Qt::AlignRight, "Q ");
+    painter->drawText(rect, Qt::AlignBottom , " K");
+    painter->drawText(rect, Qt::AlignBottom | Qt::AlignRight, "Qc ");
+
+	// Connection points
+	painter->setPen(penForDots);
+    QPointF in1(1, 40);
+	QPointF in2(1, 90);
+    QPointF in3(1, 140);
+    QPointF out1(159, 40);
+    QPointF out2(159, 140);
+	painter->drawPoint(in1);
+	painter->drawPoint(in2);
+	painter->drawPoint(in3);
+	painter->drawPoint(out1);
+	painter->drawPoint(out2);
+
+	// Circle on middle line
+	QPainterPath path;
+	path.addEllipse(QPointF(20, 90), 1, 1);
+	painter->drawPath(path);
+}
+
+void DecoderItem::paint(QPainter* painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+	Q_UNUSED(option);
+	Q_UNUSED(widget);
+//	LogicGateItem::paint(painter, option, widget);
+
+	// Setting color for drawing lines
+	painter->setPen(penForLines);
+
+	// Input lines
+	voltageDependedDrawLine(QLineF(0, 30, 10, 30), painter, 0);
+	voltageDependedDrawLine(QLineF(0, 50, 10, 50), painter, 1);
+	voltageDependedDrawLine(QLineF(0, 70, 10, 70), painter, 2);
+	voltageDependedDrawLine(QLineF(0, 90, 10, 90), painter, 3);
+
+	// Output lines
+	voltageDependedDrawLine(QLineF(140, 30, 150, 30), painter, 4);
+	voltageDependedDrawLine(QLineF(140, 50, 150, 50), painter, 5);
+	voltageDependedDrawLine(QLineF(140, 70, 150, 70), painter, 6);
+	voltageDependedDrawLine(QLineF(140, 90, 150, 90), painter, 7);
+	voltageDependedDrawLine(QLineF(140, 110, 150, 110), painter, 8);
+	voltageDependedDrawLine(QLineF(140, 130, 150, 130), painter, 9);
+	voltageDependedDrawLine(QLineF(140, 150, 150, 150), painter, 10);
+
+	// Body
+	QRectF rect(10, 5, 130, 170);
+	painter->drawRect(rect);
+
+	// Connection points
+	painter->setPen(penForDots);
+	QPointF in1(1, 30);
+	QPointF in2(1, 50);
+	QPointF in3(1, 70);
+	QPointF in4(1, 90);
+	QPointF out1(149, 30);
+	QPointF out2(149, 50);
+	QPointF out3(149, 70);
+	QPointF out4(149, 90);
+	QPointF out5(149, 110);
+	QPointF out6(149, 130);
+	QPointF out7(149, 150);
+
+	painter->drawPoint(in1);
+	painter->drawPoint(in2);
+	painter->drawPoint(in3);
+	painter->drawPoint(in4);
+	painter->drawPoint(out1);
+	painter->drawPoint(out2);
+	painter->drawPoint(out3);
+	painter->drawPoint(out4);
+	painter->drawPoint(out5);
+	painter->drawPoint(out6);
+	painter->drawPoint(out7);
+
+    // Letters
+    painter->setPen(penForLines);
+    painter->setFont(QFont("Times", 18, QFont::Thin));
+    painter->drawText(in1 + QPointF(15, 5), "I3");
+    painter->drawText(in2 + QPointF(15, 5), "I2");
+    painter->drawText(in3 + QPointF(15, 5), "I1");
+    painter->drawText(in4 + QPointF(15, 5), "I0");
+    painter->drawText(out1 - QPointF(30, -5), "a");
+    painter->drawText(out2 - QPointF(30, -5), "b");
+    painter->drawText(out3 - QPointF(30, -5), "c");
+    painter->drawText(out4 - QPointF(30, -5), "d");
+    painter->drawText(out5 - QPointF(30, -5), "e");
+    painter->drawText(out6 - QPointF(30, -5), "f");
+    painter->drawText(out7 - QPointF(30, -5), "g");
+}
+
+void LCDDisplayItem::paint(QPainter* painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+	Q_UNUSED(option);
+	Q_UNUSED(widget);
+//	LogicGateItem::paint(painter, option, widget);
+
+	// Setting color for drawing lines
+	painter->setPen(penForLines);
+
+	// Input lines
+	voltageDependedDrawLine(QLineF(0, 30, 10, 30), painter, 0);
+	voltageDependedDrawLine(QLineF(0, 50, 10, 50), painter, 1);
+	voltageDependedDrawLine(QLineF(0, 70, 10, 70), painter, 2);
+	voltageDependedDrawLine(QLineF(0, 90, 10, 90), painter, 3);
+	voltageDependedDrawLine(QLineF(0, 110, 10, 110), painter, 4);
+	voltageDependedDrawLine(QLineF(0, 130, 10, 130), painter, 5);
+	voltageDependedDrawLine(QLineF(0, 150, 10, 150), painter, 6);
+
+	// Body
+	QRectF rect(10, 5, 130, 170);
+	painter->drawRect(rect);
+
+	// Drawing digits
+	painter->setPen(penForDigit);
+	if(LogicGate::getBoolVoltage(nodeVoltage(LCDDisplay::a))) {
+        painter->drawLine(70, 30, 100, 30);
+		update();
+	}
+	if(LogicGate::getBoolVoltage(nodeVoltage(LCDDisplay::b))) {
+        painter->drawLine(100, 30, 100, 60);
+		update();
+	}
+	if(LogicGate::getBoolVoltage(nodeVoltage(LCDDisplay::c))) {
+        painter->drawLine(100, 60, 100, 90);
+		update();
+	}
+	if(LogicGate::getBoolVoltage(nodeVoltage(LCDDisplay::d))) {
+        painter->drawLine(70, 90, 100, 90);
+		update();
+	}
+	if(LogicGate::getBoolVoltage(nodeVoltage(LCDDisplay::e))) {
+        painter->drawLine(70, 60, 70, 90);
+		update();
+	}
+	if(LogicGate::getBoolVoltage(nodeVoltage(LCDDisplay::f))) {
+        painter->drawLine(70, 30, 70, 60);
+		update();
+	}
+	if(LogicGate::getBoolVoltage(nodeVoltage(LCDDisplay::g))) {
+        painter->drawLine(70, 60, 100, 60);
+		update();
+	}
+
+	// Connection points
+	painter->setPen(penForDots);
+	QPointF in1(1, 30);
+	QPointF in2(1, 50);
+	QPointF in3(1, 70);
+	QPointF in4(1, 90);
+	QPointF in5(1, 110);
+	QPointF in6(1, 130);
+	QPointF in7(1, 150);
+
+	painter->drawPoint(in1);
+	painter->drawPoint(in2);
+	painter->drawPoint(in3);
+	painter->drawPoint(in4);
+	painter->drawPoint(in5);
+	painter->drawPoint(in6);
+	painter->drawPoint(in7);
+
+	// Letters
+    painter->setPen(penForLines);
+    painter->setFont(QFont("Times", 18, QFont::Thin));
+    painter->drawText(in1 + QPointF(20, 5), "a");
+    painter->drawText(in2 + QPointF(20, 5), "b");
+    painter->drawText(in3 + QPointF(20, 5), "c");
+    painter->drawText(in4 + QPointF(20, 5), "d");
+    painter->drawText(in5 + QPointF(20, 5), "e");
+    painter->drawText(in6 + QPointF(20, 5), "f");
+    painter->drawText(in7 + QPointF(20, 5), "g");
+}
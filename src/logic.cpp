@@ -0,0 +1,12 @@
+#include "logic.hpp"
+
+bool Logic::_fourState = false;
+
+char Logic::name(Value value) {
+    switch (value) {
+    case ZERO: return '0';
+    case ONE: return '1';
+    case X: return 'x';
+    default: return 'z';
+    }
+}
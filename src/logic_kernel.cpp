@@ -0,0 +1,210 @@
+#include "logic_kernel.hpp"
+#include "logic.hpp"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define LOGIC_KERNEL_X86
+#include <immintrin.h>
+#endif
+
+//GCC and Clang compile AVX2 functions without -mavx2 and check CPU at runtime
+#if defined(LOGIC_KERNEL_X86) && (defined(__GNUC__) || defined(__clang__))
+#define LOGIC_KERNEL_AVX2
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+LogicKernel::Isa LogicKernel::_active = LogicKernel::best();
+
+namespace {
+
+typedef CompiledLogic::Instruction Instruction;
+
+//Words from 'first' to the end of slot, 64 bits at once
+void runScalar(const Instruction* begin, const Instruction* end, uint64_t* v, unsigned width, unsigned first) {
+    const uint64_t ones = ~uint64_t(0);
+    for (const Instruction* ins = begin; ins != end; ++ins) {
+        const uint64_t* a = v + ins->a * width;
+        const uint64_t* b = v + ins->b * width;
+        uint64_t* out = v + ins->out * width;
+        for (unsigned w = first; w < width; ++w) {
+            switch (ins->op) {
+            case CompiledLogic::AND:  out[w] = a[w] & b[w]; break;
+            case CompiledLogic::OR:   out[w] = a[w] | b[w]; break;
+            case CompiledLogic::XOR:  out[w] = a[w] ^ b[w]; break;
+            case CompiledLogic::NAND: out[w] = ~(a[w] & b[w]); break;
+            case CompiledLogic::NOR:  out[w] = ~(a[w] | b[w]); break;
+            case CompiledLogic::NXOR: out[w] = ones ^ a[w] ^ b[w]; break;
+            case CompiledLogic::NOT:  out[w] = ~a[w]; break;
+            }
+        }
+    }
+}
+
+//Four-state instructions on value and unknown planes, see Logic
+void runPlanes(const Instruction* begin, const Instruction* end, uint64_t* v, uint64_t* u, unsigned width) {
+    for (const Instruction* ins = begin; ins != end; ++ins) {
+        const uint64_t* va = v + ins->a * width;
+        const uint64_t* ua = u + ins->a * width;
+        const uint64_t* vb = v + ins->b * width;
+        const uint64_t* ub = u + ins->b * width;
+        uint64_t* value = v + ins->out * width;
+        uint64_t* unknown = u + ins->out * width;
+        for (unsigned w = 0; w < width; ++w) {
+            switch (ins->op) {
+            case CompiledLogic::AND:
+            case CompiledLogic::NAND:
+                Logic::andPlanes(va[w], ua[w], vb[w], ub[w], value[w], unknown[w]);
+                break;
+            case CompiledLogic::OR:
+            case CompiledLogic::NOR:
+                Logic::orPlanes(va[w], ua[w], vb[w], ub[w], value[w], unknown[w]);
+                break;
+            case CompiledLogic::XOR:
+            case CompiledLogic::NXOR:
+                Logic::xorPlanes(va[w], ua[w], vb[w], ub[w], value[w], unknown[w]);
+                break;
+            case CompiledLogic::NOT:
+                Logic::notPlanes(va[w], ua[w], value[w], unknown[w]);
+                break;
+            }
+            if (ins->op == CompiledLogic::NAND || ins->op == CompiledLogic::NOR || ins->op == CompiledLogic::NXOR) {
+                Logic::notPlanes(value[w], unknown[w], value[w], unknown[w]);
+            }
+        }
+    }
+}
+
+#ifdef LOGIC_KERNEL_X86
+//SSE2 is part of every x86-64 CPU, 32-bit builds check it at runtime
+#if defined(__GNUC__) || defined(__clang__)
+__attribute__((target("sse2")))
+#endif
+void runSse2(const Instruction* begin, const Instruction* end, uint64_t* v, unsigned width, unsigned count) {
+    const __m128i ones = _mm_set1_epi32(-1);
+    for (const Instruction* ins = begin; ins != end; ++ins) {
+        const uint64_t* a = v + ins->a * width;
+        const uint64_t* b = v + ins->b * width;
+        uint64_t* out = v + ins->out * width;
+        for (unsigned w = 0; w < count; w += 2) {
+            __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + w));
+            __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + w));
+            __m128i r;
+            switch (ins->op) {
+            case CompiledLogic::AND:  r = _mm_and_si128(x, y); break;
+            case CompiledLogic::OR:   r = _mm_or_si128(x, y); break;
+            case CompiledLogic::XOR:  r = _mm_xor_si128(x, y); break;
+            case CompiledLogic::NAND: r = _mm_xor_si128(_mm_and_si128(x, y), ones); break;
+            case CompiledLogic::NOR:  r = _mm_xor_si128(_mm_or_si128(x, y), ones); break;
+            case CompiledLogic::NXOR: r = _mm_xor_si128(_mm_xor_si128(x, y), ones); break;
+            default:                  r = _mm_xor_si128(x, ones); break;
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + w), r);
+        }
+    }
+}
+#endif
+
+#ifdef LOGIC_KERNEL_AVX2
+TARGET_AVX2
+void runAvx2(const Instruction* begin, const Instruction* end, uint64_t* v, unsigned width, unsigned count) {
+    const __m256i ones = _mm256_set1_epi32(-1);
+    for (const Instruction* ins = begin; ins != end; ++ins) {
+        const uint64_t* a = v + ins->a * width;
+        const uint64_t* b = v + ins->b * width;
+        uint64_t* out = v + ins->out * width;
+        for (unsigned w = 0; w < count; w += 4) {
+            __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + w));
+            __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + w));
+            __m256i r;
+            switch (ins->op) {
+            case CompiledLogic::AND:  r = _mm256_and_si256(x, y); break;
+            case CompiledLogic::OR:   r = _mm256_or_si256(x, y); break;
+            case CompiledLogic::XOR:  r = _mm256_xor_si256(x, y); break;
+            case CompiledLogic::NAND: r = _mm256_xor_si256(_mm256_and_si256(x, y), ones); break;
+            case CompiledLogic::NOR:  r = _mm256_xor_si256(_mm256_or_si256(x, y), ones); break;
+            case CompiledLogic::NXOR: r = _mm256_xor_si256(_mm256_xor_si256(x, y), ones); break;
+            default:                  r = _mm256_xor_si256(x, ones); break;
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + w), r);
+        }
+    }
+}
+#endif
+
+}
+
+bool LogicKernel::supported(Isa isa) {
+    switch (isa) {
+    case SCALAR:
+        return true;
+#if defined(__x86_64__) || defined(_M_X64)
+    case SSE2:
+        return true;
+#elif defined(LOGIC_KERNEL_X86) && (defined(__GNUC__) || defined(__clang__))
+    case SSE2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("sse2");
+#endif
+#ifdef LOGIC_KERNEL_AVX2
+    case AVX2:
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2");
+#endif
+    default:
+        return false;
+    }
+}
+
+LogicKernel::Isa LogicKernel::best() {
+    if (supported(AVX2)) return AVX2;
+    if (supported(SSE2)) return SSE2;
+    return SCALAR;
+}
+
+LogicKernel::Isa LogicKernel::active() {
+    return _active;
+}
+
+bool LogicKernel::setActive(Isa isa) {
+    if (!supported(isa)) return false;
+    _active = isa;
+    return true;
+}
+
+const char* LogicKernel::name(Isa isa) {
+    switch (isa) {
+    case SSE2: return "sse2";
+    case AVX2: return "avx2";
+    default: return "scalar";
+    }
+}
+
+unsigned LogicKernel::lanes() {
+    switch (_active) {
+    case SSE2: return 2;
+    case AVX2: return 4;
+    default: return 1;
+    }
+}
+
+void LogicKernel::run(const CompiledLogic::Instruction* begin, const CompiledLogic::Instruction* end, uint64_t* words, unsigned width) {
+    //Vector part covers whole vectors, scalar code finishes the rest of every slot
+    unsigned count = width / lanes() * lanes();
+
+#ifdef LOGIC_KERNEL_AVX2
+    if (_active == AVX2 && count > 0) {
+        runAvx2(begin, end, words, width, count);
+    }
+#endif
+#ifdef LOGIC_KERNEL_X86
+    if (_active == SSE2 && count > 0) {
+        runSse2(begin, end, words, width, count);
+    }
+#endif
+    if (_active == SCALAR) count = 0;
+
+    if (count < width) runScalar(begin, end, words, width, count);
+}
+
+void LogicKernel::run(const CompiledLogic::Instruction* begin, const CompiledLogic::Instruction* end, uint64_t* values, uint64_t* unknown, unsigned width) {
+    runPlanes(begin, end, values, unknown, width);
+}
@@ -1,13 +1,15 @@
 #include "mainwindow.h"
+#include "item_factory.h"
+#include "schematic_file.hpp"
 #include <QDebug>
 #include <QFileDialog>
 #include <QFile>
 #include <QMessageBox>
-#include <QJsonArray>
-#include <QJsonObject>
-#include <QJsonDocument>
+#include <QStatusBar>
 #include <QDebug>
 
+#include <memory>
+
 MainWindow::~MainWindow() {}
 
 MainWindow::MainWindow(QWidget *parent) :
@@ -21,20 +23,20 @@ MainWindow::MainWindow(QWidget *parent) :
     createListWidget();
     createSceneAndView();
     createLayout();
+    createSimulationTimer();
+    createWaveformPanel();
 }
 
 void MainWindow::createListWidget() {
     // Creating on left side list of components for dragging
     itemListWidget = new QListWidget;
 
-    QStringList itemList;
-    itemList << "Wire" << "Resistor" << "Ground" <<
-                "DC Voltage" << "Clock" << "Switch" << "AND" << "OR" <<
-                "XOR" << "NAND" << "NOR" <<
-                "NXOR" << "NOT" <<
-                "JK Flip Flop" << "Decoder" << "LCD Display";
-
-    itemListWidget->addItems(itemList);
+    // Items show label of type and carry its kind, drop on scene makes item by kind
+    for (ComponentKind kind : ItemFactory::palette()) {
+        QListWidgetItem* item = new QListWidgetItem(QString::fromStdString(ComponentTypes::get(kind).label));
+        item->setData(Qt::UserRole, static_cast<int>(kind));
+        itemListWidget->addItem(item);
+    }
     itemListWidget->setFixedWidth(120);
 
     itemListWidget->setDragEnabled(true);
@@ -81,9 +83,19 @@ void MainWindow::createLayout(){
     propertiesMessage->setFixedWidth(130);
     frameLayout->addWidget(propertiesMessage);
 
+    // Speed of simulated time
+    speedBox = new QComboBox();
+    speedBox->addItem(tr("Real time"), 1.0);
+    speedBox->addItem(tr("10x slower"), 0.1);
+    speedBox->addItem(tr("10x faster"), 10.0);
+    speedBox->addItem(tr("As fast as possible"), 0.0);
+    speedBox->setFixedWidth(130);
+    connect(this->speedBox, SIGNAL(currentIndexChanged(int)), this, SLOT(onSpeedChanged(int)));
+
     // Layouts
     QVBoxLayout *rightLayout = new QVBoxLayout;
     rightLayout->addWidget(buttonBox);
+    rightLayout->addWidget(speedBox);
     rightLayout->addWidget(propertiesMessage);
     rightLayout->setSpacing(8);
     frameLayout->addLayout(rightLayout);
@@ -91,326 +103,146 @@ void MainWindow::createLayout(){
     setCentralWidget(frame);
 }
 
+void MainWindow::createSimulationTimer() {
+    simulationTimer = new QTimer(this);
+    connect(this->simulationTimer, SIGNAL(timeout()), this, SLOT(onSimulationTimer()));
+    elapsedTimer.start();
+    simulationTimer->start(10);
+}
+
+void MainWindow::createWaveformPanel() {
+    // Panel is docked below the scene, it can be moved to the top or float in its own window
+    waveformPanel = new WaveformPanel(scene);
+    QDockWidget* dock = new QDockWidget(tr("Waveforms"), this);
+    dock->setWidget(waveformPanel);
+    dock->setAllowedAreas(Qt::BottomDockWidgetArea | Qt::TopDockWidgetArea);
+    addDockWidget(Qt::BottomDockWidgetArea, dock);
+}
+
+void MainWindow::onSimulationTimer() {
+    qint64 elapsed = elapsedTimer.restart();
+
+    if (simulationRate > 0) {
+        // Fractions are kept, so slow rates move simulated time too
+        simulationBacklog += elapsed * simulationRate;
+        long long step = static_cast<long long>(simulationBacklog);
+        simulationBacklog -= step;
+        if (Timeline::advanceTo(Timeline::now() + step) > 0) solveAnalog();
+    }
+    else {
+        // As fast as possible, but only for a part of timer interval so GUI stays responsive
+        QElapsedTimer budget;
+        budget.start();
+        bool stepped = false;
+        while (budget.elapsed() < 8 && Timeline::step()) stepped = true;
+        if (stepped) solveAnalog();
+    }
+}
+
+void MainWindow::solveAnalog() {
+    if (!analogSolver || analogSolver->resistors() == 0) return;
+    try {
+        analogSolver->solve();
+    }
+    catch (const std::exception& e) {
+        // Nets keep their voltages, error is shown until next solve or edit
+        statusBar()->showMessage(e.what(), 5000);
+    }
+}
+
+void MainWindow::rebuildAnalog() {
+    // Solver keeps pointers to components, so it can't outlive any of them
+    std::vector<Component*> components;
+    for (QGraphicsItem* item : scene->items()) {
+        ComponentItem* componentItem = dynamic_cast<ComponentItem*>(item);
+        if (item->parentItem() == nullptr && componentItem != nullptr) components.push_back(componentItem->component());
+    }
+    analogSolver.reset(components.empty() ? nullptr : new AnalogSolver(components));
+    solveAnalog();
+}
+
+void MainWindow::onSpeedChanged(int index) {
+    simulationRate = speedBox->itemData(index).toDouble();
+    simulationBacklog = 0;
+}
+
 void MainWindow::onOpenFile() {
     // Open already existing scheme
+    analogSolver.reset();
     this->scene->clear();
+    // Probes are coordinates of nodes, they don't mean anything in other schematic
+    waveformPanel->reset();
     QString filename = QFileDialog::getOpenFileName(
                 this,
                 tr("Open File"),
                 "/Users",
-                "Text File (*.json)"
+                "Schematic (*.json *.psch)"
                 );
 
     qDebug() << filename;
-    QString val;
-    QFile file;
-    file.setFileName(filename);
-    file.open(QIODevice::ReadOnly | QIODevice::Text);
-    val = file.readAll();
-    file.close();
-    QJsonDocument document = QJsonDocument::fromJson(val.toUtf8());
-    QJsonObject data = document.object();
-
-    QJsonArray and_components = data["and"].toArray();
-    std::for_each(and_components.begin(),and_components.end(),[this](QJsonValueRef value){
-        QJsonArray points = value.toArray();
-        ANDGate *gate = new ANDGate();
-        gate->setPos(QPointF(points[0].toInt(),points[1].toInt()));
-        gate->connect(gate->connectionPoints());
-        this->scene->addItem(gate);
-        this->rotateComponent(gate,points[2].toInt());
-    });
-    QJsonArray nand_components = data["nand"].toArray();
-    std::for_each(nand_components.begin(),nand_components.end(),[this](QJsonValueRef value){
-        QJsonArray points = value.toArray();
-        NANDGate *gate = new NANDGate();
-        gate->setPos(QPointF(points[0].toInt(),points[1].toInt()));
-        gate->connect(gate->connectionPoints());
-        this->scene->addItem(gate);
-        this->rotateComponent(gate,points[2].toInt());
-    });
-
-    QJsonArray or_components = data["or"].toArray();
-    std::for_each(or_components.begin(),or_components.end(),[this](QJsonValueRef value){
-        QJsonArray points = value.toArray();
-        ORGate *gate = new ORGate();
-        gate->setPos(QPointF(points[0].toInt(),points[1].toInt()));
-        gate->connect(gate->connectionPoints());
-        this->scene->addItem(gate);
-        this->rotateComponent(gate,points[2].toInt());
-    });
-    QJsonArray nor_components = data["nor"].toArray();
-    std::for_each(nor_components.begin(),nor_components.end(),[this](QJsonValueRef value){
-        QJsonArray points = value.toArray();
-        NORGate *gate = new NORGate();
-        gate->setPos(QPointF(points[0].toInt(),points[1].toInt()));
-        gate->connect(gate->connectionPoints());
-        this->scene->addItem(gate);
-        this->rotateComponent(gate,points[2].toInt());
-    });
-    QJsonArray xor_components = data["xor"].toArray();
-    std::for_each(xor_components.begin(),xor_components.end(),[this](QJsonValueRef value){
-        QJsonArray points = value.toArray();
-        XORGate *gate = new XORGate();
-        gate->setPos(QPointF(points[0].toInt(),points[1].toInt()));
-        gate->connect(gate->connectionPoints());
-        this->scene->addItem(gate);
-        this->rotateComponent(gate,points[2].toInt());
-    });
-    QJsonArray nxor_components = data["nxor"].toArray();
-    std::for_each(nxor_components.begin(),nxor_components.end(),[this](QJsonValueRef value){
-        QJsonArray points = value.toArray();
-        NXORGate *gate = new NXORGate();
-        gate->setPos(QPointF(points[0].toInt(),points[1].toInt()));
-        gate->connect(gate->connectionPoints());
-        this->scene->addItem(gate);
-        this->rotateComponent(gate,points[2].toInt());
-    });
-    QJsonArray not_components = data["not"].toArray();
-    std::for_each(not_components.begin(),not_components.end(),[this](QJsonValueRef value){
-        QJsonArray points = value.toArray();
-        NOTGate *gate = new NOTGate();
-        gate->setPos(QPointF(points[0].toInt(),points[1].toInt()));
-        gate->connect(gate->connectionPoints());
-        this->scene->addItem(gate);
-        this->rotateComponent(gate,points[2].toInt());
-    });
-    QJsonArray lcd_components = data["lcd"].toArray();
-    std::for_each(lcd_components.begin(),lcd_components.end(),[this](QJsonValueRef value){
-        QJsonArray points = value.toArray();
-        LCDDisplay *gate = new LCDDisplay();
-        gate->setPos(QPointF(points[0].toInt(),points[1].toInt()));
-        gate->connect(gate->connectionPoints());
-        this->scene->addItem(gate);
-        this->rotateComponent(gate,points[2].toInt());
-    });
-    QJsonArray decoder_components = data["decoder"].toArray();
-    std::for_each(decoder_components.begin(),decoder_components.end(),[this](QJsonValueRef value){
-        QJsonArray points = value.toArray();
-        Decoder *gate = new Decoder();
-        gate->setPos(QPointF(points[0].toInt(),points[1].toInt()));
-        gate->connect(gate->connectionPoints());
-        this->scene->addItem(gate);
-        this->rotateComponent(gate,points[2].toInt());
-    });
-    QJsonArray flipflop_components = data["flipflop"].toArray();
-    std::for_each(flipflop_components.begin(),flipflop_components.end(),[this](QJsonValueRef value){
-        QJsonArray points = value.toArray();
-        JKFlipFlop *gate = new JKFlipFlop();
-        gate->setPos(QPointF(points[0].toInt(),points[1].toInt()));
-        gate->connect(gate->connectionPoints());
-        this->scene->addItem(gate);
-        this->rotateComponent(gate,points[2].toInt());
-    });
-    QJsonArray switch_components = data["switch"].toArray();
-    std::for_each(switch_components.begin(),switch_components.end(),[this](QJsonValueRef value){
-        QJsonArray points = value.toArray();
-        Switch *gate = new Switch();
-        gate->setPos(QPointF(points[0].toInt(),points[1].toInt()));
-        gate->connect(gate->connectionPoints());
-        if (!points[3].toBool()){
-            gate->close();
+    if (filename.isEmpty()) {
+        return;
+    }
+
+    // Same loader is used by protosim, only components are made here as items of scene.
+    // Loader ends its batch also on error, components loaded before error stay in scene
+    std::vector<ComponentItem*> items;
+    Schematic::Creator create = [this, &items](const ComponentType& type, const ComponentRecord& record) {
+        ComponentItem* item = ItemFactory::create(type.kind, record);
+        items.push_back(item);
+        this->scene->addItem(item);
+        return item->component();
+    };
+    std::string path = filename.toLocal8Bit().toStdString();
+    try {
+        // Binary schematic is mapped and read in place, JSON is parsed to records
+        if (SchematicFile::isBinary(path)) {
+            Schematic::load(SchematicFile(path), batch, create);
+        }
+        else {
+            Schematic::load(Schematic::readFile(path), batch, create);
         }
-        this->scene->addItem(gate);
-        this->rotateComponent(gate,points[2].toInt());
-    });
-    QJsonArray ground_components = data["ground"].toArray();
-    std::for_each(ground_components.begin(),ground_components.end(),[this](QJsonValueRef value){
-        QJsonArray points = value.toArray();
-        Ground *gate = new Ground();
-        gate->setPos(QPointF(points[0].toInt(),points[1].toInt()));
-        gate->connect(gate->connectionPoints());
-        this->scene->addItem(gate);
-        this->rotateComponent(gate,points[2].toInt());
-    });
-    QJsonArray clock_components = data["clock"].toArray();
-    std::for_each(clock_components.begin(),clock_components.end(),[this](QJsonValueRef value){
-        QJsonArray points = value.toArray();
-        Clock *gate = new Clock(5,points[3].toInt());
-        gate->setPos(QPointF(points[0].toInt(),points[1].toInt()));
-        gate->Component::connect(gate->connectionPoints());
-        this->scene->addItem(gate);
-        this->rotateComponent(gate,points[2].toInt());
-    });
-    QJsonArray wire_components= data["wire"].toArray();
-    std::for_each(wire_components.begin(),wire_components.end(),[this](QJsonValueRef value){
-        QJsonArray points = value.toArray();
-        Wire *gate = new Wire();
-        gate->setPos(QPointF(points[0].toInt(),points[1].toInt()));
-        gate->connect(gate->connectionPoints());
-        this->scene->addItem(gate);
-        this->rotateComponent(gate,points[2].toInt());
-        gate->setBoundingRect(points[3].toInt());
-        gate->disconnect();
-        gate->connect(gate->connectionPoints());
-    });
-    QJsonArray voltage_components= data["voltage"].toArray();
-    std::for_each(voltage_components.begin(),voltage_components.end(),[this](QJsonValueRef value){
-        QJsonArray points = value.toArray();
-        DCVoltage *gate = new DCVoltage();
-        gate->setPos(QPointF(points[0].toInt(),points[1].toInt()));
-        gate->connect(gate->connectionPoints());
-        this->scene->addItem(gate);
-        gate->setVoltage(points[3].toInt());
-        this->rotateComponent(gate,points[2].toInt());
-    });
-    QJsonArray resistor_components= data["resistor"].toArray();
-    std::for_each(resistor_components.begin(),resistor_components.end(),[this](QJsonValueRef value){
-        QJsonArray points = value.toArray();
-        Resistor *gate = new Resistor();
-        gate->setPos(QPointF(points[0].toInt(),points[1].toInt()));
-        gate->connect(gate->connectionPoints());
-        this->scene->addItem(gate);
-        gate->setResistance(points[3].toInt());
-        this->rotateComponent(gate,points[2].toInt());
-    });
+    }
+    catch (const std::exception& e) {
+        QMessageBox::warning(this, tr("Open File"), e.what());
+    }
 
+    // Items are moved to placed components
+    for (ComponentItem* item : items) item->updateFromComponent();
+    rebuildAnalog();
 }
 
 void MainWindow::onSaveFile() {
-    // Save the scheme
-    QJsonArray or_components;
-    QJsonArray xor_components;
-    QJsonArray and_components;
-    QJsonArray nand_components;
-    QJsonArray nor_components;
-    QJsonArray nxor_components;
-    QJsonArray not_components;
-    QJsonArray wire_components;
-    QJsonArray dcvoltage_components;
-    QJsonArray clock_components;
-    QJsonArray resistor_components;
-    QJsonArray switch_components;
-    QJsonArray ground_components;
-    QJsonArray flipflop_components;
-    QJsonArray lcd_components;
-    QJsonArray decoder_components;
+    // Save the scheme: every component with its type, position, angle and parameter
+    std::vector<ComponentRecord> records;
     QList<QGraphicsItem*> allItems = scene->items();
     for (int i = 0; i < allItems.size(); ++i) {
-        QGraphicsItem *component = allItems[i];
-        if(component->parentItem() == nullptr){
-            // Save coordinates
-            qreal x = component->x();
-            qreal y = component->y();
-            QJsonArray points;
-            //Add to array in every case
-            //Position
-            points.push_back(x);
-            points.push_back(y);
-            Component *rItem = qgraphicsitem_cast<Component*> (component);
-            //Angle of rotation
-            points.push_back(rItem->rotationAngle());
-            // Find type of component
-            std::string type = rItem->componentType();
-            if (type == "or"){
-                or_components.push_back(points);
-            }
-            if (type == "nor"){
-                nor_components.push_back(points);
-            }
-            if (type == "and"){
-                and_components.push_back(points);
-            }
-            if (type == "nand"){
-                nand_components.push_back(points);
-            }
-            if (type == "xor"){
-                xor_components.push_back(points);
-            }
-            if (type == "nxor"){
-                nxor_components.push_back(points);
-            }
-            if( type == "not"){
-                not_components.push_back(points);
-            }
-            if(type == "voltage"){
-                // Additional information about voltage
-                points.push_back(rItem->voltage());
-                dcvoltage_components.push_back(points);
-            }
-            if(type == "resistor"){
-                //Additional information about resistor
-                Resistor *resistant = static_cast<Resistor*>(rItem);
-                points.push_back(resistant->resistance());
-                resistor_components.push_back(points);
-            }
-            if(type == "clock"){
-                //Additional infomration about clock
-                Clock* clock = static_cast<Clock*>(rItem);
-                points.push_back(clock->timeInterval());
-                clock_components.push_back(points);
-            }
-            if (type == "ground"){
-                ground_components.push_back(points);
-            }
-            if (type == "wire"){
-                Wire *wire = static_cast<Wire*>(rItem);
-                //Information about wire width
-                points.push_back(wire->boundingRect().width());
-                wire_components.push_back(points);
-            }
-            if (type == "switch"){
-                //Additional information about switcher
-                Switch *switcher = static_cast<Switch*>(rItem);
-                points.push_back(switcher->isOpened());
-                switch_components.push_back(points);
-            }
-            if (type == "flipflop"){
-                flipflop_components.push_back(points);
-            }
-            if (type == "lcd"){
-                lcd_components.push_back(points);
-            }
-            if (type == "decoder"){
-                decoder_components.push_back(points);
-            }
-
+        ComponentItem* item = qgraphicsitem_cast<ComponentItem*> (allItems[i]);
+        if (allItems[i]->parentItem() == nullptr && item != nullptr) {
+            records.push_back(Schematic::record(*item->component()));
         }
     }
-    QJsonObject topQuery;
-    //Save in Json format (map)
-    // { type : [ information ]}
-    topQuery["or"] = or_components;
-    topQuery["nor"] = nor_components;
-    topQuery["and"] = and_components;
-    topQuery["nand"] = nand_components;
-    topQuery["xor"] = xor_components;
-    topQuery["nxor"] = nxor_components;
-    topQuery["not"] = not_components;
-    topQuery["clock"] = clock_components;
-    topQuery["wire"] = wire_components;
-    topQuery["ground"] = ground_components;
-    topQuery["voltage"] = dcvoltage_components;
-    topQuery["resistor"] = resistor_components;
-    topQuery["switch"] = switch_components;
-    topQuery["decoder"] = decoder_components;
-    topQuery["lcd"] = lcd_components;
-    topQuery["flipflop"] = flipflop_components;
-    QJsonDocument document(topQuery);
 
     //Set the name of the new file
     //Increase counter
     std::string fileName ="sema" + std::to_string(counterOfFiles++)+".json";
     currentFile = QString(fileName.c_str());
-    saveFile(document);
+    saveFile(records);
 
 }
 
 
-void MainWindow::saveFile(QJsonDocument document) {
-
-    QFile file(currentFile);
-
-    if(file.open(QFile::WriteOnly)) {
-        file.write(document.toJson());
+void MainWindow::saveFile(const std::vector<ComponentRecord>& records) {
+    try {
+        Schematic::writeFile(records, currentFile.toStdString());
     }
-    else {
+    catch (const std::exception& e) {
         QMessageBox::warning(
                     this,
                     "TextEditor",
                     tr("Cannot write file %1.\nError: %2")
                     .arg(currentFile)
-                    .arg(file.errorString())
+                    .arg(e.what())
                     );
     }
 }
@@ -418,6 +250,7 @@ void MainWindow::saveFile(QJsonDocument document) {
 void MainWindow::keyPressEvent(QKeyEvent *event){
     // On pressed escape key window is closed
     if(event->key() == Qt::Key_Escape){
+        analogSolver.reset();
         scene->clear();
         qApp->quit();
     }
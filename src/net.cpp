@@ -0,0 +1,193 @@
+#include "net.hpp"
+#include "components.hpp"
+
+//NOTE: static members are defined in components.cpp, before Node::_allNodes
+
+int NetList::allocate() {
+    int id;
+    if (!_free.empty()) {
+        id = _free.back();
+        _free.pop_back();
+        _sets.isolate(id);
+    } else {
+        id = _sets.add();
+        _voltage.push_back(0);
+        _level.push_back(Logic::floating());
+        _driver.push_back(nullptr);
+        _changed.push_back(Timeline::now());
+        _nodes.emplace_back();
+        _dirty.push_back(false);
+        _dirtySource.push_back(nullptr);
+        _levelChanged.push_back(false);
+    }
+    _level[id] = Logic::floating();
+    ++_size;
+    ++_version;
+    return id;
+}
+
+void NetList::release(int net) {
+    _voltage[net] = 0;
+    _level[net] = 0;
+    _driver[net] = nullptr;
+    _changed[net] = Timeline::now();
+    std::vector<Node*>().swap(_nodes[net]);
+    _dirty[net] = false;
+    _dirtySource[net] = nullptr;
+    _free.push_back(net);
+    --_size;
+    ++_version;
+}
+
+int NetList::create(Node* node) {
+    int id = allocate();
+    _nodes[id].push_back(node);
+    node->_net = id;
+    node->_netIndex = 0;
+    return id;
+}
+
+void NetList::remove(Node* node) {
+    if (node->_net < 0) return;
+
+    int root = find(node->_net);
+    auto& nodes = _nodes[root];
+
+    //Swap with last node, so removal is constant time
+    nodes[node->_netIndex] = nodes.back();
+    nodes[node->_netIndex]->_netIndex = node->_netIndex;
+    nodes.pop_back();
+
+    node->_net = -1;
+    if (nodes.empty()) release(root);
+}
+
+int NetList::merge(Node* a, Node* b) {
+    int ra = find(a->_net);
+    int rb = find(b->_net);
+    if (ra == rb) return ra;
+
+    //If only one net has voltage, joined net takes it (with its driver), otherwise net of 'a' wins
+    int state = doubleEquals(_voltage[ra], 0) ? rb : ra;
+    double v = _voltage[state];
+    const Component* driver = _driver[state];
+    long long changed = _changed[state];
+
+    //Nodes from smaller net are moved to bigger one
+    if (_nodes[ra].size() < _nodes[rb].size()) std::swap(ra, rb);
+    auto& winner = _nodes[ra];
+    auto& loser = _nodes[rb];
+
+    for (auto node : loser) {
+        node->_net = ra;
+        node->_netIndex = static_cast<unsigned>(winner.size());
+        winner.push_back(node);
+    }
+    loser.clear();
+    _voltage[ra] = v;
+    _level[ra] = Logic::fromVoltage(v);
+    _driver[ra] = driver;
+    _changed[ra] = changed;
+    //Drivers of both nets are drivers of joined net now
+    if (Logic::fourState()) resolve(ra);
+    bool dirty = _dirty[rb];
+    const Component* source = _dirtySource[rb];
+
+    _sets.link(rb, ra);
+    release(rb);
+
+    //Id of released net can be reused by new net while scheduler is held, so joined net is queued under its own id
+    if (dirty) Scheduler::scheduleNet(ra, source);
+    return ra;
+}
+
+void NetList::split(int net) {
+    //Take all nodes from net
+    net = find(net);
+    std::vector<Node*> members;
+    members.swap(_nodes[net]);
+    for (auto n : members) n->_net = -1;
+    if (members.empty()) return;
+    release(net);
+
+    //Nodes which are still joined by wires or closed switches make one net
+    std::vector<Node*> stack;
+    for (auto start : members) {
+        if (start->_net >= 0) continue;
+
+        int id = allocate();
+        start->_net = id;
+        start->_netIndex = 0;
+        _nodes[id].push_back(start);
+        stack.push_back(start);
+
+        while (!stack.empty()) {
+            Node* n = stack.back();
+            stack.pop_back();
+
+            for (auto c : n->_components) {
+                if (!c->joinsNets()) continue;
+
+                for (const auto& other : c->nodes()) {
+                    if (other->_net >= 0) continue;
+                    other->_net = id;
+                    other->_netIndex = static_cast<unsigned>(_nodes[id].size());
+                    _nodes[id].push_back(other.get());
+                    stack.push_back(other.get());
+                }
+            }
+        }
+
+        if (Logic::fourState()) resolve(id);
+        Scheduler::scheduleNet(id);
+    }
+}
+
+bool NetList::resolve(int net, const Component* driver) {
+    net = find(net);
+    Logic::Value level = Logic::Z;
+    for (auto node : _nodes[net]) {
+        for (auto c : node->_components) {
+            const auto& pins = c->nodes();
+            for (unsigned pin = 0; pin < pins.size(); ++pin) {
+                if (pins[pin].get() == node) level = Logic::resolve(level, c->drive(pin));
+            }
+        }
+    }
+
+    double v = _voltage[net];
+    if (!Logic::isKnown(level) || Logic::fromVoltage(v) != level) v = Logic::voltage(level);
+    if (level == _level[net] && v == _voltage[net]) return false;
+
+    _voltage[net] = v;
+    if (_watching && _level[net] != level) markLevelChanged(net);
+    _level[net] = level;
+    _driver[net] = driver;
+    _changed[net] = Timeline::now();
+    return true;
+}
+
+void NetList::takeChangedLevels(std::vector<int>& nets) {
+    nets.clear();
+    nets.swap(_changedLevels);
+    for (int net : nets) _levelChanged[net] = false;
+}
+
+void NetList::buildPinIndex() {
+    //Nodes are only in nets which are representatives, other ids get empty range
+    _pinStart.assign(_nodes.size() + 1, 0);
+    _pins.clear();
+    for (size_t id = 0; id < _nodes.size(); ++id) {
+        _pinStart[id] = static_cast<unsigned>(_pins.size());
+        for (auto node : _nodes[id]) {
+            for (auto c : node->_components) {
+                const auto& pins = c->nodes();
+                unsigned pin = 0;
+                while (pin < pins.size() && pins[pin].get() != node) ++pin;
+                _pins.push_back(Pin{c, pin});
+            }
+        }
+    }
+    _pinStart[_nodes.size()] = static_cast<unsigned>(_pins.size());
+    _pinVersion = _version;
+}
@@ -0,0 +1,124 @@
+#include "node_registry.hpp"
+#include "components.hpp"
+
+//Initial capacity, must be power of 2
+static const size_t INITIAL_CAPACITY = 16;
+
+NodeRegistry::NodeRegistry()
+    :_keys(INITIAL_CAPACITY), _slots(INITIAL_CAPACITY),
+    _mask(INITIAL_CAPACITY - 1), _size(0)
+{}
+
+size_t NodeRegistry::hash(uint64_t key) {
+    //splitmix64 finalizer, neighbouring coordinates end up far apart
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ULL;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebULL;
+    key ^= key >> 31;
+    return static_cast<size_t>(key);
+}
+
+size_t NodeRegistry::probe(uint64_t key) const {
+    size_t i = hash(key) & _mask;
+    while (_slots[i] != nullptr && _keys[i] != key) {
+        i = (i + 1) & _mask;
+    }
+    return i;
+}
+
+void NodeRegistry::rehash(size_t capacity) {
+    std::vector<uint64_t> keys(capacity);
+    std::vector<std::shared_ptr<Node>> slots(capacity);
+    keys.swap(_keys);
+    slots.swap(_slots);
+    _mask = _slots.size() - 1;
+
+    for (size_t i = 0; i < slots.size(); ++i) {
+        if (slots[i] != nullptr) {
+            size_t pos = probe(keys[i]);
+            _keys[pos] = keys[i];
+            _slots[pos] = std::move(slots[i]);
+        }
+    }
+}
+
+std::pair<NodeRegistry::iterator, bool> NodeRegistry::insert(const std::shared_ptr<Node>& node) {
+    //Keep load factor under 1/2 so probe sequences stay short
+    if (2 * (_size + 1) > _slots.size()) {
+        rehash(_slots.size() * 2);
+    }
+
+    uint64_t k = key(node->x(), node->y());
+    size_t pos = probe(k);
+    std::shared_ptr<Node>* last = _slots.data() + _slots.size();
+
+    //node already exists
+    if (_slots[pos] != nullptr) {
+        return std::make_pair(iterator(&_slots[pos], last), false);
+    }
+
+    _keys[pos] = k;
+    _slots[pos] = node;
+    ++_size;
+    return std::make_pair(iterator(&_slots[pos], last), true);
+}
+
+NodeRegistry::iterator NodeRegistry::find(int x, int y) {
+    size_t pos = probe(key(x, y));
+    if (_slots[pos] == nullptr) return end();
+    return iterator(&_slots[pos], _slots.data() + _slots.size());
+}
+
+size_t NodeRegistry::erase(const std::shared_ptr<Node>& node) {
+    size_t pos = probe(key(node->x(), node->y()));
+    if (_slots[pos] == nullptr) return 0;
+
+    _slots[pos] = nullptr;
+    --_size;
+
+    /*
+     * Backward shift deletion: move following entries of the cluster
+     * into the hole if the hole is on their probe path,
+     * so there is no need for tombstones
+    */
+    size_t hole = pos;
+    size_t i = (pos + 1) & _mask;
+    while (_slots[i] != nullptr) {
+        size_t home = hash(_keys[i]) & _mask;
+        //distance from home is bigger than distance from hole
+        if (((i - home) & _mask) >= ((i - hole) & _mask)) {
+            _keys[hole] = _keys[i];
+            _slots[hole] = std::move(_slots[i]);
+            _slots[i] = nullptr;
+            hole = i;
+        }
+        i = (i + 1) & _mask;
+    }
+    return 1;
+}
+
+void NodeRegistry::clear() {
+    for (auto& slot : _slots) {
+        slot = nullptr;
+    }
+    _size = 0;
+}
+
+void NodeRegistry::reserve(size_t count) {
+    size_t capacity = _slots.size();
+    while (capacity < 2 * count) capacity *= 2;
+    if (capacity != _slots.size()) rehash(capacity);
+}
+
+NodeRegistry::iterator NodeRegistry::begin() {
+    std::shared_ptr<Node>* first = _slots.data();
+    std::shared_ptr<Node>* last = first + _slots.size();
+    while (first != last && *first == nullptr) ++first;
+    return iterator(first, last);
+}
+
+NodeRegistry::iterator NodeRegistry::end() {
+    std::shared_ptr<Node>* last = _slots.data() + _slots.size();
+    return iterator(last, last);
+}
@@ -0,0 +1,165 @@
+#include "pattern_simulator.hpp"
+#include "log_component.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+const uint64_t ALL = ~uint64_t(0);
+
+//Word of net which keeps its current value in all patterns
+uint64_t constantWord(int net) {
+    return NetList::level(net) == Logic::ONE ? ALL : 0;
+}
+
+//Checks if something except input switches can drive net
+bool driven(int net, const std::vector<Switch*>& switches) {
+    for (const Node* node : NetList::nodes(net)) {
+        for (Component* c : node->directComponents()) {
+            if (c->joinsNets()) continue;
+            if (std::find(switches.begin(), switches.end(), c) != switches.end()) continue;
+
+            const auto& nodes = c->nodes();
+            for (unsigned pin = 0; pin < nodes.size(); ++pin) {
+                if (nodes[pin].get() == node && !c->isInput(pin)) return true;
+            }
+        }
+    }
+    return false;
+}
+
+}
+
+PatternSimulator::PatternSimulator(const std::vector<Component*>& components, const std::vector<Switch*>& inputs, unsigned width)
+    :_logic(components), _width(width), _switches(inputs), _patterns(inputs.size() * width, 0)
+{
+    if (_width == 0) throw std::runtime_error("Error: pattern width can't be 0");
+
+    //Open switches split their nets, so every side gets its own word
+    for (auto s : _switches) {
+        _wasClosed.push_back(s->isClosed());
+        s->open();
+    }
+    try {
+        prepare();
+    }
+    catch (...) {
+        for (size_t i = 0; i < _switches.size(); ++i) {
+            if (_wasClosed[i]) _switches[i]->close();
+        }
+        throw;
+    }
+}
+
+PatternSimulator::~PatternSimulator() {
+    for (size_t i = 0; i < _switches.size(); ++i) {
+        if (_wasClosed[i]) _switches[i]->close();
+    }
+}
+
+void PatternSimulator::prepare() {
+    if (_logic.fallbacks() > 0) {
+        throw std::runtime_error("Error: feedback loops can't be simulated with patterns");
+    }
+
+    _loads.clear();
+    _sources.clear();
+    const auto& inputs = _logic.inputs();
+    for (auto s : _switches) {
+        const auto& nodes = s->nodes();
+        if (nodes.size() != 2) {
+            throw std::runtime_error("Error: input switch " + s->name() + " is not connected");
+        }
+
+        int a = nodes[0]->net();
+        int b = nodes[1]->net();
+        bool sourceA = driven(a, _switches);
+        if (sourceA == driven(b, _switches)) {
+            throw std::runtime_error("Error: input switch " + s->name() + " needs source on one side and gates on the other");
+        }
+        int source = sourceA ? a : b;
+        int load = sourceA ? b : a;
+
+        //Source driven by program would need switch inside program
+        int slot = _logic.slot(source);
+        if (slot >= 0 && std::find(inputs.begin(), inputs.end(), static_cast<unsigned>(slot)) == inputs.end()) {
+            throw std::runtime_error("Error: input switch " + s->name() + " is driven by gate");
+        }
+
+        _loads.push_back(load);
+        _sources.push_back(constantWord(source));
+    }
+    _version = NetList::version();
+}
+
+void PatternSimulator::setPattern(unsigned input, uint64_t word, unsigned index) {
+    if (index >= _width) throw std::out_of_range("Error: pattern word out of range");
+    _patterns.at(input * _width + index) = word;
+}
+
+void PatternSimulator::setCombinations(uint64_t block) {
+    //Patterns 0..63 of every word count in binary through the first six inputs
+    static const uint64_t counter[6] = {
+        0xAAAAAAAAAAAAAAAAull, 0xCCCCCCCCCCCCCCCCull, 0xF0F0F0F0F0F0F0F0ull,
+        0xFF00FF00FF00FF00ull, 0xFFFF0000FFFF0000ull, 0xFFFFFFFF00000000ull
+    };
+    unsigned inputs = _switches.size();
+    for (unsigned j = 0; j < _width; ++j) {
+        //other inputs are bits of word number
+        uint64_t word = block * _width + j;
+        for (unsigned k = 0; k < inputs; ++k) {
+            if (k < 6) _patterns[k * _width + j] = counter[k];
+            else _patterns[k * _width + j] = k - 6 < 64 && ((word >> (k - 6)) & 1) ? ALL : 0;
+        }
+    }
+}
+
+uint64_t PatternSimulator::combinationBlocks() const {
+    if (_switches.size() <= 6) return 1;
+    if (_switches.size() - 6 >= 64) return ~uint64_t(0) / _width + 1;
+    uint64_t words = uint64_t(1) << (_switches.size() - 6);
+    return (words + _width - 1) / _width;
+}
+
+void PatternSimulator::run() {
+    if (_version != NetList::version()) prepare();
+
+    _words.assign(_logic.slots() * _width, 0);
+    for (unsigned s : _logic.inputs()) {
+        std::fill_n(_words.begin() + s * _width, _width, constantWord(_logic.net(s)));
+    }
+
+    //Closed switches join source with load, more switches on the same load make wired OR
+    _loadWords.clear();
+    for (size_t i = 0; i < _switches.size(); ++i) {
+        auto& words = _loadWords[_loads[i]];
+        words.resize(_width, 0);
+        for (unsigned j = 0; j < _width; ++j) {
+            words[j] |= _patterns[i * _width + j] & _sources[i];
+        }
+    }
+    for (const auto& load : _loadWords) {
+        int slot = _logic.slot(load.first);
+        if (slot >= 0) std::copy(load.second.begin(), load.second.end(), _words.begin() + slot * _width);
+    }
+
+    _logic.evaluate(_words, _width);
+}
+
+uint64_t PatternSimulator::output(int x, int y, unsigned index) {
+    if (index >= _width) throw std::out_of_range("Error: pattern word out of range");
+
+    auto node = Node::find(x, y);
+    if (node == Node::_allNodes.end()) {
+        throw std::runtime_error("Error: there is no node (" + std::to_string(x) + ", " + std::to_string(y) + ")");
+    }
+
+    int net = (*node)->net();
+    int slot = _logic.slot(net);
+    if (slot >= 0 && static_cast<size_t>(slot) * _width < _words.size()) return _words[slot * _width + index];
+
+    auto it = _loadWords.find(net);
+    if (it != _loadWords.end()) return it->second[index];
+    return constantWord(net);
+}
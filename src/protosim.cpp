@@ -0,0 +1,590 @@
+/*
+ * protosim - batch simulator for schematic files, without GUI.
+ *
+ * Loads each schematic with the same code as GUI, runs given number of clock cycles
+ * in simulated time and prints voltages of all nets. Voltages after every clock edge
+ * can be written to CSV trace, changes of logic levels to VCD file for waveform viewers
+ * (all of them, or only window around trigger kept in ring buffer).
+ * Truth table of gates driven by switches can be printed instead.
+ * Schematics can be converted between JSON and binary format.
+*/
+#include "schematic.hpp"
+#include "schematic_file.hpp"
+#include "scheduler.hpp"
+#include "node_registry.hpp"
+#include "timeline.hpp"
+#include "compiled_logic.hpp"
+#include "pattern_simulator.hpp"
+#include "logic_kernel.hpp"
+#include "thread_pool.hpp"
+#include "analog_solver.hpp"
+#include "change_feed.hpp"
+#include "vcd_writer.hpp"
+#include "trace_buffer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+    unsigned cycles = 10;
+    //simulated milliseconds per real millisecond, 0 is as fast as possible
+    double rate = 0;
+    bool compile = true;
+    bool truthTable = false;
+    //propagation delay of gates in milliseconds
+    int delay = 0;
+    DelayModel delayModel = DelayModel::INERTIAL;
+    std::string trace;
+    std::string vcd;
+    //nodes whose nets are written to VCD file, all nets if there are none
+    std::vector<std::pair<int, int>> probes;
+    //changes kept in ring buffer instead of writing all of them, 0 writes all
+    size_t ring = 0;
+    //trigger freezes ring buffer, it is on net of node triggerNode if triggerSet
+    bool triggerSet = false;
+    std::pair<int, int> triggerNode;
+    TraceBuffer::Condition triggerCondition = TraceBuffer::Condition::EQUALS;
+    Logic::Value triggerValue = Logic::ONE;
+    long long after = 0;
+    std::string convert;
+};
+
+void usage(std::ostream& out) {
+    out << "Usage: protosim [-n CYCLES] [-r RATE] [-e] [-t TRACE.csv] [-w DUMP.vcd [-p X,Y]... [-R DEPTH [--trigger COND] [--after MS]]] [-T] [-k KERNEL] [-j THREADS] [-x] [-d DELAY [--transport]] [-c OUTPUT] SCHEMATIC.json..." << std::endl
+        << std::endl
+        << "  -n, --cycles N      number of cycles of the fastest clock (default 10)" << std::endl
+        << "  -r, --rate R        speed of simulated time: 0 is as fast as possible (default)," << std::endl
+        << "                      1 is real time, 0.5 is two times slower" << std::endl
+        << "  -e, --event-driven  evaluate every gate on its own, without compiling them" << std::endl
+        << "  -t, --trace FILE    write net voltages after every clock edge or delayed change as CSV" << std::endl
+        << "                      (only with one schematic)" << std::endl
+        << "  -w, --vcd FILE      write changes of logic levels of nets as VCD for waveform viewers" << std::endl
+        << "                      (only with one schematic)" << std::endl
+        << "  -p, --probe X,Y     write only net of node at X,Y to VCD file, can be repeated" << std::endl
+        << "  -R, --ring DEPTH    keep only last DEPTH changes in memory and write them at the end" << std::endl
+        << "      --trigger COND  stop recording (after --after MS) when condition on net of node is met:" << std::endl
+        << "                      X,Y=V net has level V (0, 1, x or z), X,Y^V net changes to V," << std::endl
+        << "                      X,Y~ net toggles" << std::endl
+        << "      --after MS      simulated time recorded after trigger (default 0)" << std::endl
+        << "  -T, --truth-table   print outputs of gates for all combinations of switches," << std::endl
+        << "                      512 combinations are simulated at once" << std::endl
+        << "  -k, --kernel NAME   instructions for truth table: scalar, sse2 or avx2" << std::endl
+        << "                      (default is the best one which CPU supports)" << std::endl
+        << "  -j, --threads N     threads for compiled gates, 0 is one per CPU core (default 1)" << std::endl
+        << "  -x, --four-state    resolve every net from all its drivers: undriven nets are z," << std::endl
+        << "                      conflicting drivers give x" << std::endl
+        << "  -d, --delay MS      propagation delay of gates, flip-flops and decoders (default 0)," << std::endl
+        << "                      changes shorter than delay are swallowed (inertial delay)" << std::endl
+        << "      --transport     gates pass every change, only later (transport delay)" << std::endl
+        << "  -c, --convert FILE  write schematic to FILE instead of simulating it: JSON if name" << std::endl
+        << "                      ends with .json, binary otherwise (only with one schematic)" << std::endl
+        << "  -h, --help          show this help" << std::endl;
+}
+
+//Nets with their nodes, sorted by coordinates so output doesn't depend on net ids
+std::vector<std::vector<Node*>> sortedNets() {
+    std::map<int, std::vector<Node*>> byNet;
+    for (auto& node : Node::_allNodes) {
+        byNet[node->net()].push_back(node.get());
+    }
+
+    auto less = [](const Node* a, const Node* b) {
+        return a->x() < b->x() || (a->x() == b->x() && a->y() < b->y());
+    };
+
+    std::vector<std::vector<Node*>> nets;
+    for (auto& net : byNet) {
+        std::sort(net.second.begin(), net.second.end(), less);
+        nets.push_back(net.second);
+    }
+    std::sort(nets.begin(), nets.end(), [&less](const std::vector<Node*>& a, const std::vector<Node*>& b) {
+        return less(a.front(), b.front());
+    });
+    return nets;
+}
+
+std::string coordinates(const Node* node) {
+    return "(" + std::to_string(node->x()) + "," + std::to_string(node->y()) + ")";
+}
+
+//One column for every net, named by its first node
+class Trace {
+public:
+    Trace(const std::string& path, const std::vector<std::vector<Node*>>& nets)
+        :_out(path)
+    {
+        if (!_out) {
+            throw std::runtime_error("Error: can't write " + path);
+        }
+        _out << "time";
+        for (const auto& net : nets) {
+            _out << "," << net.front()->x() << ":" << net.front()->y();
+            _probes.push_back(net.front());
+        }
+        _out << std::endl;
+    }
+
+    void write(long long time) {
+        _out << time;
+        for (const Node* node : _probes) {
+            if (Logic::fourState()) _out << "," << Logic::name(node->level());
+            else _out << "," << node->v();
+        }
+        _out << std::endl;
+    }
+
+private:
+    std::ofstream _out;
+    std::vector<const Node*> _probes;
+};
+
+/*
+ * Probes of VCD file named by coordinates of first node of net: all nets,
+ * or nets of given nodes. Throws std::runtime_error if there is no node at given coordinates
+*/
+std::vector<VcdWriter::Probe> vcdProbes(const std::vector<std::pair<int, int>>& nodes) {
+    auto name = [](const Node* node) {
+        return "n" + std::to_string(node->x()) + "_" + std::to_string(node->y());
+    };
+
+    std::vector<VcdWriter::Probe> probes;
+    if (nodes.empty()) {
+        for (const auto& net : sortedNets()) probes.push_back(VcdWriter::Probe{name(net.front()), net.front()});
+        return probes;
+    }
+    for (const auto& point : nodes) {
+        auto it = Node::find(point.first, point.second);
+        if (it == Node::_allNodes.end()) {
+            throw std::runtime_error("Error: there is no node at " + std::to_string(point.first) + "," + std::to_string(point.second));
+        }
+        probes.push_back(VcdWriter::Probe{name(it->get()), it->get()});
+    }
+    return probes;
+}
+
+//Ring buffer of all probes in one group, with trigger if it is given
+std::unique_ptr<TraceBuffer> traceBuffer(const Options& options) {
+    std::vector<std::pair<int, int>> nodes = options.probes;
+    if (options.triggerSet && !nodes.empty()) nodes.push_back(options.triggerNode);
+    std::vector<VcdWriter::Probe> probes = vcdProbes(nodes);
+
+    std::unique_ptr<TraceBuffer> ring(new TraceBuffer());
+    ring->addGroup(probes, options.ring);
+    if (!options.triggerSet) return ring;
+
+    auto trigger = Node::find(options.triggerNode.first, options.triggerNode.second);
+    if (trigger == Node::_allNodes.end()) {
+        throw std::runtime_error("Error: there is no node at " + std::to_string(options.triggerNode.first) + "," + std::to_string(options.triggerNode.second));
+    }
+    for (size_t i = 0; i < probes.size(); ++i) {
+        if (probes[i].node->net() != (*trigger)->net()) continue;
+        ring->setTrigger(i, options.triggerCondition, options.triggerValue, options.after);
+        break;
+    }
+    return ring;
+}
+
+/*
+ * Runs clocks in simulated time (milliseconds). Rate 0 is as fast as possible,
+ * 1 is real time, other rates scale real time.
+ * If there is analog solver, resistor networks are solved after every moment.
+ * Simulation stops when ring buffer freezes after its trigger.
+ * Returns simulated duration.
+*/
+long long simulate(unsigned cycles, double rate, Trace* trace, TraceBuffer* ring, AnalogSolver* analog) {
+    Timeline::reset();
+    Scheduler::run();
+    if (analog) analog->solve();
+    if (trace) trace->write(0);
+    ChangeFeed::publish(0);
+
+    /*
+     * Cycle is period of the fastest clock, its first edge is after half of period.
+     * Circuit without clocks can still have delayed changes, they are simulated for cycles of default clock
+    */
+    long long first = Timeline::nextEdgeTime();
+    if (first < 0 && Timeline::nextEventTime() < 0) return 0;
+    if (first < 0) first = Clock().timeInterval();
+    long long end = 2 * first * static_cast<long long>(cycles);
+
+    auto start = std::chrono::steady_clock::now();
+    while (true) {
+        long long next = Timeline::nextEventTime();
+        if (next < 0 || next > end) break;
+
+        if (rate > 0) {
+            std::this_thread::sleep_until(start + std::chrono::duration<double, std::milli>(next / rate));
+        }
+        Timeline::step();
+        if (analog) {
+            analog->solve();
+            //Levels changed by solved voltages belong to the same moment
+            ChangeFeed::publish(Timeline::now());
+        }
+        if (trace) trace->write(Timeline::now());
+        //Window around trigger is recorded, rest of simulation isn't needed
+        if (ring && ring->frozen()) return Timeline::now();
+    }
+    return end;
+}
+
+/*
+ * Prints output of compiled gates for all combinations of switches.
+ * Outputs are nets driven by gates which no other compiled gate reads.
+*/
+void truthTable(Circuit& circuit) {
+    std::vector<Switch*> switches;
+    for (Component* c : circuit.components()) {
+        if (c->kind() == ComponentKind::SWITCH) switches.push_back(static_cast<Switch*>(c));
+    }
+    std::sort(switches.begin(), switches.end(), [](const Switch* a, const Switch* b) {
+        return a->x() < b->x() || (a->x() == b->x() && a->y() < b->y());
+    });
+
+    //8 words per net: two AVX2 or four SSE2 operations per gate
+    const unsigned width = 8;
+    PatternSimulator patterns(circuit.components(), switches, width);
+    CompiledLogic& logic = patterns.logic();
+
+    std::vector<bool> read(logic.slots(), false);
+    for (const auto& ins : logic.program()) {
+        read[ins.a] = read[ins.b] = true;
+    }
+    std::vector<const Node*> outputs;
+    for (const auto& net : sortedNets()) {
+        int slot = logic.slot(net.front()->net());
+        if (slot < 0 || read[slot]) continue;
+        if (std::find(logic.inputs().begin(), logic.inputs().end(), static_cast<unsigned>(slot)) != logic.inputs().end()) continue;
+        outputs.push_back(net.front());
+    }
+
+    for (const Switch* s : switches) std::cout << s->name() << " ";
+    std::cout << "|";
+    for (const Node* node : outputs) std::cout << " " << coordinates(node);
+    std::cout << std::endl;
+
+    //Switch k is bit k of combination number
+    uint64_t combinations = switches.size() < 64 ? uint64_t(1) << switches.size() : ~uint64_t(0);
+    for (uint64_t block = 0; block < patterns.combinationBlocks(); ++block) {
+        patterns.setCombinations(block);
+        patterns.run();
+        std::vector<uint64_t> words;
+        for (const Node* node : outputs) {
+            for (unsigned j = 0; j < width; ++j) words.push_back(patterns.output(node->x(), node->y(), j));
+        }
+
+        for (unsigned p = 0; p < 64 * width && block * 64 * width + p < combinations; ++p) {
+            uint64_t combination = block * 64 * width + p;
+            for (size_t k = 0; k < switches.size(); ++k) {
+                std::cout << std::setw(static_cast<int>(switches[k]->name().size())) << ((combination >> k) & 1) << " ";
+            }
+            std::cout << "|";
+            for (size_t o = 0; o < outputs.size(); ++o) {
+                uint64_t word = words[o * width + p / 64];
+                std::cout << std::setw(static_cast<int>(coordinates(outputs[o]).size()) + 1) << ((word >> (p % 64)) & 1);
+            }
+            std::cout << std::endl;
+        }
+    }
+}
+
+//Writes schematic in other format, JSON and binary files have the same records
+bool convert(const std::string& path, const std::string& output) {
+    try {
+        std::vector<ComponentRecord> records = Schematic::readFile(path);
+        std::string extension = ".json";
+        if (output.size() >= extension.size() && output.compare(output.size() - extension.size(), extension.size(), extension) == 0) {
+            Schematic::writeFile(records, output);
+        }
+        else {
+            SchematicFile::write(records, output);
+        }
+        std::cout << path << ": " << records.size() << " components written to " << output << std::endl;
+    }
+    catch (const std::exception& e) {
+        std::cerr << path << ": " << e.what() << std::endl;
+        return false;
+    }
+    return true;
+}
+
+//Simulates one file, returns false if it can't be loaded or solved
+bool run(const std::string& path, const Options& options) {
+    //Nodes are global, circuit has to be deleted before next file is loaded
+    Circuit circuit;
+    try {
+        //Binary file is mapped and loaded without copy of its records
+        if (SchematicFile::isBinary(path)) {
+            Schematic::load(SchematicFile(path), circuit);
+        }
+        else {
+            Schematic::load(Schematic::readFile(path), circuit);
+        }
+    }
+    catch (const std::exception& e) {
+        std::cerr << path << ": " << e.what() << std::endl;
+        return false;
+    }
+
+    if (options.truthTable) {
+        std::cout << path << ":" << std::endl;
+        truthTable(circuit);
+        return true;
+    }
+
+    //Block is destroyed before circuit, while its gates still exist
+    std::unique_ptr<CompiledLogic> block;
+    if (options.compile) {
+        block.reset(new CompiledLogic(circuit.components()));
+    }
+
+    std::unique_ptr<Trace> trace;
+    if (!options.trace.empty()) {
+        trace.reset(new Trace(options.trace, sortedNets()));
+    }
+
+    std::unique_ptr<VcdWriter> vcd;
+    std::unique_ptr<TraceBuffer> ring;
+    if (!options.vcd.empty() && options.ring > 0) {
+        ring = traceBuffer(options);
+    }
+    else if (!options.vcd.empty()) {
+        vcd.reset(new VcdWriter(options.vcd, vcdProbes(options.probes)));
+    }
+
+    //Resistor networks are solved only if there are some, digital circuits don't need it
+    std::unique_ptr<AnalogSolver> analog(new AnalogSolver(circuit.components()));
+    if (analog->resistors() == 0) analog.reset();
+
+    long long duration;
+    try {
+        duration = simulate(options.cycles, options.rate, trace.get(), ring.get(), analog.get());
+        if (vcd) vcd->close();
+        if (ring) ring->writeVcd(options.vcd);
+    }
+    catch (const std::runtime_error& e) {
+        std::cerr << path << ": " << e.what() << std::endl;
+        return false;
+    }
+
+    auto nets = sortedNets();
+    std::cout << path << ": " << circuit.size() << " components, "
+              << Node::size() << " nodes, " << nets.size() << " nets, "
+              << duration << " ms simulated" << std::endl;
+    if (block) {
+        std::cout << block->program().size() << " gates compiled in " << block->levels() << " levels, "
+                  << block->fallbacks() << " event-driven" << std::endl;
+        if (ThreadPool::threads() > 1) {
+            std::cout << block->tasks() << " tasks in " << block->stages() << " stages on "
+                      << ThreadPool::threads() << " threads" << std::endl;
+        }
+    }
+    if (analog) {
+        std::cout << analog->resistors() << " resistors, " << analog->nets() << " nets solved by DC analysis" << std::endl;
+    }
+    if (Scheduler::oscillating()) {
+        std::cout << "warning: circuit oscillates, iteration limit reached" << std::endl;
+    }
+
+    std::cout << std::fixed << std::setprecision(2);
+    for (const auto& net : nets) {
+        std::cout << std::setw(8) << net.front()->v() << " V ";
+        if (Logic::fourState()) std::cout << Logic::name(net.front()->level()) << " ";
+        for (const Node* node : net) {
+            std::cout << " " << coordinates(node);
+        }
+        std::cout << std::endl;
+    }
+    std::cout.unsetf(std::ios::floatfield);
+    return true;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    std::vector<std::string> files;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help") {
+            usage(std::cout);
+            return 0;
+        }
+        else if ((arg == "-n" || arg == "--cycles") && i + 1 < argc) {
+            char* end;
+            long n = std::strtol(argv[++i], &end, 10);
+            if (*end != '\0' || n < 0) {
+                std::cerr << "protosim: invalid number of cycles " << argv[i] << std::endl;
+                return 1;
+            }
+            options.cycles = static_cast<unsigned>(n);
+        }
+        else if ((arg == "-d" || arg == "--delay") && i + 1 < argc) {
+            char* end;
+            long n = std::strtol(argv[++i], &end, 10);
+            if (*end != '\0' || n < 0) {
+                std::cerr << "protosim: invalid delay " << argv[i] << std::endl;
+                return 1;
+            }
+            options.delay = static_cast<int>(n);
+        }
+        else if (arg == "--transport") {
+            options.delayModel = DelayModel::TRANSPORT;
+        }
+        else if ((arg == "-j" || arg == "--threads") && i + 1 < argc) {
+            char* end;
+            long n = std::strtol(argv[++i], &end, 10);
+            if (*end != '\0' || n < 0) {
+                std::cerr << "protosim: invalid number of threads " << argv[i] << std::endl;
+                return 1;
+            }
+            ThreadPool::setThreads(static_cast<unsigned>(n));
+        }
+        else if (arg == "-T" || arg == "--truth-table") {
+            options.truthTable = true;
+        }
+        else if (arg == "-x" || arg == "--four-state") {
+            Logic::setFourState(true);
+        }
+        else if (arg == "-e" || arg == "--event-driven") {
+            options.compile = false;
+        }
+        else if ((arg == "-r" || arg == "--rate") && i + 1 < argc) {
+            char* end;
+            options.rate = std::strtod(argv[++i], &end);
+            if (*end != '\0' || options.rate < 0) {
+                std::cerr << "protosim: invalid rate " << argv[i] << std::endl;
+                return 1;
+            }
+        }
+        else if ((arg == "-k" || arg == "--kernel") && i + 1 < argc) {
+            std::string name = argv[++i];
+            bool found = false;
+            for (auto isa : {LogicKernel::SCALAR, LogicKernel::SSE2, LogicKernel::AVX2}) {
+                if (name != LogicKernel::name(isa)) continue;
+                found = true;
+                if (!LogicKernel::setActive(isa)) {
+                    std::cerr << "protosim: CPU doesn't support " << name << std::endl;
+                    return 1;
+                }
+            }
+            if (!found) {
+                std::cerr << "protosim: unknown kernel " << name << std::endl;
+                return 1;
+            }
+        }
+        else if ((arg == "-t" || arg == "--trace") && i + 1 < argc) {
+            options.trace = argv[++i];
+        }
+        else if ((arg == "-w" || arg == "--vcd") && i + 1 < argc) {
+            options.vcd = argv[++i];
+        }
+        else if ((arg == "-p" || arg == "--probe") && i + 1 < argc) {
+            int x, y;
+            char rest;
+            if (std::sscanf(argv[++i], "%d,%d%c", &x, &y, &rest) != 2) {
+                std::cerr << "protosim: invalid probe " << argv[i] << std::endl;
+                return 1;
+            }
+            options.probes.emplace_back(x, y);
+        }
+        else if ((arg == "-R" || arg == "--ring") && i + 1 < argc) {
+            char* end;
+            long n = std::strtol(argv[++i], &end, 10);
+            if (*end != '\0' || n <= 0) {
+                std::cerr << "protosim: invalid depth " << argv[i] << std::endl;
+                return 1;
+            }
+            options.ring = static_cast<size_t>(n);
+        }
+        else if (arg == "--trigger" && i + 1 < argc) {
+            int x, y, length = 0;
+            char condition = 0, value = 0;
+            std::string spec = argv[++i];
+            bool valid = std::sscanf(spec.c_str(), "%d,%d%c%n", &x, &y, &condition, &length) == 3;
+            if (valid && condition == '~') {
+                valid = static_cast<size_t>(length) == spec.size();
+                options.triggerCondition = TraceBuffer::Condition::TOGGLES;
+            }
+            else if (valid && (condition == '=' || condition == '^')) {
+                valid = static_cast<size_t>(length) + 1 == spec.size();
+                value = valid ? spec.back() : 0;
+                options.triggerCondition = condition == '=' ? TraceBuffer::Condition::EQUALS : TraceBuffer::Condition::BECOMES;
+            }
+            else {
+                valid = false;
+            }
+            if (valid && condition != '~') {
+                valid = false;
+                for (auto level : {Logic::ZERO, Logic::ONE, Logic::X, Logic::Z}) {
+                    if (Logic::name(level) != value) continue;
+                    options.triggerValue = level;
+                    valid = true;
+                }
+            }
+            if (!valid) {
+                std::cerr << "protosim: invalid trigger " << spec << std::endl;
+                return 1;
+            }
+            options.triggerSet = true;
+            options.triggerNode = std::make_pair(x, y);
+        }
+        else if (arg == "--after" && i + 1 < argc) {
+            char* end;
+            long long n = std::strtoll(argv[++i], &end, 10);
+            if (*end != '\0' || n < 0) {
+                std::cerr << "protosim: invalid time after trigger " << argv[i] << std::endl;
+                return 1;
+            }
+            options.after = n;
+        }
+        else if ((arg == "-c" || arg == "--convert") && i + 1 < argc) {
+            options.convert = argv[++i];
+        }
+        else if (!arg.empty() && arg[0] == '-') {
+            usage(std::cerr);
+            return 1;
+        }
+        else {
+            files.push_back(arg);
+        }
+    }
+
+    if (files.empty() || ((!options.trace.empty() || !options.vcd.empty() || !options.convert.empty()) && files.size() > 1)) {
+        usage(std::cerr);
+        return 1;
+    }
+
+    if (!options.convert.empty()) {
+        return convert(files.front(), options.convert) ? 0 : 2;
+    }
+
+    if (options.delay > 0) Delays::setAll(Delay(options.delay, options.delayModel));
+
+    int status = 0;
+    for (const auto& file : files) {
+        try {
+            if (!run(file, options)) status = 2;
+        }
+        catch (const std::exception& e) {
+            std::cerr << file << ": " << e.what() << std::endl;
+            status = 2;
+        }
+    }
+    return status;
+}
@@ -1,5 +1,6 @@
 #include "scene.h"
-#include "log_component.hpp"
+#include "item_factory.h"
+#include "mainwindow.h"
 
 GridZone::GridZone(QObject* parent) :
     QGraphicsScene(parent), gridSize(10)
@@ -52,112 +53,29 @@ void GridZone::dropEvent(QGraphicsSceneDragDropEvent *event) {
             stream >> row >> col >> valueMap;
 
             if(!valueMap.isEmpty()) {
-                QString componentType = valueMap.value(0).toString();
                 qreal xV = round(event->scenePos().x()/gridSize)*gridSize;
                 qreal yV = round(event->scenePos().y()/gridSize)*gridSize;
 				QPointF newPos(xV, yV);
 
-                if(componentType == "Wire") {
-                    Wire* wire = new Wire();
+                //Palette items carry kind of component
+                ComponentItem* item = nullptr;
+                bool ok = false;
+                int kind = valueMap.value(Qt::UserRole).toInt(&ok);
+                if (ok && kind >= 0 && static_cast<size_t>(kind) < COMPONENT_KINDS) {
+                    item = ItemFactory::create(static_cast<ComponentKind>(kind));
+                }
+
+                if (item != nullptr) {
                     //Set position
-                    wire->setPos(newPos);
+                    item->setPos(newPos);
 
-					//Establish connection
-					wire->connect(wire->connectionPoints());
+                    //Establish connection
+                    item->connect();
 
-					// Add item
-                    this->addItem(wire);
-                }
-				else if(componentType == "Resistor") {
-					Resistor* resistor = new Resistor();
-					resistor->setPos(newPos);
-					resistor->connect(resistor->connectionPoints());
-					this->addItem(resistor);
-                }
-				else if(componentType == "Ground") {
-					Ground* gnd = new Ground();
-					gnd->setPos(newPos);
-					gnd->connect(gnd->connectionPoints());
-					this->addItem(gnd);
-                }
-                else if (componentType == "DC Voltage") {
-                    DCVoltage* dcv = new DCVoltage();
-                    dcv->setPos(newPos);
-					dcv->Component::connect(dcv->connectionPoints());
-                    this->addItem(dcv);
-                }
-				else if (componentType == "Clock") {
-					Clock* cl = new Clock();
-					cl->setPos(newPos);
-					cl->Component::connect(cl->connectionPoints());
-					this->addItem(cl);
-				}
-                else if(componentType == "Switch") {
-                    Switch* sw = new Switch();
-                    sw->setPos(newPos);
-					sw->Component::connect(sw->connectionPoints());
-                    this->addItem(sw);
-                }
-                else if (componentType == "AND") {
-                    ANDGate* andGate = new ANDGate();
-                    andGate->setPos(newPos);
-					andGate->Component::connect(andGate->connectionPoints());
-                    this->addItem(andGate);
-                }
-                else if (componentType == "OR") {
-                    ORGate* orGate = new ORGate();
-                    orGate->setPos(newPos);
-					orGate->Component::connect(orGate->connectionPoints());
-                    this->addItem(orGate);
-                }
-                else if (componentType == "XOR") {
-                    XORGate* xorGate = new XORGate();
-                    xorGate->setPos(newPos);
-					xorGate->Component::connect(xorGate->connectionPoints());
-                    this->addItem(xorGate);
-                }
-                else if (componentType == "NAND") {
-                    NANDGate* nandGate = new NANDGate();
-                    nandGate->setPos(newPos);
-					nandGate->Component::connect(nandGate->connectionPoints());
-                    this->addItem(nandGate);
-                }
-                else if (componentType == "NOR") {
-                    NORGate* norGate = new NORGate();
-                    norGate->setPos(newPos);
-					norGate->Component::connect(norGate->connectionPoints());
-                    this->addItem(norGate);
-                }
-                else if (componentType == "NXOR") {
-                    NXORGate* nxorGate = new NXORGate();
-                    nxorGate->setPos(newPos);
-					nxorGate->Component::connect(nxorGate->connectionPoints());
-                    this->addItem(nxorGate);
-                }
-                else if (componentType == "NOT") {
-                    NOTGate* notGate = new NOTGate();
-                    notGate->setPos(newPos);
-					notGate->Component::connect(notGate->connectionPoints());
-                    this->addItem(notGate);
+                    // Add item
+                    this->addItem(item);
+                    MainWindow::getMainWindow()->rebuildAnalog();
                 }
-				else if (componentType == "JK Flip Flop") {
-					JKFlipFlop* jkFlipFlop = new JKFlipFlop();
-					jkFlipFlop->setPos(newPos);
-					jkFlipFlop->Component::connect(jkFlipFlop->connectionPoints());
-					this->addItem(jkFlipFlop);
-				}
-				else if (componentType == "Decoder") {
-					Decoder* decoder = new Decoder();
-					decoder->setPos(newPos);
-					decoder->Component::connect(decoder->connectionPoints());
-					this->addItem(decoder);
-				}
-				else if (componentType == "LCD Display") {
-					LCDDisplay* lcdDisplay = new LCDDisplay();
-					lcdDisplay->setPos(newPos);
-					lcdDisplay->Component::connect(lcdDisplay->connectionPoints());
-					this->addItem(lcdDisplay);
-				}
 			}
             event->accept();
     }
@@ -168,8 +86,10 @@ void GridZone::keyPressEvent(QKeyEvent *event) {
     // On pressed delete key removing item from scene
     if(event->key() == Qt::Key_Delete) {
         foreach(QGraphicsItem *item, this->selectedItems())
-            if(Component *rItem = qgraphicsitem_cast<Component*> (item))
+            if(ComponentItem *rItem = qgraphicsitem_cast<ComponentItem*> (item))
                 delete item;
         this->clearSelection();
+        // Solver mustn't keep pointers to deleted components
+        MainWindow::getMainWindow()->rebuildAnalog();
     }
 }
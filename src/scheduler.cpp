@@ -0,0 +1,178 @@
+#include "scheduler.hpp"
+#include "components.hpp"
+#include "net.hpp"
+#include "compiled_logic.hpp"
+#include <stdexcept>
+
+std::vector<int> Scheduler::_dirtyNets;
+std::vector<Component*> Scheduler::_queue;
+std::vector<CompiledLogic*> Scheduler::_blocks;
+bool Scheduler::_running = false;
+unsigned Scheduler::_holds = 0;
+bool Scheduler::_oscillating = false;
+unsigned Scheduler::_iterationLimit = 100;
+unsigned Scheduler::_run = 0;
+size_t Scheduler::_evaluations = 0;
+unsigned long Scheduler::_version = 0;
+
+void Scheduler::setIterationLimit(unsigned limit) {
+    if (limit == 0) {
+        throw std::invalid_argument("Iteration limit must be positive");
+    }
+    _iterationLimit = limit;
+}
+
+void Scheduler::hold() {
+    ++_holds;
+}
+
+void Scheduler::release() {
+    if (_holds == 0) {
+        throw std::logic_error("Scheduler is released without hold");
+    }
+    if (--_holds == 0) run();
+}
+
+void Scheduler::schedule(const std::shared_ptr<Node>& node, const Component* source) {
+    if (node == nullptr || node->net() < 0) return;
+    scheduleNet(node->net(), source);
+}
+
+void Scheduler::scheduleNet(int net, const Component* source) {
+    net = NetList::find(net);
+    if (NetList::_dirty[net]) {
+        //net is changed by more components in the same pass, evaluate all of them
+        if (NetList::_dirtySource[net] != source) NetList::_dirtySource[net] = nullptr;
+        return;
+    }
+
+    NetList::_dirty[net] = true;
+    NetList::_dirtySource[net] = source;
+    _dirtyNets.push_back(net);
+}
+
+void Scheduler::evaluate(Component* c) {
+    //Evaluation counter is reset lazily, on first evaluation in new run
+    if (c->_run != _run) {
+        c->_run = _run;
+        c->_evaluations = 0;
+    }
+
+    if (c->_evaluations >= _iterationLimit) {
+        _oscillating = true;
+        return;
+    }
+
+    ++c->_evaluations;
+    ++_evaluations;
+    c->evaluate();
+    c->notifyObserver();
+}
+
+void Scheduler::evaluate(CompiledLogic* block) {
+    if (block->_run != _run) {
+        block->_run = _run;
+        block->_evaluations = 0;
+    }
+
+    if (block->_evaluations >= _iterationLimit) {
+        _oscillating = true;
+        return;
+    }
+
+    ++block->_evaluations;
+    ++_evaluations;
+    block->evaluate();
+}
+
+void Scheduler::enqueue(Component* c, Component* source, unsigned& sourcePins) {
+    if (c == source) {
+        ++sourcePins;
+    } else if (c->_block != nullptr) {
+        //Compiled gates are evaluated by their block, which already evaluated readers of nets it drives
+        CompiledLogic* block = c->_block;
+        if (!block->_queued && (source == nullptr || source->_block != block)) {
+            block->_queued = true;
+            _blocks.push_back(block);
+        }
+    } else if (!c->_queued && !c->_retired) {
+        c->_queued = true;
+        _queue.push_back(c);
+    }
+}
+
+void Scheduler::run() {
+    if (_running || _holds > 0) return;
+
+    //Leaves scheduler in consistent state even if some evaluation throws
+    struct Guard {
+        ~Guard() {
+            for (auto net : _dirtyNets) {
+                net = NetList::find(net);
+                NetList::_dirty[net] = false;
+                NetList::_dirtySource[net] = nullptr;
+            }
+            _dirtyNets.clear();
+            for (auto c : _queue) c->_queued = false;
+            _queue.clear();
+            for (auto b : _blocks) b->_queued = false;
+            _blocks.clear();
+            _running = false;
+            _version = NetList::version();
+        }
+    } guard;
+
+    //Pin index is built only when connections didn't change since last run,
+    //so editing circuit doesn't rebuild it after every change
+    if (!NetList::hasPinIndex() && _version == NetList::version()) NetList::buildPinIndex();
+
+    _running = true;
+    _oscillating = false;
+    _evaluations = 0;
+    ++_run;
+
+    std::vector<int> pass;
+    while (!_dirtyNets.empty()) {
+        //Nets changed during this pass are collected for the next one
+        pass.swap(_dirtyNets);
+
+        for (auto id : pass) {
+            int net = NetList::find(id);
+            //already expanded, net was joined with another dirty net
+            if (!NetList::_dirty[net]) continue;
+
+            NetList::_dirty[net] = false;
+            Component* source = const_cast<Component*>(NetList::_dirtySource[net]);
+            unsigned sourcePins = 0;
+            if (NetList::hasPinIndex()) {
+                for (auto p = NetList::pinsBegin(net); p != NetList::pinsEnd(net); ++p) {
+                    enqueue(p->component, source, sourcePins);
+                }
+            } else {
+                for (auto node : NetList::_nodes[net]) {
+                    for (auto c : node->_components) enqueue(c, source, sourcePins);
+                }
+            }
+            //Source reads the net it drives (e.g. its output is wired to its input), evaluate it again
+            if (sourcePins > 1 && !source->_queued && !source->_retired) {
+                source->_queued = true;
+                _queue.push_back(source);
+            }
+            NetList::_dirtySource[net] = nullptr;
+        }
+        pass.clear();
+
+        for (size_t i = 0; i < _queue.size(); ++i) {
+            Component* c = _queue[i];
+            c->_queued = false;
+            if (!c->_retired) evaluate(c);
+        }
+        _queue.clear();
+
+        for (size_t i = 0; i < _blocks.size(); ++i) {
+            _blocks[i]->_queued = false;
+            evaluate(_blocks[i]);
+        }
+        _blocks.clear();
+    }
+}
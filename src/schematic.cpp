@@ -0,0 +1,283 @@
+#include "schematic.hpp"
+#include "component_type.hpp"
+#include "schematic_file.hpp"
+#include "json.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+const std::vector<std::string>& Schematic::types() {
+    //Same order as GUI always used, wires are connected after components on their ends
+    static const std::vector<std::string> order = [] {
+        std::vector<std::string> names;
+        for (const auto& type : ComponentTypes::all()) names.push_back(type.name);
+        return names;
+    }();
+    return order;
+}
+
+namespace {
+
+//Numbers and booleans (true is 1), other values are skipped and read as 0
+double readNumber(JsonReader& reader) {
+    char c = reader.peek();
+    if (c == 't' || c == 'f') return reader.readBool() ? 1 : 0;
+    if (c == '-' || (c >= '0' && c <= '9')) return reader.readNumber();
+    reader.skipValue();
+    return 0;
+}
+
+}
+
+std::vector<ComponentRecord> Schematic::parse(const std::string& json) {
+    return parse(json.data(), json.data() + json.size());
+}
+
+std::vector<ComponentRecord> Schematic::parse(const char* begin, const char* end) {
+    JsonReader reader(begin, end);
+    if (reader.peek() != '{') {
+        throw std::runtime_error("Error: schematic must be JSON object");
+    }
+
+    //Every record ends with ']', so their number is known before they are read
+    std::vector<ComponentRecord> parsed;
+    parsed.reserve(std::count(begin, end, ']'));
+
+    //Records of every type are read in order of file, then ordered by types(); the last member with the same name wins
+    const auto& order = types();
+    std::vector<std::pair<size_t, size_t>> ranges(order.size(), std::make_pair(0, 0));
+
+    reader.expect('{');
+    if (!reader.accept('}')) {
+        do {
+            if (reader.peek() != '"') reader.error("expected member name");
+            std::string type = reader.readString();
+            reader.expect(':');
+
+            size_t t = std::find(order.begin(), order.end(), type) - order.begin();
+            if (t == order.size() || reader.peek() != '[') {
+                reader.skipValue();
+                continue;
+            }
+
+            size_t first = parsed.size();
+            reader.expect('[');
+            if (!reader.accept(']')) {
+                do {
+                    if (reader.peek() != '[') {
+                        throw std::runtime_error("Error: " + type + " needs [x, y, angle]");
+                    }
+                    reader.expect('[');
+                    double values[4] = {0, 0, 0, 0};
+                    size_t count = 0;
+                    if (!reader.accept(']')) {
+                        do {
+                            double value = readNumber(reader);
+                            if (count < 4) values[count] = value;
+                            ++count;
+                        } while (reader.accept(','));
+                        reader.expect(']');
+                    }
+                    if (count < 3) {
+                        throw std::runtime_error("Error: " + type + " needs [x, y, angle]");
+                    }
+
+                    parsed.emplace_back();
+                    ComponentRecord& record = parsed.back();
+                    record.x = static_cast<int>(values[0]);
+                    record.y = static_cast<int>(values[1]);
+                    record.angle = static_cast<int>(values[2]);
+                    record.hasParameter = count > 3;
+                    record.parameter = values[3];
+                } while (reader.accept(','));
+                reader.expect(']');
+            }
+            ranges[t] = std::make_pair(first, parsed.size());
+        } while (reader.accept(','));
+        reader.expect('}');
+    }
+    reader.expectEnd();
+
+    std::vector<ComponentRecord> records;
+    size_t total = 0;
+    for (const auto& range : ranges) total += range.second - range.first;
+    records.reserve(total);
+    for (size_t t = 0; t < order.size(); ++t) {
+        for (size_t i = ranges[t].first; i < ranges[t].second; ++i) {
+            records.push_back(std::move(parsed[i]));
+            records.back().type = order[t];
+        }
+    }
+    return records;
+}
+
+std::vector<ComponentRecord> Schematic::readFile(const std::string& path) {
+    if (SchematicFile::isBinary(path)) {
+        return SchematicFile(path).records();
+    }
+
+    //Whole text is read at once, parser doesn't copy it again
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        throw std::runtime_error("Error: can't open " + path);
+    }
+    file.seekg(0, std::ios::end);
+    std::string text(static_cast<size_t>(std::max<std::streamoff>(file.tellg(), 0)), '\0');
+    file.seekg(0, std::ios::beg);
+    if (!file.read(&text[0], text.size())) {
+        throw std::runtime_error("Error: can't read " + path);
+    }
+    return parse(text);
+}
+
+namespace {
+
+//Shortest text which is read back as the same number
+std::string number(double value) {
+    char text[32];
+    for (int precision = 15; precision <= 17; ++precision) {
+        std::snprintf(text, sizeof(text), "%.*g", precision, value);
+        if (std::strtod(text, nullptr) == value) break;
+    }
+    return text;
+}
+
+}
+
+std::string Schematic::toJson(const std::vector<ComponentRecord>& records) {
+    //Every known type is written, like GUI does, unknown ones follow them
+    std::vector<std::string> order = types();
+    for (const auto& record : records) {
+        if (std::find(order.begin(), order.end(), record.type) == order.end()) order.push_back(record.type);
+    }
+
+    std::string json = "{";
+    for (size_t t = 0; t < order.size(); ++t) {
+        json += t == 0 ? "\n" : ",\n";
+        json += "    \"" + order[t] + "\": [";
+        bool first = true;
+        for (const auto& record : records) {
+            if (record.type != order[t]) continue;
+            json += first ? "\n" : ",\n";
+            first = false;
+            json += "        [" + std::to_string(record.x) + ", " + std::to_string(record.y) + ", " + std::to_string(record.angle);
+            if (record.hasParameter) json += ", " + number(record.parameter);
+            json += "]";
+        }
+        json += first ? "]" : "\n    ]";
+    }
+    json += "\n}\n";
+    return json;
+}
+
+void Schematic::writeFile(const std::vector<ComponentRecord>& records, const std::string& path) {
+    std::ofstream file(path);
+    if (!file || !(file << toJson(records))) {
+        throw std::runtime_error("Error: can't write " + path);
+    }
+}
+
+Component* Schematic::create(const ComponentRecord& record) {
+    const ComponentType* type = ComponentTypes::find(record.type);
+    return type == nullptr ? nullptr : type->create(record);
+}
+
+void Schematic::place(Component* component, const ComponentRecord& record) {
+    component->setPosition(record.x, record.y);
+    component->orient(record.angle);
+
+    //Parameter is set while component isn't connected, so it doesn't propagate anything yet
+    const ComponentType& type = ComponentTypes::get(component->kind());
+    if (type.load != nullptr) type.load(component, record);
+
+    //Connection points are final, component is connected once
+    component->connect(component->connectionPoints());
+}
+
+ComponentRecord Schematic::record(const Component& component) {
+    const ComponentType& type = ComponentTypes::get(component.kind());
+    ComponentRecord record;
+    record.type = type.name;
+    record.x = static_cast<int>(std::lround(component.x()));
+    record.y = static_cast<int>(std::lround(component.y()));
+    record.angle = component.rotationAngle();
+    if (type.save != nullptr) {
+        record.hasParameter = true;
+        record.parameter = type.save(component);
+    }
+    return record;
+}
+
+namespace {
+
+/*
+ * Builds all components in one batch edit, so voltages are propagated once.
+ * 'record' returns record 'i' and sets its registered type, it throws for unknown type
+*/
+template <class Record>
+void loadRecords(size_t count, const Record& record, Circuit& circuit, const Schematic::Creator& create) {
+    //Most components have two connection points and share them with neighbours
+    Node::_allNodes.reserve(Node::_allNodes.size() + 2 * count);
+
+    circuit.begin();
+    try {
+        const ComponentType* type = nullptr;
+        for (size_t i = 0; i < count; ++i) {
+            const ComponentRecord& r = record(i, type);
+            Schematic::place(create(*type, r), r);
+        }
+    }
+    catch (...) {
+        circuit.commit();
+        throw;
+    }
+    circuit.commit();
+}
+
+//Components of core are kept by circuit
+Schematic::Creator addTo(Circuit& circuit, size_t count) {
+    circuit.reserve(circuit.size() + count);
+    return [&circuit](const ComponentType& type, const ComponentRecord& record) {
+        Component* component = type.create(record);
+        circuit.addComponent(component);
+        return component;
+    };
+}
+
+}
+
+void Schematic::load(const std::vector<ComponentRecord>& records, Circuit& circuit) {
+    load(records, circuit, addTo(circuit, records.size()));
+}
+
+void Schematic::load(const SchematicFile& file, Circuit& circuit) {
+    load(file, circuit, addTo(circuit, file.size()));
+}
+
+void Schematic::load(const std::vector<ComponentRecord>& records, Circuit& circuit, const Creator& create) {
+    loadRecords(records.size(), [&records](size_t i, const ComponentType*& type) -> const ComponentRecord& {
+        //Records are grouped by type, name is compared only with previous type
+        type = ComponentTypes::find(records[i].type, type);
+        if (type == nullptr) {
+            throw std::runtime_error("Error: unknown component type " + records[i].type);
+        }
+        return records[i];
+    }, circuit, create);
+}
+
+void Schematic::load(const SchematicFile& file, Circuit& circuit, const Creator& create) {
+    //Only one record is copied at a time
+    ComponentRecord current;
+    loadRecords(file.size(), [&file, &current](size_t i, const ComponentType*& type) -> const ComponentRecord& {
+        type = file.componentType(i);
+        if (type == nullptr) {
+            throw std::runtime_error("Error: unknown component type " + file.type(i));
+        }
+        current = file.record(i);
+        return current;
+    }, circuit, create);
+}
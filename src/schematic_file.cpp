@@ -0,0 +1,199 @@
+#include "schematic_file.hpp"
+#include "component_type.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char MAGIC[4] = {'P', 'S', 'C', 'H'};
+const size_t TYPE_NAME = 16;
+
+struct Header {
+    char magic[4];
+    uint32_t version;
+    uint32_t types;
+    uint32_t components;
+};
+
+static_assert(sizeof(Header) == 16, "header of binary schematic must have 16 bytes");
+static_assert(sizeof(SchematicFile::Entry) == 16, "entry of binary schematic must have 16 bytes");
+
+bool littleEndian() {
+    uint16_t one = 1;
+    char first;
+    std::memcpy(&first, &one, 1);
+    return first == 1;
+}
+
+}
+
+SchematicFile::SchematicFile(const std::string& path) {
+    if (!littleEndian()) {
+        throw std::runtime_error("Error: binary schematics can be read only on little-endian CPU");
+    }
+
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    struct stat info;
+    if (fd < 0 || ::fstat(fd, &info) != 0) {
+        if (fd >= 0) ::close(fd);
+        throw std::runtime_error("Error: can't open " + path);
+    }
+    _length = static_cast<size_t>(info.st_size);
+    if (_length > 0) {
+        void* map = ::mmap(nullptr, _length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map != MAP_FAILED) {
+            _data = static_cast<const char*>(map);
+            _mapped = true;
+        }
+    }
+    ::close(fd);
+#endif
+    if (!_mapped) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("Error: can't open " + path);
+        }
+        _buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        _data = _buffer.data();
+        _length = _buffer.size();
+    }
+
+    //Sizes are checked before anything is read from tables
+    try {
+        Header header;
+        if (_length < sizeof(header)) {
+            throw std::runtime_error("Error: " + path + " is not binary schematic");
+        }
+        std::memcpy(&header, _data, sizeof(header));
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) {
+            throw std::runtime_error("Error: " + path + " is not binary schematic");
+        }
+        if (header.version != VERSION) {
+            throw std::runtime_error("Error: " + path + " has unsupported version " + std::to_string(header.version));
+        }
+
+        _count = header.components;
+        size_t types = sizeof(header);
+        size_t entries = types + TYPE_NAME * header.types;
+        size_t parameters = entries + sizeof(Entry) * _count;
+        if (_length < parameters + sizeof(double) * _count) {
+            throw std::runtime_error("Error: " + path + " is truncated");
+        }
+
+        for (uint32_t t = 0; t < header.types; ++t) {
+            const char* name = _data + types + TYPE_NAME * t;
+            _types.emplace_back(name, std::find(name, name + TYPE_NAME, '\0'));
+            _registered.push_back(ComponentTypes::find(_types.back()));
+        }
+        _entries = reinterpret_cast<const Entry*>(_data + entries);
+        _parameters = reinterpret_cast<const double*>(_data + parameters);
+        for (size_t i = 0; i < _count; ++i) {
+            if (_entries[i].type >= _types.size()) {
+                throw std::runtime_error("Error: " + path + " has component of unknown type");
+            }
+        }
+    }
+    catch (...) {
+#ifndef _WIN32
+        if (_mapped) ::munmap(const_cast<char*>(_data), _length);
+#endif
+        throw;
+    }
+}
+
+SchematicFile::~SchematicFile() {
+#ifndef _WIN32
+    if (_mapped) ::munmap(const_cast<char*>(_data), _length);
+#endif
+}
+
+bool SchematicFile::isBinary(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    char magic[sizeof(MAGIC)];
+    return file.read(magic, sizeof(magic)) && std::memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+void SchematicFile::write(const std::vector<ComponentRecord>& records, const std::string& path) {
+    if (!littleEndian()) {
+        throw std::runtime_error("Error: binary schematics can be written only on little-endian CPU");
+    }
+
+    //Known types keep their order, others are added after them
+    std::vector<std::string> types = Schematic::types();
+    std::vector<Entry> entries;
+    std::vector<double> parameters;
+    entries.reserve(records.size());
+    parameters.reserve(records.size());
+    for (const auto& record : records) {
+        size_t type = 0;
+        while (type < types.size() && types[type] != record.type) ++type;
+        if (type == types.size()) {
+            if (record.type.size() > TYPE_NAME) {
+                throw std::runtime_error("Error: type name " + record.type + " is too long for binary schematic");
+            }
+            types.push_back(record.type);
+        }
+
+        Entry entry;
+        entry.type = static_cast<uint16_t>(type);
+        entry.flags = record.hasParameter ? HAS_PARAMETER : 0;
+        entry.x = record.x;
+        entry.y = record.y;
+        entry.angle = record.angle;
+        entries.push_back(entry);
+        parameters.push_back(record.parameter);
+    }
+
+    Header header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.types = static_cast<uint32_t>(types.size());
+    header.components = static_cast<uint32_t>(entries.size());
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        throw std::runtime_error("Error: can't write " + path);
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (const auto& type : types) {
+        char name[TYPE_NAME] = {};
+        std::memcpy(name, type.data(), type.size());
+        file.write(name, TYPE_NAME);
+    }
+    file.write(reinterpret_cast<const char*>(entries.data()), sizeof(Entry) * entries.size());
+    file.write(reinterpret_cast<const char*>(parameters.data()), sizeof(double) * parameters.size());
+    if (!file) {
+        throw std::runtime_error("Error: can't write " + path);
+    }
+}
+
+ComponentRecord SchematicFile::record(size_t i) const {
+    const Entry& entry = _entries[i];
+    ComponentRecord record;
+    record.type = _types[entry.type];
+    record.x = entry.x;
+    record.y = entry.y;
+    record.angle = entry.angle;
+    record.hasParameter = (entry.flags & HAS_PARAMETER) != 0;
+    record.parameter = _parameters[i];
+    return record;
+}
+
+std::vector<ComponentRecord> SchematicFile::records() const {
+    std::vector<ComponentRecord> records;
+    records.reserve(_count);
+    for (size_t i = 0; i < _count; ++i) records.push_back(record(i));
+    return records;
+}
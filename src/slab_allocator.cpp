@@ -0,0 +1,74 @@
+#include "slab_allocator.hpp"
+
+#include <vector>
+
+namespace {
+
+struct Piece {
+    Piece* next;
+};
+
+struct Pools {
+    //free list for every size class
+    std::vector<Piece*> free = std::vector<Piece*>(SlabAllocator::MAX_SIZE / SlabAllocator::ALIGNMENT + 1, nullptr);
+    size_t slabs = 0;
+    size_t used = 0;
+};
+
+//Never destroyed: static nodes and components can be freed after other statics
+Pools& pools() {
+    static Pools* instance = new Pools();
+    return *instance;
+}
+
+size_t sizeClass(size_t size) {
+    return (size + SlabAllocator::ALIGNMENT - 1) / SlabAllocator::ALIGNMENT;
+}
+
+}
+
+void* SlabAllocator::allocate(size_t size) {
+    if (size == 0 || size > MAX_SIZE) return ::operator new(size);
+
+    Pools& p = pools();
+    size_t c = sizeClass(size);
+    if (p.free[c] == nullptr) {
+        //New slab is split into pieces which are linked in free list
+        size_t piece = c * ALIGNMENT;
+        char* slab = static_cast<char*>(::operator new(SLAB_SIZE));
+        ++p.slabs;
+        for (size_t offset = SLAB_SIZE / piece * piece; offset >= piece; offset -= piece) {
+            Piece* free = reinterpret_cast<Piece*>(slab + offset - piece);
+            free->next = p.free[c];
+            p.free[c] = free;
+        }
+    }
+
+    Piece* piece = p.free[c];
+    p.free[c] = piece->next;
+    ++p.used;
+    return piece;
+}
+
+void SlabAllocator::deallocate(void* ptr, size_t size) {
+    if (ptr == nullptr) return;
+    if (size == 0 || size > MAX_SIZE) {
+        ::operator delete(ptr);
+        return;
+    }
+
+    Pools& p = pools();
+    size_t c = sizeClass(size);
+    Piece* piece = static_cast<Piece*>(ptr);
+    piece->next = p.free[c];
+    p.free[c] = piece;
+    --p.used;
+}
+
+size_t SlabAllocator::slabs() {
+    return pools().slabs;
+}
+
+size_t SlabAllocator::used() {
+    return pools().used;
+}
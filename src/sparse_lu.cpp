@@ -0,0 +1,248 @@
+#include "sparse_lu.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+//Parts smaller than this are not split anymore
+const size_t SMALL_PART = 32;
+
+/*
+ * Nested dissection ordering of matrix graph.
+ * Graph is split by separator into two parts which are not connected, both parts are
+ * ordered first (recursively) and separator last, so elimination of one part never
+ * fills positions in the other one. Separator is middle level of breadth-first search
+ * from pseudo-peripheral node, which works well for meshes and chains of resistors.
+*/
+class Dissection {
+public:
+    Dissection(size_t n, const std::vector<size_t>& columns, const std::vector<unsigned>& rows)
+        :_columns(columns), _rows(rows), _label(n, 0), _level(n, 0), _seen(n, 0)
+    {
+        std::vector<unsigned> nodes(n);
+        for (unsigned i = 0; i < n; ++i) nodes[i] = i;
+        _order.reserve(n);
+        dissect(nodes, 0);
+    }
+
+    const std::vector<unsigned>& order() const {
+        return _order;
+    }
+
+private:
+    //Orders nodes, all of them have label 'label'
+    void dissect(std::vector<unsigned>& nodes, int label) {
+        if (nodes.size() <= SMALL_PART) {
+            append(nodes);
+            return;
+        }
+
+        std::vector<unsigned> visited;
+        bfs(nodes[0], label, visited);
+        if (visited.size() < nodes.size()) {
+            //Every connected component is ordered on its own
+            std::vector<std::vector<unsigned>> components;
+            for (unsigned v : nodes) {
+                if (_label[v] != label) continue;
+                bfs(v, label, visited);
+                int part = ++_labels;
+                for (unsigned w : visited) _label[w] = part;
+                components.push_back(visited);
+            }
+            for (auto& component : components) dissect(component, _label[component[0]]);
+            return;
+        }
+
+        //The last node of search is far from start, search from it gives long and narrow levels
+        bfs(visited.back(), label, visited);
+        unsigned levels = _level[visited.back()] + 1;
+        if (levels < 3) {
+            append(nodes);
+            return;
+        }
+
+        //Separator is the smallest level which leaves at least third of nodes on both sides, or the middle one
+        std::vector<size_t> count(levels, 0);
+        for (unsigned v : visited) ++count[_level[v]];
+        unsigned middle = 0;
+        size_t before = count[0];
+        for (unsigned l = 1; l + 1 < levels; before += count[l], ++l) {
+            size_t after = nodes.size() - before - count[l];
+            if (3 * before < nodes.size()) continue;
+            if (3 * after < nodes.size()) {
+                if (middle == 0) middle = l;
+                break;
+            }
+            if (middle == 0 || count[l] < count[middle]) middle = l;
+        }
+        if (middle == 0) middle = levels / 2;
+
+        std::vector<unsigned> first, second, separator;
+        for (unsigned v : visited) {
+            if (_level[v] < middle) first.push_back(v);
+            else if (_level[v] > middle) second.push_back(v);
+            else if (touchesLevel(v, label, middle + 1)) separator.push_back(v);
+            //node without neighbours behind separator belongs to the first part
+            else first.push_back(v);
+        }
+
+        int a = ++_labels, b = ++_labels;
+        for (unsigned v : first) _label[v] = a;
+        for (unsigned v : second) _label[v] = b;
+        for (unsigned v : separator) _label[v] = -1;
+        dissect(first, a);
+        dissect(second, b);
+        append(separator);
+    }
+
+    //Breadth-first search inside nodes with label, fills level of every visited node
+    void bfs(unsigned start, int label, std::vector<unsigned>& visited) {
+        ++_stamp;
+        visited.clear();
+        visited.push_back(start);
+        _seen[start] = _stamp;
+        _level[start] = 0;
+        for (size_t k = 0; k < visited.size(); ++k) {
+            unsigned v = visited[k];
+            for (size_t p = _columns[v]; p < _columns[v + 1]; ++p) {
+                unsigned w = _rows[p];
+                if (_label[w] != label || _seen[w] == _stamp) continue;
+                _seen[w] = _stamp;
+                _level[w] = _level[v] + 1;
+                visited.push_back(w);
+            }
+        }
+    }
+
+    //Checks if node has neighbour at given level of the last search
+    bool touchesLevel(unsigned v, int label, unsigned level) const {
+        for (size_t p = _columns[v]; p < _columns[v + 1]; ++p) {
+            unsigned w = _rows[p];
+            if (_label[w] == label && _seen[w] == _stamp && _level[w] == level) return true;
+        }
+        return false;
+    }
+
+    void append(const std::vector<unsigned>& nodes) {
+        for (unsigned v : nodes) {
+            _label[v] = -1;
+            _order.push_back(v);
+        }
+    }
+
+    const std::vector<size_t>& _columns;
+    const std::vector<unsigned>& _rows;
+    std::vector<int> _label;
+    std::vector<unsigned> _level;
+    std::vector<unsigned> _seen;
+    unsigned _stamp = 0;
+    int _labels = 0;
+    std::vector<unsigned> _order;
+};
+
+}
+
+void SparseLU::analyze(size_t n, const std::vector<size_t>& columns, const std::vector<unsigned>& rows) {
+    if (columns.size() != n + 1 || rows.size() != columns[n]) {
+        throw std::invalid_argument("Error: wrong size of sparse matrix");
+    }
+    _n = n;
+    _columns = columns;
+    _rows = rows;
+
+    _order = Dissection(n, columns, rows).order();
+    _position.resize(n);
+    for (unsigned k = 0; k < n; ++k) _position[_order[k]] = k;
+
+    //Elimination tree and number of values in every column of L
+    _parent.assign(n, -1);
+    std::vector<size_t> count(n, 0);
+    std::vector<unsigned> flag(n);
+    for (unsigned k = 0; k < n; ++k) {
+        flag[k] = k;
+        unsigned column = _order[k];
+        for (size_t p = columns[column]; p < columns[column + 1]; ++p) {
+            unsigned i = _position[rows[p]];
+            if (i >= k) continue;
+            //Row k of L has values in columns on path from i to k in the tree
+            for (; flag[i] != k; i = _parent[i]) {
+                if (_parent[i] == -1) _parent[i] = k;
+                ++count[i];
+                flag[i] = k;
+            }
+        }
+    }
+
+    _lColumns.assign(n + 1, 0);
+    for (size_t k = 0; k < n; ++k) _lColumns[k + 1] = _lColumns[k] + count[k];
+    _lRows.assign(_lColumns[n], 0);
+    _lValues.assign(_lColumns[n], 0);
+    _diagonal.assign(n, 0);
+}
+
+bool SparseLU::factorize(const std::vector<double>& values) {
+    if (values.size() != _rows.size()) {
+        throw std::invalid_argument("Error: wrong number of values for sparse matrix");
+    }
+
+    //Row k of L is found by sparse triangular solve with rows 0..k-1, its pattern is path in elimination tree
+    std::vector<double> y(_n, 0);
+    std::vector<unsigned> pattern(_n), flag(_n);
+    std::vector<size_t> filled(_n, 0);
+    for (unsigned k = 0; k < _n; ++k) {
+        size_t top = _n;
+        flag[k] = k;
+        unsigned column = _order[k];
+        for (size_t p = _columns[column]; p < _columns[column + 1]; ++p) {
+            unsigned i = _position[_rows[p]];
+            if (i > k) continue;
+            y[i] += values[p];
+            size_t length = 0;
+            for (; flag[i] != k; i = _parent[i]) {
+                pattern[length++] = i;
+                flag[i] = k;
+            }
+            while (length > 0) pattern[--top] = pattern[--length];
+        }
+
+        double d = y[k];
+        y[k] = 0;
+        for (; top < _n; ++top) {
+            unsigned i = pattern[top];
+            double yi = y[i];
+            y[i] = 0;
+            size_t end = _lColumns[i] + filled[i];
+            for (size_t p = _lColumns[i]; p < end; ++p) {
+                y[_lRows[p]] -= _lValues[p] * yi;
+            }
+            double l = yi / _diagonal[i];
+            d -= l * yi;
+            _lRows[end] = k;
+            _lValues[end] = l;
+            ++filled[i];
+        }
+        if (d == 0) return false;
+        _diagonal[k] = d;
+    }
+    return true;
+}
+
+void SparseLU::solve(std::vector<double>& b) const {
+    std::vector<double> x(_n);
+    for (size_t k = 0; k < _n; ++k) x[k] = b[_order[k]];
+
+    for (size_t j = 0; j < _n; ++j) {
+        for (size_t p = _lColumns[j]; p < _lColumns[j + 1]; ++p) {
+            x[_lRows[p]] -= _lValues[p] * x[j];
+        }
+    }
+    for (size_t j = 0; j < _n; ++j) x[j] /= _diagonal[j];
+    for (size_t j = _n; j-- > 0;) {
+        for (size_t p = _lColumns[j]; p < _lColumns[j + 1]; ++p) {
+            x[j] -= _lValues[p] * x[_lRows[p]];
+        }
+    }
+
+    for (size_t k = 0; k < _n; ++k) b[_order[k]] = x[k];
+}
@@ -0,0 +1,184 @@
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+//Set in tasks, so nested run doesn't wait for threads which are busy with the outer one
+thread_local bool insideTask = false;
+
+struct Queue {
+    std::mutex mutex;
+    std::deque<size_t> tasks;
+};
+
+class Pool {
+public:
+    ~Pool() {
+        stop();
+    }
+
+    void start(unsigned threads) {
+        stop();
+        _queues.clear();
+        for (unsigned i = 0; i < threads; ++i) _queues.emplace_back(new Queue());
+        _stop = false;
+        //Queue 0 belongs to caller of run
+        for (unsigned i = 1; i < threads; ++i) {
+            _workers.emplace_back(&Pool::work, this, i);
+        }
+    }
+
+    unsigned threads() const {
+        return _queues.empty() ? 1 : static_cast<unsigned>(_queues.size());
+    }
+
+    void run(size_t count, const std::function<void(size_t)>& task) {
+        /*
+         * Job is set before any of its tasks is in queue: worker which wakes late for previous job
+         * can find tasks of this one, and then it has to run them with this task and count
+        */
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _task = &task;
+            _error = nullptr;
+            _remaining = count;
+            ++_job;
+        }
+
+        //Every thread starts with its own continuous range, neighbouring tasks usually share data
+        unsigned n = threads();
+        for (unsigned i = 0; i < n; ++i) {
+            std::lock_guard<std::mutex> lock(_queues[i]->mutex);
+            for (size_t t = count * i / n; t < count * (i + 1) / n; ++t) {
+                _queues[i]->tasks.push_back(t);
+            }
+        }
+        _wake.notify_all();
+
+        process(0);
+
+        //Task stays set after job, late worker finds only empty queues and never calls it
+        std::unique_lock<std::mutex> lock(_mutex);
+        _done.wait(lock, [this] { return _remaining == 0 && _working == 0; });
+        if (_error) std::rethrow_exception(_error);
+    }
+
+private:
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _wake.notify_all();
+        for (auto& worker : _workers) worker.join();
+        _workers.clear();
+    }
+
+    void work(unsigned id) {
+        std::unique_lock<std::mutex> lock(_mutex);
+        unsigned long seen = _job;
+        while (true) {
+            _wake.wait(lock, [this, seen] { return _stop || _job != seen; });
+            if (_stop) return;
+            seen = _job;
+
+            ++_working;
+            lock.unlock();
+            process(id);
+            lock.lock();
+            --_working;
+            if (_remaining == 0 && _working == 0) _done.notify_all();
+        }
+    }
+
+    //Runs tasks from own queue, then steals from others until all queues are empty
+    void process(unsigned id) {
+        size_t t;
+        while (pop(id, t, false) || steal(id, t)) {
+            insideTask = true;
+            try {
+                (*_task)(t);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (!_error) _error = std::current_exception();
+            }
+            insideTask = false;
+
+            if (--_remaining == 0) {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _done.notify_all();
+            }
+        }
+    }
+
+    bool pop(unsigned id, size_t& task, bool back) {
+        Queue& queue = *_queues[id];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.tasks.empty()) return false;
+        if (back) {
+            task = queue.tasks.back();
+            queue.tasks.pop_back();
+        }
+        else {
+            task = queue.tasks.front();
+            queue.tasks.pop_front();
+        }
+        return true;
+    }
+
+    bool steal(unsigned id, size_t& task) {
+        unsigned n = threads();
+        for (unsigned k = 1; k < n; ++k) {
+            if (pop((id + k) % n, task, true)) return true;
+        }
+        return false;
+    }
+
+    std::vector<std::thread> _workers;
+    std::vector<std::unique_ptr<Queue>> _queues;
+
+    std::mutex _mutex;
+    std::condition_variable _wake, _done;
+    const std::function<void(size_t)>* _task = nullptr;
+    std::exception_ptr _error;
+    std::atomic<size_t> _remaining{0};
+    unsigned _working = 0;
+    unsigned long _job = 0;
+    bool _stop = false;
+};
+
+Pool& pool() {
+    static Pool instance;
+    return instance;
+}
+
+}
+
+void ThreadPool::setThreads(unsigned threads) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    if (threads == pool().threads()) return;
+    pool().start(threads);
+}
+
+unsigned ThreadPool::threads() {
+    return pool().threads();
+}
+
+void ThreadPool::run(size_t count, const std::function<void(size_t)>& task) {
+    if (count == 0) return;
+    if (count == 1 || threads() == 1 || insideTask) {
+        for (size_t t = 0; t < count; ++t) task(t);
+        return;
+    }
+    pool().run(count, task);
+}
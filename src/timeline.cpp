@@ -0,0 +1,114 @@
+#include "timeline.hpp"
+#include "change_feed.hpp"
+#include "components.hpp"
+#include "delay.hpp"
+#include "scheduler.hpp"
+
+#include <algorithm>
+
+long long Timeline::_now = 0;
+unsigned long long Timeline::_nextId = 0;
+std::priority_queue<Timeline::Event, std::vector<Timeline::Event>, std::greater<Timeline::Event>> Timeline::_events;
+std::unordered_map<Clock*, unsigned long long> Timeline::_clocks;
+
+void Timeline::schedule(Clock* clock) {
+    push(clock, _now + clock->timeInterval());
+}
+
+void Timeline::remove(Clock* clock) {
+    _clocks.erase(clock);
+}
+
+void Timeline::push(Clock* clock, long long time) {
+    if (clock->timeInterval() <= 0) {
+        _clocks[clock] = 0;
+        return;
+    }
+    unsigned long long id = ++_nextId;
+    _clocks[clock] = id;
+    _events.push(Event{time, id, clock});
+}
+
+void Timeline::discardStale() {
+    while (!_events.empty()) {
+        const Event& e = _events.top();
+        auto it = _clocks.find(e.clock);
+        if (it != _clocks.end() && it->second == e.id) return;
+        _events.pop();
+    }
+}
+
+long long Timeline::nextEdgeTime() {
+    discardStale();
+    return _events.empty() ? -1 : _events.top().time;
+}
+
+long long Timeline::nextEventTime() {
+    long long edge = nextEdgeTime();
+    long long change = Delays::nextTime();
+    if (edge < 0) return change;
+    if (change < 0) return edge;
+    return std::min(edge, change);
+}
+
+bool Timeline::step() {
+    long long time = nextEventTime();
+    if (time < 0) return false;
+    _now = time;
+
+    std::vector<Clock*> due;
+    while (nextEdgeTime() == time) {
+        due.push_back(_events.top().clock);
+        _events.pop();
+    }
+
+    //Every tick and change only marks nets dirty, circuit settles once after all of them
+    Scheduler::hold();
+    try {
+        if (Delays::nextTime() == time) Delays::applyNext();
+        for (Clock* clock : due) {
+            clock->tick();
+            push(clock, time + clock->timeInterval());
+        }
+    }
+    catch (...) {
+        Scheduler::release();
+        throw;
+    }
+    Scheduler::release();
+
+    //Scheduler doesn't evaluate source of change, so clock views are notified here
+    for (Clock* clock : due) {
+        clock->notifyObserver();
+    }
+    ChangeFeed::publish(time);
+    return true;
+}
+
+size_t Timeline::advanceTo(long long time) {
+    size_t moments = 0;
+    while (true) {
+        long long next = nextEventTime();
+        if (next < 0 || next > time) break;
+        step();
+        ++moments;
+    }
+    _now = std::max(_now, time);
+    return moments;
+}
+
+void Timeline::reset() {
+    _now = 0;
+    _events = decltype(_events)();
+    Delays::clear(0);
+
+    //Clocks are rescheduled in order of their previous events, so order doesn't depend on addresses
+    std::vector<std::pair<unsigned long long, Clock*>> clocks;
+    for (const auto& c : _clocks) {
+        clocks.push_back({c.second, c.first});
+    }
+    std::sort(clocks.begin(), clocks.end());
+    for (const auto& c : clocks) {
+        schedule(c.second);
+    }
+}
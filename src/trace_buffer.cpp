@@ -0,0 +1,160 @@
+#include "trace_buffer.hpp"
+#include "components.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <stdexcept>
+
+size_t TraceBuffer::addGroup(const std::vector<VcdWriter::Probe>& probes, size_t depth) {
+    if (depth == 0) {
+        throw std::invalid_argument("Error: depth of trace buffer can't be 0");
+    }
+    if (_started) {
+        throw std::invalid_argument("Error: probes can't be added while trace is recorded");
+    }
+
+    size_t first = _probes.size();
+    for (const auto& probe : probes) {
+        _probes.push_back(Probe{probe.name, _groups.size(), 0xff, 0xff});
+        watch(probe.node->x(), probe.node->y());
+    }
+    _groups.push_back(Group{std::vector<Record>(depth), 0, 0});
+    return first;
+}
+
+void TraceBuffer::setTrigger(size_t probe, Condition condition, Logic::Value value, long long after) {
+    if (probe >= _probes.size()) {
+        throw std::invalid_argument("Error: trigger on probe which doesn't exist");
+    }
+    if (after < 0) {
+        throw std::invalid_argument("Error: time after trigger can't be negative");
+    }
+    _triggerProbe = static_cast<long long>(probe);
+    _condition = condition;
+    _value = value;
+    _after = after;
+    _triggerLast = _probes[probe].last;
+}
+
+void TraceBuffer::changed(long long time, size_t probe, Logic::Value value) {
+    if (_frozen) return;
+    if (triggered() && time > _triggerTime + _after) {
+        _frozen = true;
+        return;
+    }
+    _started = true;
+    _probes[probe].last = value;
+    push(Record{time, static_cast<uint32_t>(probe), value});
+}
+
+void TraceBuffer::published(long long time) {
+    if (_frozen) return;
+    if (_triggerProbe >= 0) {
+        unsigned char from = _triggerLast;
+        _triggerLast = _probes[static_cast<size_t>(_triggerProbe)].last;
+        if (!triggered() && fires(from, _triggerLast)) _triggerTime = time;
+    }
+    if (triggered() && time >= _triggerTime + _after) _frozen = true;
+}
+
+bool TraceBuffer::fires(unsigned char from, unsigned char to) const {
+    switch (_condition) {
+    case Condition::EQUALS:
+        return to == _value;
+    case Condition::BECOMES:
+        return from != 0xff && from != to && to == _value;
+    default:
+        return from != 0xff && from != to;
+    }
+}
+
+void TraceBuffer::push(const Record& record) {
+    Group& group = _groups[_probes[record.probe].group];
+    size_t depth = group.ring.size();
+    if (group.size < depth) {
+        group.ring[(group.head + group.size++) % depth] = record;
+        return;
+    }
+
+    //The oldest record becomes level of its probe before window
+    const Record& oldest = group.ring[group.head];
+    _probes[oldest.probe].dropped = oldest.value;
+    group.ring[group.head] = record;
+    group.head = (group.head + 1) % depth;
+}
+
+std::vector<TraceBuffer::Record> TraceBuffer::records() const {
+    std::vector<Record> records;
+    for (size_t g = 0; g < _groups.size(); ++g) {
+        const Group& group = _groups[g];
+        if (group.size == 0) continue;
+        size_t depth = group.ring.size();
+        long long start = group.ring[group.head].time;
+
+        //Probes which have change at start of window don't need level before it
+        std::vector<bool> changedAtStart(_probes.size(), false);
+        for (size_t i = 0; i < group.size; ++i) {
+            const Record& r = group.ring[(group.head + i) % depth];
+            if (r.time != start) break;
+            changedAtStart[r.probe] = true;
+        }
+        for (size_t p = 0; p < _probes.size(); ++p) {
+            if (_probes[p].group != g || _probes[p].dropped == 0xff || changedAtStart[p]) continue;
+            records.push_back(Record{start, static_cast<uint32_t>(p), static_cast<Logic::Value>(_probes[p].dropped)});
+        }
+        for (size_t i = 0; i < group.size; ++i) {
+            records.push_back(group.ring[(group.head + i) % depth]);
+        }
+    }
+
+    std::stable_sort(records.begin(), records.end(), [](const Record& a, const Record& b) {
+        return a.time < b.time;
+    });
+    return records;
+}
+
+void TraceBuffer::writeVcd(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        throw std::runtime_error("Error: can't write " + path);
+    }
+
+    std::vector<std::string> names;
+    for (const auto& probe : _probes) names.push_back(probe.name);
+    VcdWriter::writeHeader(out, names);
+
+    long long time = -1;
+    bool marked = !triggered();
+    auto mark = [&]() {
+        if (time != _triggerTime) {
+            time = _triggerTime;
+            out << "#" << time << "\n";
+        }
+        out << "$comment trigger $end\n";
+        marked = true;
+    };
+    for (const Record& r : records()) {
+        if (!marked && r.time >= _triggerTime) mark();
+        if (r.time != time) {
+            time = r.time;
+            out << "#" << time << "\n";
+        }
+        out << Logic::name(r.value) << VcdWriter::identifier(r.probe) << "\n";
+    }
+    if (!marked) mark();
+
+    out.close();
+    if (!out) {
+        throw std::runtime_error("Error: can't write " + path);
+    }
+}
+
+void TraceBuffer::rearm() {
+    for (auto& group : _groups) group.head = group.size = 0;
+    for (auto& probe : _probes) probe.last = probe.dropped = 0xff;
+    _triggerLast = 0xff;
+    _triggerTime = -1;
+    _frozen = false;
+    _started = false;
+    resend();
+}
@@ -0,0 +1,154 @@
+#include "vcd_writer.hpp"
+#include "components.hpp"
+
+#include <ostream>
+#include <stdexcept>
+
+namespace {
+
+//Full buffers waiting for writer, simulation waits when there are more
+const size_t MAX_QUEUED = 4;
+
+}
+
+VcdWriter::VcdWriter(const std::string& path, const std::vector<Probe>& probes, size_t bufferSize)
+    :_path(path), _out(path, std::ios::binary), _bufferSize(bufferSize > 0 ? bufferSize : 1)
+{
+    if (!_out) {
+        throw std::runtime_error("Error: can't write " + path);
+    }
+
+    std::vector<std::string> names;
+    for (size_t i = 0; i < probes.size(); ++i) {
+        watch(probes[i].node->x(), probes[i].node->y());
+        _ids.push_back(identifier(i));
+        names.push_back(probes[i].name);
+    }
+    writeHeader(_out, names);
+
+    _buffer.reserve(_bufferSize);
+    _writer = std::thread(&VcdWriter::write, this);
+}
+
+VcdWriter::~VcdWriter() {
+    try {
+        close();
+    }
+    catch (const std::exception&) {
+    }
+}
+
+void VcdWriter::changed(long long time, size_t probe, Logic::Value value) {
+    if (_closed) return;
+    _buffer.push_back(Change{time, static_cast<unsigned>(probe), static_cast<unsigned char>(value)});
+    ++_changes;
+    if (_buffer.size() == _bufferSize) flush();
+}
+
+void VcdWriter::flush() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _written.wait(lock, [this] { return _queue.size() < MAX_QUEUED; });
+    _queue.push_back(std::vector<Change>());
+    _queue.back().swap(_buffer);
+    if (!_spare.empty()) {
+        _buffer.swap(_spare.back());
+        _spare.pop_back();
+    }
+    else {
+        _buffer.reserve(_bufferSize);
+    }
+    _queued.notify_one();
+}
+
+void VcdWriter::close() {
+    if (_closed) return;
+    _closed = true;
+
+    if (!_buffer.empty()) flush();
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _closing = true;
+    }
+    _queued.notify_one();
+    _writer.join();
+
+    _out.close();
+    if (_failed || !_out) {
+        throw std::runtime_error("Error: can't write " + _path);
+    }
+}
+
+void VcdWriter::write() {
+    std::vector<std::vector<Change>> taken;
+    std::string text;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _queued.wait(lock, [this] { return _closing || !_queue.empty(); });
+            if (_queue.empty()) return;
+            taken.swap(_queue);
+        }
+        _written.notify_one();
+
+        for (auto& changes : taken) {
+            text.clear();
+            format(changes, text);
+            if (!_out.write(text.data(), static_cast<std::streamsize>(text.size()))) {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _failed = true;
+            }
+            changes.clear();
+        }
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        for (auto& changes : taken) {
+            _spare.push_back(std::vector<Change>());
+            _spare.back().swap(changes);
+        }
+        taken.clear();
+    }
+}
+
+void VcdWriter::format(const std::vector<Change>& changes, std::string& text) {
+    for (const Change& change : changes) {
+        if (change.time != _time) {
+            _time = change.time;
+            //Digits are written backwards, time is not negative
+            char digits[24];
+            char* end = digits + sizeof(digits);
+            char* begin = end;
+            unsigned long long t = static_cast<unsigned long long>(_time);
+            do {
+                *--begin = static_cast<char>('0' + t % 10);
+                t /= 10;
+            } while (t > 0);
+            text += '#';
+            text.append(begin, end);
+            text += '\n';
+        }
+        text += Logic::name(static_cast<Logic::Value>(change.value));
+        text += _ids[change.probe];
+        text += '\n';
+    }
+}
+
+void VcdWriter::writeHeader(std::ostream& out, const std::vector<std::string>& names) {
+    out << "$version protoElectronics $end\n"
+        << "$timescale 1 ms $end\n"
+        << "$scope module circuit $end\n";
+    for (size_t i = 0; i < names.size(); ++i) {
+        out << "$var wire 1 " << identifier(i) << " " << names[i] << " $end\n";
+    }
+    out << "$upscope $end\n"
+        << "$enddefinitions $end\n";
+}
+
+std::string VcdWriter::identifier(size_t index) {
+    const size_t first = '!', count = '~' - '!' + 1;
+    std::string id;
+    do {
+        id += static_cast<char>(first + index % count);
+        index /= count;
+    } while (index > 0);
+    return id;
+}
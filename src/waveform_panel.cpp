@@ -0,0 +1,287 @@
+#include "waveform_panel.h"
+#include "change_feed.hpp"
+#include "component_item.h"
+#include "component_type.hpp"
+#include "timeline.hpp"
+
+#include <QPainter>
+#include <QHBoxLayout>
+#include <QVBoxLayout>
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+namespace {
+
+// Scrollbar works with int, longer simulated time stops at its end
+int toScroll(double time) {
+    return static_cast<int>(std::max(0.0, std::min(time, static_cast<double>(INT_MAX))));
+}
+
+}
+
+//WaveformView
+WaveformView::WaveformView(const ChangeLog& log, QWidget* parent)
+    : QWidget(parent), _log(log)
+{
+    setMinimumHeight(AXIS_HEIGHT + 2 * ROW_HEIGHT);
+    setAutoFillBackground(true);
+    setPalette(QPalette(Qt::white));
+}
+
+void WaveformView::setWindow(double from, double msPerPixel) {
+    _from = from;
+    _msPerPixel = msPerPixel;
+    update();
+}
+
+int WaveformView::columns() const {
+    return std::max(1, width() - NAME_WIDTH);
+}
+
+void WaveformView::setSelectedRow(int row) {
+    _selected = row;
+    update();
+}
+
+void WaveformView::paintEvent(QPaintEvent* event) {
+    Q_UNUSED(event);
+    QPainter painter(this);
+    paintAxis(painter);
+    for (size_t probe = 0; probe < _log.probes(); ++probe) {
+        int top = AXIS_HEIGHT + static_cast<int>(probe) * ROW_HEIGHT;
+        if (top > height()) break;
+        paintRow(painter, probe, top);
+    }
+}
+
+void WaveformView::paintAxis(QPainter& painter) {
+    // Step between ticks is 1, 2 or 5 times power of 10 milliseconds, at least 80 pixels
+    double step = 1;
+    while (step / _msPerPixel < 80) {
+        if (step / _msPerPixel * 2 >= 80) step *= 2;
+        else if (step / _msPerPixel * 5 >= 80) step *= 5;
+        else step *= 10;
+    }
+
+    painter.setPen(Qt::gray);
+    double to = _from + columns() * _msPerPixel;
+    for (double time = std::ceil(_from / step) * step; time < to; time += step) {
+        int x = NAME_WIDTH + static_cast<int>((time - _from) / _msPerPixel);
+        painter.drawLine(x, AXIS_HEIGHT - 4, x, height());
+        painter.drawText(x + 3, AXIS_HEIGHT - 5, QString::number(static_cast<long long>(time)) + " ms");
+    }
+}
+
+void WaveformView::paintRow(QPainter& painter, size_t probe, int top) {
+    if (static_cast<int>(probe) == _selected) {
+        painter.fillRect(0, top, NAME_WIDTH, ROW_HEIGHT, QColor(200, 230, 255));
+    }
+    painter.setPen(Qt::black);
+    painter.drawText(QRect(4, top, NAME_WIDTH - 8, ROW_HEIGHT), Qt::AlignVCenter | Qt::AlignLeft,
+                     QString::fromStdString(_log.name(probe)));
+
+    int count = columns();
+    _columns.resize(static_cast<size_t>(count));
+    long long from = static_cast<long long>(std::floor(_from));
+    long long to = from + static_cast<long long>(std::ceil(count * _msPerPixel));
+    _log.summarize(probe, from, to, _columns);
+
+    int high = top + 4;
+    int low = top + ROW_HEIGHT - 4;
+    int middle = top + ROW_HEIGHT / 2;
+    auto y = [high, low, middle](Logic::Value value) {
+        return value == Logic::ONE ? high : value == Logic::ZERO ? low : middle;
+    };
+
+    // Lines of the same colour are drawn at once, neighbouring columns with the same level are one line
+    QVector<QLine> known, unknown, floating;
+    QVector<QRect> bands;
+    auto lines = [&](Logic::Value value) -> QVector<QLine>& {
+        return value == Logic::X ? unknown : value == Logic::Z ? floating : known;
+    };
+
+    int runStart = 0;
+    Logic::Value runLevel = _columns[0].first;
+    bool inRun = false;
+    auto endRun = [&](int x) {
+        if (inRun) lines(runLevel).append(QLine(NAME_WIDTH + runStart, y(runLevel), NAME_WIDTH + x, y(runLevel)));
+        inRun = false;
+    };
+
+    for (int x = 0; x < count; ++x) {
+        const ChangeLog::Column& c = _columns[static_cast<size_t>(x)];
+        if (c.changes > 1) {
+            // Too many changes for one pixel: band from low to high
+            endRun(x);
+            if (!bands.isEmpty() && bands.last().right() == NAME_WIDTH + x - 1) bands.last().setRight(NAME_WIDTH + x);
+            else bands.append(QRect(NAME_WIDTH + x, high, 1, low - high + 1));
+            continue;
+        }
+        if (c.changes == 1) {
+            // Edge to or from unknown or floating level has colour of that level
+            endRun(x);
+            Logic::Value edge = c.first == Logic::X || c.last == Logic::X ? Logic::X
+                              : c.first == Logic::Z || c.last == Logic::Z ? Logic::Z : c.last;
+            lines(edge).append(QLine(NAME_WIDTH + x, y(c.first), NAME_WIDTH + x, y(c.last)));
+        }
+        if (!inRun || c.last != runLevel) {
+            endRun(x);
+            runStart = x;
+            runLevel = c.last;
+            inRun = true;
+        }
+    }
+    endRun(count);
+
+    for (const QRect& band : bands) painter.fillRect(band, QColor(0, 128, 0, 120));
+    painter.setPen(QPen(Qt::darkGreen, 2));
+    painter.drawLines(known);
+    painter.setPen(QPen(Qt::red, 2));
+    painter.drawLines(unknown);
+    painter.setPen(QPen(Qt::blue, 1, Qt::DashLine));
+    painter.drawLines(floating);
+}
+
+void WaveformView::wheelEvent(QWheelEvent* event) {
+    int steps = event->angleDelta().y() / 120;
+    if (steps == 0) return;
+    // position() replaced posF() of wheel events in Qt 5.14
+#if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
+    double x = event->position().x();
+#else
+    double x = event->posF().x();
+#endif
+    double time = _from + (x - NAME_WIDTH) * _msPerPixel;
+    emit zoomed(time, steps);
+    event->accept();
+}
+
+void WaveformView::mousePressEvent(QMouseEvent* event) {
+    // position() replaced pos() of mouse events in Qt 6
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    int y = static_cast<int>(event->position().y());
+#else
+    int y = event->pos().y();
+#endif
+    int row = (y - AXIS_HEIGHT) / ROW_HEIGHT;
+    bool inside = y >= AXIS_HEIGHT && row < static_cast<int>(_log.probes());
+    setSelectedRow(inside ? row : -1);
+}
+
+//WaveformPanel
+WaveformPanel::WaveformPanel(QGraphicsScene* scene, QWidget* parent)
+    : QWidget(parent), scene(scene)
+{
+    view = new WaveformView(changeLog);
+    scrollBar = new QScrollBar(Qt::Horizontal);
+    addButton = new QPushButton(tr("Add selected"));
+    removeButton = new QPushButton(tr("Remove"));
+    clearButton = new QPushButton(tr("Clear history"));
+
+    QHBoxLayout* buttons = new QHBoxLayout;
+    buttons->addWidget(addButton);
+    buttons->addWidget(removeButton);
+    buttons->addWidget(clearButton);
+    buttons->addStretch();
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->addWidget(view, 1);
+    layout->addWidget(scrollBar);
+    layout->addLayout(buttons);
+
+    connect(addButton, SIGNAL(clicked(bool)), this, SLOT(onAddSelected()));
+    connect(removeButton, SIGNAL(clicked(bool)), this, SLOT(onRemove()));
+    connect(clearButton, SIGNAL(clicked(bool)), this, SLOT(onClear()));
+    connect(scrollBar, SIGNAL(valueChanged(int)), this, SLOT(onScroll(int)));
+    connect(view, SIGNAL(zoomed(double,int)), this, SLOT(onZoomed(double,int)));
+
+    refreshTimer = new QTimer(this);
+    connect(refreshTimer, SIGNAL(timeout()), this, SLOT(onRefresh()));
+    refreshTimer->start(16);
+}
+
+void WaveformPanel::reset() {
+    while (changeLog.probes() > 0) changeLog.removeProbe(changeLog.probes() - 1);
+    changeLog.clear();
+    view->setSelectedRow(-1);
+    following = true;
+    shownEnd = -1;
+    updateWindow();
+}
+
+void WaveformPanel::onAddSelected() {
+    // Every net of pins of selected components is added once
+    for (QGraphicsItem* selected : scene->selectedItems()) {
+        ComponentItem* item = dynamic_cast<ComponentItem*>(selected);
+        if (item == nullptr) continue;
+
+        Component* component = item->component();
+        const std::string& label = ComponentTypes::get(component->kind()).label;
+        for (const auto& node : component->nodes()) {
+            if (changeLog.probed(node->x(), node->y())) continue;
+            changeLog.addProbe(label + " " + std::to_string(node->x()) + "," + std::to_string(node->y()), node->x(), node->y());
+        }
+    }
+    // New probes start with their current level
+    ChangeFeed::publish(Timeline::now());
+    view->setMinimumHeight(WaveformView::AXIS_HEIGHT + static_cast<int>(std::max<size_t>(2, changeLog.probes())) * WaveformView::ROW_HEIGHT);
+    updateWindow();
+}
+
+void WaveformPanel::onRemove() {
+    int row = view->selectedRow();
+    if (row < 0 || row >= static_cast<int>(changeLog.probes())) return;
+    changeLog.removeProbe(static_cast<size_t>(row));
+    view->setSelectedRow(-1);
+    updateWindow();
+}
+
+void WaveformPanel::onClear() {
+    changeLog.clear();
+    following = true;
+    ChangeFeed::publish(Timeline::now());
+    updateWindow();
+}
+
+void WaveformPanel::onRefresh() {
+    // Changes made by user between moments (switches) are recorded at current time
+    if (changeLog.probes() > 0) ChangeFeed::publish(Timeline::now());
+    if (changeLog.end() == shownEnd || !isVisible()) return;
+    shownEnd = changeLog.end();
+    updateWindow();
+}
+
+void WaveformPanel::onScroll(int value) {
+    if (updatingScrollBar) return;
+    following = value == scrollBar->maximum();
+    view->setWindow(value, msPerPixel);
+}
+
+void WaveformPanel::onZoomed(double time, int steps) {
+    // Time under mouse stays under mouse
+    double x = (time - view->from()) / msPerPixel;
+    msPerPixel = std::max(0.01, std::min(1e7, msPerPixel * std::pow(0.8, steps)));
+    updateWindow();
+    if (!following) {
+        scrollBar->setValue(toScroll(time - x * msPerPixel));
+    }
+}
+
+void WaveformPanel::updateWindow() {
+    double span = view->columns() * msPerPixel;
+    double begin = std::max(0LL, changeLog.begin());
+    double last = std::max(begin, changeLog.end() - span);
+
+    updatingScrollBar = true;
+    scrollBar->setRange(toScroll(begin), toScroll(last));
+    scrollBar->setPageStep(std::max(1, toScroll(span)));
+    scrollBar->setSingleStep(std::max(1, toScroll(span / 10)));
+    if (following) scrollBar->setValue(scrollBar->maximum());
+    updatingScrollBar = false;
+
+    // Zoomed in so much that scrollbar can't follow: newest time is at right edge
+    double from = following ? std::max(begin, changeLog.end() - span) : scrollBar->value();
+    view->setWindow(from, msPerPixel);
+}
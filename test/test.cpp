@@ -3,6 +3,26 @@
 #include "components.hpp"
 #include "log_component.hpp"
 #include "circuit.hpp"
+#include "schematic.hpp"
+#include "schematic_file.hpp"
+#include "compiled_logic.hpp"
+#include "pattern_simulator.hpp"
+#include "logic_kernel.hpp"
+#include "thread_pool.hpp"
+#include "analog_solver.hpp"
+#include "slab_allocator.hpp"
+#include "change_feed.hpp"
+#include "vcd_writer.hpp"
+#include "trace_buffer.hpp"
+#include "change_log.hpp"
+#include "timeline.hpp"
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <memory>
 
 #define EPS 1e-5
 
@@ -557,15 +577,15 @@ SCENARIO("logic components circuit", "[.circuit]"){
 
             //Now check nodes
             THEN("Output node of AND1 is 0") {
-                REQUIRE((*Node::find(x3, y3))->_v == Approx(0).epsilon(EPS));
+                REQUIRE((*Node::find(x3, y3))->v() == Approx(0).epsilon(EPS));
             }
 
             THEN("Output of OR is 5V") {
-                REQUIRE((*Node::find(x4, y4))->_v == Approx(5).epsilon(EPS));
+                REQUIRE((*Node::find(x4, y4))->v() == Approx(5).epsilon(EPS));
             }
 
             THEN("Output of AND2 is 0") {
-                REQUIRE((*Node::find(x5, y5))->_v == Approx(0).epsilon(EPS));
+                REQUIRE((*Node::find(x5, y5))->v() == Approx(0).epsilon(EPS));
             }
         }
     }
@@ -767,3 +787,1896 @@ SCENARIO("Circuit", "[circuit]"){
         }
     }
 }
+
+SCENARIO("node registry", "[registry]"){
+    GIVEN("Resistors connected to nodes with similar coordinates") {
+        Resistor r1(1000), r2(1000);
+        r1.addNode(1, 23);
+        r2.addNode(12, 3);
+
+        THEN("Nodes are different") {
+            REQUIRE(Node::size() == 2);
+            REQUIRE(*Node::find(1, 23) != *Node::find(12, 3));
+            REQUIRE((*Node::find(1, 23))->isConnectedTo(&r1));
+            REQUIRE((*Node::find(12, 3))->isConnectedTo(&r2));
+        }
+    }
+
+    GIVEN("Many resistors connected in a chain") {
+        const int n = 1000;
+        std::vector<std::unique_ptr<Resistor>> resistors;
+        for (int i = 0; i < n; ++i) {
+            resistors.emplace_back(new Resistor(10));
+            resistors.back()->addNode(i, -i);
+            resistors.back()->addNode(i + 1, -i - 1);
+        }
+
+        THEN("All nodes are found") {
+            REQUIRE(Node::size() == n + 1);
+            for (int i = 0; i <= n; ++i) {
+                REQUIRE(Node::find(i, -i) != Node::_allNodes.end());
+            }
+            REQUIRE(Node::find(n + 1, -n - 1) == Node::_allNodes.end());
+        }
+
+        WHEN("Every second resistor is removed") {
+            for (int i = 0; i < n; i += 2) {
+                resistors[i].reset();
+            }
+
+            THEN("Remaining nodes are still found") {
+                REQUIRE(Node::size() == n);
+                for (int i = 1; i < n; i += 2) {
+                    REQUIRE(*Node::find(i, -i) == *resistors[i]->find(i, -i));
+                    REQUIRE(*Node::find(i + 1, -i - 1) == *resistors[i]->find(i + 1, -i - 1));
+                }
+            }
+        }
+    }
+}
+
+SCENARIO("propagation through scheduler", "[scheduler]"){
+    GIVEN("Long chain of NOT gates") {
+        const int n = 20000;
+        std::vector<std::unique_ptr<NOTGate>> gates;
+        for (int i = 0; i < n; ++i) {
+            gates.emplace_back(new NOTGate());
+            gates.back()->connect(std::vector<std::pair<int, int>>{
+                    std::pair<int, int>(i, 0),
+                    std::pair<int, int>(i + 1, 0)});
+        }
+
+        WHEN("Voltage connected on input") {
+            DCVoltage v(5);
+            v.addNode(0, 0);
+
+            THEN("Output of last gate is calculated without recursion") {
+                REQUIRE((*Node::find(n, 0))->v() == Approx(5).epsilon(EPS));
+                REQUIRE((*Node::find(n - 1, 0))->v() == Approx(0).epsilon(EPS));
+                REQUIRE_FALSE(Scheduler::oscillating());
+            }
+
+            THEN("Every gate is evaluated once") {
+                v.setVoltage(0);
+                REQUIRE(Scheduler::evaluations() == size_t(n));
+            }
+        }
+
+        //Removing from the end, so removed gate doesn't change the rest of the chain
+        while (!gates.empty()) gates.pop_back();
+    }
+
+    GIVEN("NOT gate with output connected to input by wire") {
+        NOTGate not1;
+        Wire w;
+        not1.connect(std::vector<std::pair<int, int>>{
+                std::pair<int, int>(0, 0),
+                std::pair<int, int>(1, 0)});
+
+        WHEN("Loop is closed") {
+            w.connect(std::vector<std::pair<int, int>>{
+                    std::pair<int, int>(1, 0),
+                    std::pair<int, int>(0, 0)});
+
+            THEN("Oscillation is stopped by iteration limit") {
+                REQUIRE(Scheduler::oscillating());
+            }
+        }
+    }
+
+    GIVEN("SR latch made of two NOR gates") {
+        NORGate nor1, nor2;
+        DCVoltage s(0), r(0);
+        //nor1: R, Qc -> Q; nor2: S, Q -> Qc
+        nor1.connect(std::vector<std::pair<int, int>>{
+                std::pair<int, int>(0, 0),
+                std::pair<int, int>(0, 2),
+                std::pair<int, int>(0, 1)});
+        nor2.connect(std::vector<std::pair<int, int>>{
+                std::pair<int, int>(0, 3),
+                std::pair<int, int>(0, 1),
+                std::pair<int, int>(0, 2)});
+        r.addNode(0, 0);
+        s.addNode(0, 3);
+
+        WHEN("Set and then release") {
+            s.setVoltage(5);
+            s.setVoltage(0);
+
+            THEN("Q stays set") {
+                REQUIRE((*Node::find(0, 1))->v() == Approx(5).epsilon(EPS));
+                REQUIRE((*Node::find(0, 2))->v() == Approx(0).epsilon(EPS));
+                REQUIRE_FALSE(Scheduler::oscillating());
+            }
+        }
+
+        WHEN("Reset and then release") {
+            r.setVoltage(5);
+            r.setVoltage(0);
+
+            THEN("Q stays reset") {
+                REQUIRE((*Node::find(0, 1))->v() == Approx(0).epsilon(EPS));
+                REQUIRE((*Node::find(0, 2))->v() == Approx(5).epsilon(EPS));
+            }
+        }
+    }
+}
+
+SCENARIO("nets of wires and switches", "[net]"){
+    GIVEN("Voltage source at the start of long wire chain") {
+        const int n = 10000;
+        DCVoltage v(5);
+        v.addNode(0, 0);
+        std::vector<std::unique_ptr<Wire>> wires;
+        for (int i = 0; i < n; ++i) {
+            wires.emplace_back(new Wire());
+            wires.back()->addNode(i, 0);
+            wires.back()->addNode(i + 1, 0);
+        }
+
+        THEN("All nodes are in one net") {
+            REQUIRE(Node::size() == n + 1);
+            REQUIRE(NetList::size() == 1);
+            REQUIRE((*Node::find(0, 0))->net() == (*Node::find(n, 0))->net());
+            REQUIRE((*Node::find(n, 0))->v() == Approx(5).epsilon(EPS));
+        }
+
+        WHEN("Wire in the middle is removed") {
+            wires[n / 2].reset();
+
+            THEN("Chain is split into two nets") {
+                REQUIRE(NetList::size() == 2);
+                REQUIRE((*Node::find(n / 2, 0))->v() == Approx(5).epsilon(EPS));
+                REQUIRE((*Node::find(n / 2 + 1, 0))->v() == Approx(0).epsilon(EPS));
+                REQUIRE((*Node::find(n, 0))->v() == Approx(0).epsilon(EPS));
+            }
+        }
+    }
+
+    GIVEN("Voltage source and NOT gate connected through switch") {
+        DCVoltage v(5);
+        Switch s;
+        NOTGate not1;
+        v.addNode(0, 0);
+        s.addNode(0, 0);
+        s.addNode(1, 0);
+        not1.connect(std::vector<std::pair<int, int>>{
+                std::pair<int, int>(1, 0),
+                std::pair<int, int>(2, 0)});
+
+        THEN("Open switch separates nets") {
+            REQUIRE((*Node::find(0, 0))->net() != (*Node::find(1, 0))->net());
+            REQUIRE((*Node::find(1, 0))->v() == Approx(0).epsilon(EPS));
+            REQUIRE((*Node::find(2, 0))->v() == Approx(5).epsilon(EPS));
+        }
+
+        WHEN("Switch is closed") {
+            s.close();
+
+            THEN("Nets are joined") {
+                REQUIRE((*Node::find(0, 0))->net() == (*Node::find(1, 0))->net());
+                REQUIRE((*Node::find(1, 0))->v() == Approx(5).epsilon(EPS));
+                REQUIRE((*Node::find(2, 0))->v() == Approx(0).epsilon(EPS));
+            }
+
+            THEN("Nets know their logic level and driver") {
+                int in = (*Node::find(1, 0))->net();
+                int out = (*Node::find(2, 0))->net();
+                REQUIRE(NetList::level(in) == 1);
+                REQUIRE(NetList::level(out) == 0);
+                REQUIRE(NetList::driver(in) == &v);
+                REQUIRE(NetList::driver(out) == &not1);
+            }
+
+            AND_WHEN("Switch is opened again") {
+                s.open();
+
+                THEN("Source keeps its voltage and input of gate is cleared") {
+                    REQUIRE((*Node::find(0, 0))->v() == Approx(5).epsilon(EPS));
+                    REQUIRE((*Node::find(1, 0))->v() == Approx(0).epsilon(EPS));
+                    REQUIRE((*Node::find(2, 0))->v() == Approx(5).epsilon(EPS));
+                }
+            }
+        }
+    }
+
+    GIVEN("NOT gate which drives AND gate") {
+        NOTGate not1;
+        ANDGate and1;
+        not1.connect({{0, 0}, {1, 0}});
+        and1.connect({{1, 0}, {2, 0}, {3, 0}});
+
+        WHEN("Scheduler runs twice without changes of connections") {
+            Scheduler::run();
+            Scheduler::run();
+
+            THEN("Pin index lists pins of every net") {
+                REQUIRE(NetList::hasPinIndex());
+                int out = (*Node::find(1, 0))->net();
+                REQUIRE(NetList::pinsEnd(out) - NetList::pinsBegin(out) == 2);
+                for (auto p = NetList::pinsBegin(out); p != NetList::pinsEnd(out); ++p) {
+                    REQUIRE(p->pin == (p->component == &not1 ? 1u : 0u));
+                    REQUIRE(p->component->nodes()[p->pin] == *Node::find(1, 0));
+                }
+            }
+
+            AND_WHEN("Gate is disconnected") {
+                and1.disconnect(1, 0);
+
+                THEN("Index has to be built again") {
+                    REQUIRE_FALSE(NetList::hasPinIndex());
+                }
+            }
+        }
+    }
+
+    GIVEN("Decoder with all 11 pins") {
+        Decoder d;
+        for (int i = 0; i < 11; ++i) d.addNode(i, 50);
+
+        THEN("Pins are kept in order of connection") {
+            REQUIRE(d.nodes().size() == 11);
+            for (int i = 0; i < 11; ++i) REQUIRE(d.nodes()[i]->x() == i);
+        }
+
+        WHEN("Pin in the middle is disconnected") {
+            d.disconnect(5, 50);
+
+            THEN("Following pins move forward") {
+                REQUIRE(d.nodes().size() == 10);
+                REQUIRE(d.nodes()[5]->x() == 6);
+                REQUIRE(d.nodes().back()->x() == 10);
+            }
+        }
+    }
+}
+
+SCENARIO("headless components", "[core]"){
+    GIVEN("Ground at position (10, 20)") {
+        Ground g;
+        g.setPosition(10, 20);
+
+        THEN("Connection point is in the middle of upper edge") {
+            REQUIRE(g.connectionPoints() == std::vector<std::pair<int, int>>{{60, 20}});
+        }
+
+        WHEN("Ground is rotated") {
+            g.rotate(90);
+
+            THEN("Connection point is rotated around center and connected") {
+                REQUIRE(g.rotationAngle() == 90);
+                REQUIRE(g.connectionPoints() == std::vector<std::pair<int, int>>{{110, 70}});
+                REQUIRE(Node::find(110, 70) != Node::_allNodes.end());
+            }
+        }
+    }
+
+    GIVEN("NOT gate rotated two times") {
+        NOTGate not1;
+        not1.rotate(90);
+        not1.rotate(90);
+
+        THEN("Input and output change places") {
+            REQUIRE(not1.connectionPoints() == std::vector<std::pair<int, int>>{{180, 60}, {0, 60}});
+        }
+    }
+
+    GIVEN("Clock connected to node") {
+        Clock c(5, 100);
+        c.addNode(0, 0);
+
+        THEN("Every tick switches voltage") {
+            REQUIRE((*Node::find(0, 0))->v() == Approx(5).epsilon(EPS));
+            c.tick();
+            REQUIRE((*Node::find(0, 0))->v() == Approx(0).epsilon(EPS));
+            c.tick();
+            REQUIRE((*Node::find(0, 0))->v() == Approx(5).epsilon(EPS));
+        }
+    }
+}
+
+SCENARIO("schematic files", "[schematic]"){
+    GIVEN("Schematic with source, NOT gate, closed switch and clock") {
+        std::string json =
+            "{ \"voltage\": [[0, 0, 0, 3]],"
+            "  \"switch\": [[230, -50, 0, false]],"
+            "  \"clock\": [[500, 500, 0, 250]],"
+            "  \"not\": [[50, -60, 0]] }";
+
+        std::vector<ComponentRecord> records = Schematic::parse(json);
+
+        THEN("Records are ordered by type and have parameters") {
+            REQUIRE(records.size() == 4);
+            REQUIRE(records[0].type == "not");
+            REQUIRE(records[0].hasParameter == false);
+            REQUIRE(records[1].type == "switch");
+            REQUIRE(records[2].type == "clock");
+            REQUIRE(records[3].type == "voltage");
+            REQUIRE(records[3].parameter == Approx(3).epsilon(EPS));
+        }
+
+        WHEN("Schematic is loaded in circuit") {
+            Circuit circuit;
+            Schematic::load(records, circuit);
+
+            THEN("Components are placed, connected and have their parameters") {
+                REQUIRE(circuit.size() == 4);
+                REQUIRE(static_cast<Switch*>(circuit[1])->isClosed());
+                REQUIRE(static_cast<Clock*>(circuit[2])->timeInterval() == 250);
+                REQUIRE((*Node::find(50, 0))->v() == Approx(3).epsilon(EPS));
+                REQUIRE((*Node::find(230, 0))->v() == Approx(0).epsilon(EPS));
+                REQUIRE((*Node::find(230, 0))->net() == (*Node::find(330, 0))->net());
+            }
+        }
+    }
+
+    GIVEN("Text with members which aren't components") {
+        std::string json =
+            "{ \"name\": { \"nested\": [1, {\"a\": null}] }, \"wire\": [[0, 0, 90, 200, \"extra\"]],"
+            "  \"not\": 5, \"and\": [[1e1, -2.5, 0, null]] }";
+
+        WHEN("Text is read without terminating zero") {
+            std::vector<char> text(json.begin(), json.end());
+            std::vector<ComponentRecord> records = Schematic::parse(text.data(), text.data() + text.size());
+
+            THEN("Other members are skipped and values are read like from document") {
+                REQUIRE(records.size() == 2);
+                REQUIRE(records[0].type == "and");
+                REQUIRE(records[0].x == 10);
+                REQUIRE(records[0].y == -2);
+                REQUIRE(records[0].hasParameter);
+                REQUIRE(records[0].parameter == 0);
+                REQUIRE(records[1].type == "wire");
+                REQUIRE(records[1].parameter == 200);
+                REQUIRE_THROWS(Schematic::parse(text.data(), text.data() + text.size() - 1));
+            }
+        }
+
+        WHEN("Rotated wire is loaded") {
+            Circuit circuit;
+            Schematic::load(Schematic::parse(json), circuit);
+            Wire* wire = static_cast<Wire*>(circuit[1]);
+
+            THEN("Wire is connected only to its final connection points") {
+                REQUIRE(wire->length() == 200);
+                REQUIRE(wire->rotationAngle() == 90);
+                REQUIRE(wire->nodes().size() == 2);
+                REQUIRE(wire->nodes()[0]->x() == 50);
+                REQUIRE(wire->nodes()[0]->y() == 0);
+                REQUIRE(wire->nodes()[1]->x() == 50);
+                REQUIRE(wire->nodes()[1]->y() == 200);
+                REQUIRE(Node::size() == 5);
+            }
+        }
+    }
+
+    GIVEN("Records with parameters which aren't short decimal numbers") {
+        std::vector<ComponentRecord> records = Schematic::parse(
+            "{ \"resistor\": [[100, -20, 90, 0.1], [0, 0, 270, 3.3333333333333335]],"
+            "  \"and\": [[-5, 7, 180]], \"switch\": [[230, -50, 0, true]] }");
+        ComponentRecord custom;
+        custom.type = "transistor";
+        custom.x = 1;
+        records.push_back(custom);
+
+        auto same = [](const std::vector<ComponentRecord>& a, const std::vector<ComponentRecord>& b) {
+            if (a.size() != b.size()) return false;
+            for (size_t i = 0; i < a.size(); ++i) {
+                if (a[i].type != b[i].type || a[i].x != b[i].x || a[i].y != b[i].y || a[i].angle != b[i].angle ||
+                    a[i].hasParameter != b[i].hasParameter || a[i].parameter != b[i].parameter) return false;
+            }
+            return true;
+        };
+
+        WHEN("They are written as binary file and mapped") {
+            const std::string path = "test-schematic.psch";
+            SchematicFile::write(records, path);
+
+            THEN("Mapped file has the same records") {
+                REQUIRE(SchematicFile::isBinary(path));
+                {
+                    SchematicFile file(path);
+                    REQUIRE(file.size() == records.size());
+                    REQUIRE(file.type(0) == "and");
+                    REQUIRE(file.type(4) == "transistor");
+                    REQUIRE(same(file.records(), records));
+                }
+                REQUIRE(same(Schematic::readFile(path), records));
+            }
+
+            THEN("Circuit is loaded straight from file") {
+                records.pop_back();
+                SchematicFile::write(records, path);
+                Circuit circuit;
+                Schematic::load(SchematicFile(path), circuit);
+                REQUIRE(circuit.size() == 4);
+                REQUIRE(static_cast<Resistor*>(circuit[3])->resistance() == 3.3333333333333335);
+                REQUIRE_FALSE(static_cast<Switch*>(circuit[1])->isClosed());
+            }
+            std::remove(path.c_str());
+        }
+
+        WHEN("They are written as JSON") {
+            std::vector<ComponentRecord> parsed = Schematic::parse(Schematic::toJson(records));
+
+            THEN("Parsing gives the same records") {
+                records.pop_back();
+                REQUIRE(same(parsed, records));
+            }
+        }
+
+        THEN("Files which aren't valid binary schematics can't be mapped") {
+            const std::string path = "test-schematic.psch";
+            SchematicFile::write(records, path);
+            std::string data;
+            {
+                std::ifstream file(path, std::ios::binary);
+                data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            }
+            std::ofstream(path, std::ios::binary) << data.substr(0, data.size() - 1);
+            REQUIRE_THROWS(SchematicFile(path));
+            std::ofstream(path, std::ios::binary) << "{ \"and\": [] }";
+            REQUIRE_FALSE(SchematicFile::isBinary(path));
+            REQUIRE_THROWS(SchematicFile(path));
+            std::remove(path.c_str());
+            REQUIRE_THROWS(SchematicFile(path));
+        }
+    }
+
+    GIVEN("Invalid schematics") {
+        THEN("Parsing throws exception") {
+            REQUIRE_THROWS(Schematic::parse("{ \"and\": [[1, 2, 0]"));
+            REQUIRE_THROWS(Schematic::parse("[]"));
+            REQUIRE_THROWS(Schematic::parse("{ \"and\": [[1, 2]] }"));
+        }
+
+        THEN("Unknown component type can't be loaded") {
+            Circuit circuit;
+            ComponentRecord record;
+            record.type = "transistor";
+            REQUIRE_THROWS(Schematic::load({record}, circuit));
+        }
+
+        THEN("Resistor without positive resistance can't be loaded") {
+            Circuit circuit;
+            REQUIRE_THROWS_AS(Schematic::load(Schematic::parse("{ \"resistor\": [[100, 0, 0, 0]] }"), circuit), std::invalid_argument);
+        }
+    }
+}
+
+SCENARIO("batch edits of circuit", "[batch]"){
+    GIVEN("Chain of NOT gates built in batch edit") {
+        const int length = 20;
+        Circuit circuit;
+        circuit.begin();
+        circuit.begin();
+        DCVoltage* v = new DCVoltage(5);
+        circuit.addComponent(v);
+        v->addNode(-20, 60);
+        //Wire joins output of previous gate (or source) with input of the next one
+        for (int i = 0; i < length; ++i) {
+            NOTGate* gate = new NOTGate();
+            circuit.addComponent(gate);
+            gate->setPosition(200 * i, 0);
+            gate->connect(gate->connectionPoints());
+            Wire* wire = new Wire();
+            circuit.addComponent(wire);
+            wire->connect({{200 * i - 20, 60}, {200 * i, 60}});
+        }
+        auto chain = [](int i) {
+            return *Node::find(200 * i - 20, 60);
+        };
+        circuit.commit();
+
+        THEN("Nothing is propagated before the outermost commit") {
+            REQUIRE(circuit.inBatch());
+            REQUIRE(chain(2)->v() == Approx(0).margin(EPS));
+            REQUIRE(chain(3)->v() == Approx(0).margin(EPS));
+
+            WHEN("Batch is committed") {
+                circuit.commit();
+
+                THEN("Every gate has output for settled input") {
+                    REQUIRE_FALSE(circuit.inBatch());
+                    REQUIRE_FALSE(Scheduler::isHeld());
+                    for (int i = 1; i <= length; ++i) {
+                        REQUIRE(chain(i)->v() == Approx(i % 2 == 0 ? 5 : 0).margin(EPS));
+                    }
+                    REQUIRE_THROWS_AS(circuit.commit(), std::logic_error);
+                }
+            }
+        }
+    }
+
+    GIVEN("Circuit destroyed in the middle of batch") {
+        {
+            Circuit circuit;
+            circuit.begin();
+        }
+
+        THEN("Scheduler isn't held anymore") {
+            REQUIRE_FALSE(Scheduler::isHeld());
+        }
+    }
+}
+
+//Counts evaluations of observed component
+class EvaluationCounter : public ComponentObserver {
+public:
+    void componentChanged(const Component& component) override {
+        (void)component;
+        ++count;
+    }
+
+    unsigned count = 0;
+};
+
+SCENARIO("registry of component types", "[types]"){
+    GIVEN("All registered types") {
+        const auto& types = ComponentTypes::all();
+
+        THEN("Every type makes component of its kind with its number of pins") {
+            REQUIRE(types.size() == Schematic::types().size());
+            for (size_t i = 0; i < types.size(); ++i) {
+                const ComponentType& type = types[i];
+                REQUIRE(static_cast<size_t>(type.kind) == i);
+                REQUIRE(ComponentTypes::find(type.name) == &type);
+                REQUIRE(ComponentTypes::findLabel(type.label) == &type);
+                REQUIRE(Schematic::types()[i] == type.name);
+
+                std::unique_ptr<Component> c(type.create(ComponentRecord()));
+                REQUIRE(c->kind() == type.kind);
+                REQUIRE(c->componentType() == type.name);
+                REQUIRE(c->localConnectionPoints().size() == type.pins);
+            }
+            REQUIRE(ComponentTypes::find("capacitor") == nullptr);
+        }
+
+        THEN("Components are made by kind") {
+            REQUIRE(types.size() == COMPONENT_KINDS);
+            for (const auto& type : types) {
+                std::unique_ptr<Component> c(ComponentTypes::create(type.kind));
+                REQUIRE(c->kind() == type.kind);
+            }
+        }
+    }
+
+    GIVEN("Records with type which isn't registered") {
+        std::vector<ComponentRecord> records(3);
+        records[0].type = "not";
+        records[1].type = "capacitor";
+        records[1].x = 200;
+        records[2].type = "not";
+        records[2].x = 400;
+
+        THEN("Loading from records and from binary file fails on that type") {
+            Circuit c1;
+            REQUIRE_THROWS_AS(Schematic::load(records, c1), std::runtime_error);
+
+            SchematicFile::write(records, "test-types.psch");
+            {
+                SchematicFile file("test-types.psch");
+                REQUIRE(file.componentType(0) == &ComponentTypes::get(ComponentKind::NOT));
+                REQUIRE(file.componentType(1) == nullptr);
+                Circuit c2;
+                REQUIRE_THROWS_AS(Schematic::load(file, c2), std::runtime_error);
+            }
+            std::remove("test-types.psch");
+        }
+
+        THEN("Components made by callback before error stay placed and batch ends") {
+            Circuit batch;
+            std::vector<std::unique_ptr<Component>> made;
+            REQUIRE_THROWS_AS(Schematic::load(records, batch, [&made](const ComponentType& type, const ComponentRecord& record) {
+                made.emplace_back(type.create(record));
+                return made.back().get();
+            }), std::runtime_error);
+            REQUIRE(made.size() == 1);
+            REQUIRE(made[0]->nodes().size() == 2);
+            REQUIRE(batch.size() == 0);
+            REQUIRE_FALSE(batch.inBatch());
+            REQUIRE_FALSE(Scheduler::isHeld());
+        }
+    }
+
+    GIVEN("Placed components with parameters") {
+        std::vector<ComponentRecord> saved(3);
+        saved[0].type = "resistor";
+        saved[0].x = 100;
+        saved[0].y = 200;
+        saved[0].angle = 90;
+        saved[0].hasParameter = true;
+        saved[0].parameter = 470;
+        saved[1].type = "switch";
+        saved[1].x = 300;
+        saved[1].hasParameter = true;
+        saved[1].parameter = 0;
+        saved[2].type = "wire";
+        saved[2].y = 500;
+        saved[2].angle = 180;
+        saved[2].hasParameter = true;
+        saved[2].parameter = 250;
+
+        Circuit circuit;
+        Schematic::load(saved, circuit);
+
+        WHEN("Components are saved again") {
+            std::vector<ComponentRecord> records;
+            for (auto c : circuit.components()) records.push_back(Schematic::record(*c));
+
+            THEN("Records are the same as loaded ones") {
+                REQUIRE(records.size() == saved.size());
+                for (size_t i = 0; i < saved.size(); ++i) {
+                    REQUIRE(records[i].type == saved[i].type);
+                    REQUIRE(records[i].x == saved[i].x);
+                    REQUIRE(records[i].y == saved[i].y);
+                    REQUIRE(records[i].angle == saved[i].angle);
+                    REQUIRE(records[i].hasParameter);
+                    REQUIRE(records[i].parameter == Approx(saved[i].parameter));
+                }
+            }
+        }
+
+        THEN("Components are found by kind and by name") {
+            auto points = circuit.components()[0]->connectionPoints();
+            auto node = *Node::find(points[0].first, points[0].second);
+            REQUIRE(node->directComponents(ComponentKind::RESISTOR).size() == 1);
+            REQUIRE(node->directComponents("resistor") == node->directComponents(ComponentKind::RESISTOR));
+            REQUIRE(node->directComponents("capacitor").empty());
+        }
+    }
+}
+
+SCENARIO("simulated time", "[timeline]"){
+    GIVEN("Two clocks on inputs of AND gate") {
+        ANDGate and1;
+        and1.connect(and1.connectionPoints());
+        EvaluationCounter counter;
+        and1.setObserver(&counter);
+
+        Clock c1(5, 100);
+        Clock c2(5, 200);
+        c1.addNode(0, 30);
+        c2.addNode(0, 90);
+        Timeline::reset();
+
+        THEN("Edges come in order of simulated time") {
+            REQUIRE(Timeline::now() == 0);
+            REQUIRE(Timeline::nextEventTime() == 100);
+            REQUIRE(Timeline::step());
+            REQUIRE(Timeline::now() == 100);
+            REQUIRE(c1.voltage() == Approx(0).epsilon(EPS));
+            REQUIRE(c2.voltage() == Approx(5).epsilon(EPS));
+        }
+
+        WHEN("Both clocks have edge at the same moment") {
+            Timeline::advanceTo(100);
+            counter.count = 0;
+            REQUIRE(Timeline::advanceTo(200) == 1);
+
+            THEN("Edges are propagated together") {
+                REQUIRE(counter.count == 1);
+                REQUIRE(c1.voltage() == Approx(5).epsilon(EPS));
+                REQUIRE(c2.voltage() == Approx(0).epsilon(EPS));
+                REQUIRE((*Node::find(180, 60))->v() == Approx(0).epsilon(EPS));
+            }
+        }
+
+        WHEN("Time is advanced between edges") {
+            REQUIRE(Timeline::advanceTo(1050) == 10);
+
+            THEN("Time stops at given moment") {
+                REQUIRE(Timeline::now() == 1050);
+                REQUIRE(Timeline::nextEventTime() == 1100);
+            }
+        }
+
+        WHEN("Time interval is changed") {
+            Timeline::advanceTo(50);
+            c1.setTimeInterval(300);
+
+            THEN("Next edge is one new interval from now") {
+                REQUIRE(Timeline::nextEventTime() == 200);
+                Timeline::step();
+                REQUIRE(Timeline::nextEventTime() == 350);
+            }
+        }
+
+        WHEN("Clock is deleted") {
+            Clock* c3 = new Clock(5, 10);
+            delete c3;
+
+            THEN("Its edges are ignored") {
+                REQUIRE(Timeline::nextEventTime() == 100);
+            }
+        }
+    }
+}
+
+SCENARIO("compiled logic", "[compiled]"){
+    GIVEN("Source and chain of 1000 NOT gates") {
+        DCVoltage v(5);
+        v.addNode(0, 0);
+        std::vector<NOTGate*> chain;
+        for (int i = 0; i < 1000; ++i) {
+            chain.push_back(new NOTGate());
+            chain.back()->addNode(i, 0);
+            chain.back()->addNode(i + 1, 0);
+        }
+        std::vector<Component*> gates(chain.begin(), chain.end());
+        CompiledLogic block(gates);
+
+        THEN("Every gate is compiled on its own level") {
+            REQUIRE(block.program().size() == 1000);
+            REQUIRE(block.levels() == 1000);
+            REQUIRE(block.fallbacks() == 0);
+            REQUIRE(block.program().front().op == CompiledLogic::NOT);
+        }
+
+        WHEN("Source is changed") {
+            v.setVoltage(0);
+
+            THEN("Change goes through whole chain") {
+                REQUIRE((*Node::find(999, 0))->v() == Approx(5).epsilon(EPS));
+                REQUIRE((*Node::find(1000, 0))->v() == Approx(0).epsilon(EPS));
+                REQUIRE(Scheduler::evaluations() < 10);
+            }
+        }
+
+        WHEN("Gate in the middle is deleted") {
+            delete chain[500];
+            chain[500] = nullptr;
+
+            THEN("Program is rebuilt without it") {
+                REQUIRE(block.program().size() == 999);
+                REQUIRE(block.levels() == 500);
+            }
+        }
+
+        WHEN("Another source drives output of gate") {
+            DCVoltage other(5);
+            other.addNode(1000, 0);
+
+            THEN("That gate is evaluated without block") {
+                REQUIRE(block.program().size() == 999);
+                REQUIRE(block.fallbacks() == 1);
+            }
+        }
+
+        for (auto g : chain) delete g;
+    }
+
+    GIVEN("SR latch from NOR gates and AND gate on its output") {
+        NORGate nor1, nor2;
+        ANDGate and1;
+        DCVoltage high(5);
+        high.addNode(5, 0);
+        nor1.connect({{0, 0}, {1, 0}, {2, 0}});
+        nor2.connect({{3, 0}, {2, 0}, {1, 0}});
+        and1.connect({{1, 0}, {5, 0}, {4, 0}});
+
+        CompiledLogic block({&nor1, &nor2, &and1});
+
+        THEN("Feedback loop stays event-driven") {
+            REQUIRE(block.program().size() == 1);
+            REQUIRE(block.fallbacks() == 2);
+        }
+
+        WHEN("Latch is reset") {
+            DCVoltage r(5);
+            r.addNode(0, 0);
+
+            THEN("Compiled gate follows latch") {
+                REQUIRE((*Node::find(2, 0))->v() == Approx(0).epsilon(EPS));
+                REQUIRE((*Node::find(1, 0))->v() == Approx(5).epsilon(EPS));
+                REQUIRE((*Node::find(4, 0))->v() == Approx(5).epsilon(EPS));
+            }
+        }
+    }
+}
+
+SCENARIO("64 patterns at once", "[patterns]"){
+    GIVEN("Parity of 16 switches made from XOR gates") {
+        DCVoltage v(5);
+        v.addNode(0, 0);
+
+        std::vector<Switch*> switches;
+        std::vector<Component*> gates;
+        for (int i = 0; i < 16; ++i) {
+            switches.push_back(new Switch());
+            switches.back()->addNode(0, 0);
+            switches.back()->addNode(i + 1, 1);
+        }
+        //Level by level, every XOR joins two nets of previous level
+        int level = 1, width = 16;
+        while (width > 1) {
+            for (int i = 0; i < width / 2; ++i) {
+                gates.push_back(new XORGate());
+                gates.back()->addNode(2 * i + 1, level);
+                gates.back()->addNode(2 * i + 2, level);
+                gates.back()->addNode(i + 1, level + 1);
+            }
+            width /= 2;
+            ++level;
+        }
+        switches[3]->close();
+
+        WHEN("All combinations are simulated") {
+            bool correct = true;
+            {
+                PatternSimulator patterns(gates, switches);
+                REQUIRE(patterns.logic().program().size() == 15);
+                REQUIRE(patterns.combinationBlocks() == 1024);
+
+                for (uint64_t block = 0; block < patterns.combinationBlocks(); ++block) {
+                    patterns.setCombinations(block);
+                    patterns.run();
+                    uint64_t word = patterns.output(1, level);
+                    for (unsigned i = 0; i < 64; ++i) {
+                        uint64_t combination = block * 64 + i;
+                        unsigned ones = 0;
+                        for (unsigned k = 0; k < 16; ++k) ones += (combination >> k) & 1;
+                        correct = correct && ((word >> i) & 1) == (ones & 1);
+                    }
+                }
+            }
+
+            THEN("Every pattern gives parity and switches are restored") {
+                REQUIRE(correct);
+                REQUIRE(switches[3]->isClosed());
+                REQUIRE(switches[4]->isOpened());
+            }
+        }
+
+        WHEN("All combinations are simulated in wide words with every supported kernel") {
+            auto active = LogicKernel::active();
+            bool correct = true;
+            unsigned kernels = 0;
+            for (auto isa : {LogicKernel::SCALAR, LogicKernel::SSE2, LogicKernel::AVX2}) {
+                if (!LogicKernel::setActive(isa)) continue;
+                ++kernels;
+                //5 words: whole vectors and scalar remainder
+                PatternSimulator patterns(gates, switches, 5);
+                REQUIRE(patterns.combinationBlocks() == 205);
+
+                for (uint64_t block = 0; block < patterns.combinationBlocks(); ++block) {
+                    patterns.setCombinations(block);
+                    patterns.run();
+                    for (unsigned p = 0; p < 64 * 5; ++p) {
+                        uint64_t combination = block * 64 * 5 + p;
+                        if (combination >= 65536) break;
+                        unsigned ones = 0;
+                        for (unsigned k = 0; k < 16; ++k) ones += (combination >> k) & 1;
+                        uint64_t word = patterns.output(1, level, p / 64);
+                        correct = correct && ((word >> (p % 64)) & 1) == (ones & 1);
+                    }
+                }
+            }
+            LogicKernel::setActive(active);
+
+            THEN("Every kernel gives parity") {
+                REQUIRE(kernels >= 1);
+                REQUIRE(correct);
+            }
+        }
+
+        WHEN("Pattern is given only to one switch") {
+            PatternSimulator patterns(gates, switches);
+            patterns.setPattern(0, 0xF0);
+            patterns.run();
+
+            THEN("Words of its net and output follow it") {
+                REQUIRE(patterns.output(1, 1) == 0xF0);
+                REQUIRE(patterns.output(2, 1) == 0);
+                REQUIRE(patterns.output(1, level) == 0xF0);
+                REQUIRE(patterns.output(0, 0) == ~uint64_t(0));
+            }
+        }
+
+        for (auto g : gates) delete g;
+        for (auto s : switches) delete s;
+    }
+
+    GIVEN("Program with every opcode") {
+        typedef CompiledLogic::Instruction I;
+        std::vector<I> program = {
+            {CompiledLogic::AND, 0, 1, 2}, {CompiledLogic::OR, 0, 1, 3}, {CompiledLogic::XOR, 0, 1, 4},
+            {CompiledLogic::NAND, 0, 1, 5}, {CompiledLogic::NOR, 0, 1, 6}, {CompiledLogic::NXOR, 0, 1, 7},
+            {CompiledLogic::NOT, 0, 0, 8}, {CompiledLogic::AND, 5, 8, 9}
+        };
+        const unsigned width = 7;
+        std::vector<uint64_t> inputs(2 * width);
+        uint64_t x = 0x9E3779B97F4A7C15ull;
+        for (auto& word : inputs) {
+            x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+            word = x;
+        }
+
+        WHEN("It runs with every supported kernel") {
+            auto active = LogicKernel::active();
+            std::vector<std::vector<uint64_t>> results;
+            for (auto isa : {LogicKernel::SCALAR, LogicKernel::SSE2, LogicKernel::AVX2}) {
+                if (!LogicKernel::setActive(isa)) continue;
+                std::vector<uint64_t> words(10 * width, 0);
+                std::copy(inputs.begin(), inputs.end(), words.begin());
+                LogicKernel::run(program, words.data(), width);
+                results.push_back(words);
+            }
+            LogicKernel::setActive(active);
+
+            THEN("Results are correct and the same") {
+                const auto& r = results.front();
+                for (unsigned j = 0; j < width; ++j) {
+                    uint64_t a = r[j], b = r[width + j];
+                    REQUIRE(r[2 * width + j] == (a & b));
+                    REQUIRE(r[3 * width + j] == (a | b));
+                    REQUIRE(r[4 * width + j] == (a ^ b));
+                    REQUIRE(r[5 * width + j] == ~(a & b));
+                    REQUIRE(r[6 * width + j] == ~(a | b));
+                    REQUIRE(r[7 * width + j] == ~(a ^ b));
+                    REQUIRE(r[8 * width + j] == ~a);
+                    REQUIRE(r[9 * width + j] == (~(a & b) & ~a));
+                }
+                for (const auto& other : results) REQUIRE(other == r);
+            }
+        }
+    }
+
+    GIVEN("Switch without source") {
+        Switch s;
+        s.addNode(0, 0);
+        s.addNode(1, 0);
+        NOTGate not1;
+        not1.addNode(1, 0);
+        not1.addNode(2, 0);
+
+        THEN("It can't be input") {
+            REQUIRE_THROWS(PatternSimulator({&not1}, {&s}));
+        }
+    }
+}
+
+SCENARIO("parallel compiled logic", "[parallel]"){
+    GIVEN("Thread pool with 4 threads") {
+        ThreadPool::setThreads(4);
+
+        WHEN("Tasks are run") {
+            std::vector<unsigned> results(1000, 0);
+            ThreadPool::run(results.size(), [&results](size_t t) {
+                results[t] = static_cast<unsigned>(t * t);
+            });
+
+            THEN("Every task runs once") {
+                bool correct = true;
+                for (size_t t = 0; t < results.size(); ++t) correct = correct && results[t] == t * t;
+                REQUIRE(correct);
+                REQUIRE(ThreadPool::threads() == 4);
+            }
+        }
+
+        WHEN("Thousands of small jobs run one after another") {
+            ThreadPool::setThreads(8);
+            std::vector<std::atomic<unsigned>> counts(8);
+            size_t expected = 0;
+            for (unsigned job = 0; job < 5000; ++job) {
+                size_t count = 1 + job % 8;
+                expected += count;
+                ThreadPool::run(count, [&counts](size_t t) { ++counts[t]; });
+            }
+
+            THEN("Every task of every job runs once") {
+                size_t total = 0;
+                for (const auto& c : counts) total += c;
+                REQUIRE(total == expected);
+                REQUIRE(counts[7] == 5000 / 8);
+            }
+        }
+
+        WHEN("Task throws") {
+            THEN("Exception gets to caller") {
+                REQUIRE_THROWS_AS(ThreadPool::run(100, [](size_t t) {
+                    if (t == 42) throw std::runtime_error("Error: task failed");
+                }), std::runtime_error);
+            }
+        }
+
+        ThreadPool::setThreads(1);
+    }
+
+    GIVEN("Eight small XOR trees and one big tree") {
+        std::vector<Component*> gates;
+        //Parity tree of 'inputs' nets from (x, y) to (x + inputs - 1, y), returns y of its output
+        auto tree = [&gates](int x, int y, int inputs) {
+            while (inputs > 1) {
+                for (int i = 0; i < inputs / 2; ++i) {
+                    gates.push_back(new XORGate());
+                    gates.back()->addNode(x + 2 * i, y);
+                    gates.back()->addNode(x + 2 * i + 1, y);
+                    gates.back()->addNode(x + i, y + 1);
+                }
+                inputs /= 2;
+                ++y;
+            }
+            return y;
+        };
+        int small = 0;
+        for (int t = 0; t < 8; ++t) small = tree(0, 100 * t, 512);
+        int big = tree(0, 1000, 8192);
+
+        //Block is deleted before gates, so it isn't recompiled after every deleted gate
+        std::unique_ptr<CompiledLogic> block(new CompiledLogic(gates));
+        CompiledLogic& logic = *block;
+        std::vector<uint64_t> words(logic.slots(), 0);
+        uint64_t x = 0x9E3779B97F4A7C15ull;
+        for (unsigned s : logic.inputs()) {
+            x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+            words[s] = x;
+        }
+        auto inputs = words;
+
+        WHEN("It runs on one thread and on four threads") {
+            logic.evaluate(words);
+            auto single = words;
+            ThreadPool::setThreads(4);
+            words = inputs;
+            logic.evaluate(words);
+            ThreadPool::setThreads(1);
+
+            THEN("Program is split and results are the same") {
+                REQUIRE(logic.program().size() == 8 * 511 + 8191);
+                REQUIRE(logic.tasks() > 4);
+                REQUIRE(logic.stages() > 1);
+                REQUIRE(words == single);
+
+                uint64_t parity = 0;
+                for (int i = 0; i < 8192; ++i) {
+                    parity ^= inputs[logic.slot((*Node::find(i, 1000))->net())];
+                }
+                REQUIRE(words[logic.slot((*Node::find(0, big))->net())] == parity);
+
+                parity = 0;
+                for (int i = 0; i < 512; ++i) {
+                    parity ^= inputs[logic.slot((*Node::find(i, 700))->net())];
+                }
+                REQUIRE(words[logic.slot((*Node::find(0, small))->net())] == parity);
+            }
+        }
+
+        block.reset();
+        for (auto g : gates) delete g;
+    }
+}
+
+SCENARIO("DC analysis of resistor networks", "[analog]"){
+    GIVEN("Voltage divider with wire and switch") {
+        DCVoltage v(10);
+        v.addNode(0, 0);
+        Resistor r1(1000), r2(3000);
+        r1.connect({{0, 0}, {1, 0}});
+        r2.connect({{2, 0}, {3, 0}});
+        Wire w;
+        w.connect({{1, 0}, {2, 0}});
+        Switch s(Switch::CLOSE);
+        s.connect({{3, 0}, {4, 0}});
+        Ground g;
+        g.addNode(4, 0);
+
+        AnalogSolver solver({&v, &r1, &r2, &w, &s, &g});
+
+        WHEN("Circuit is solved") {
+            size_t nets = solver.solve();
+
+            THEN("Middle node is divided by resistances") {
+                REQUIRE(nets == 1);
+                REQUIRE((*Node::find(1, 0))->v() == Approx(7.5).epsilon(EPS));
+                REQUIRE((*Node::find(2, 0))->v() == Approx(7.5).epsilon(EPS));
+                REQUIRE(r1.current() == Approx(r2.current()).epsilon(EPS));
+                REQUIRE(r2.current() == Approx(-0.0025).epsilon(EPS));
+            }
+        }
+
+        WHEN("Resistance is changed") {
+            solver.solve();
+            r2.setResistance(1000);
+            solver.solve();
+
+            THEN("New value is used without new factorization") {
+                REQUIRE((*Node::find(1, 0))->v() == Approx(5).epsilon(EPS));
+                REQUIRE(solver.updates() == 1);
+                REQUIRE(solver.factorizations() == 1);
+                REQUIRE(solver.analyses() == 1);
+            }
+        }
+
+        WHEN("Switch is opened and closed again") {
+            solver.solve();
+            s.open();
+            solver.solve();
+            s.close();
+            solver.solve();
+
+            THEN("Closed switch is constraint on the new matrix") {
+                REQUIRE((*Node::find(1, 0))->v() == Approx(7.5).epsilon(EPS));
+                REQUIRE(solver.updates() == 1);
+                REQUIRE(solver.analyses() == 2);
+
+                s.open();
+                solver.solve();
+                REQUIRE((*Node::find(1, 0))->v() == Approx(10).epsilon(EPS));
+                REQUIRE(solver.updates() == 0);
+                REQUIRE(solver.analyses() == 2);
+            }
+        }
+
+        WHEN("Resistance has no finite conductance") {
+            solver.solve();
+            r2.setResistance(1e-320);
+
+            THEN("Solver throws and keeps voltages") {
+                REQUIRE_THROWS_AS(solver.solve(), std::runtime_error);
+                REQUIRE((*Node::find(1, 0))->v() == Approx(7.5).epsilon(EPS));
+                r2.setResistance(3000);
+                solver.solve();
+                REQUIRE((*Node::find(1, 0))->v() == Approx(7.5).epsilon(EPS));
+            }
+        }
+
+        THEN("Resistance which isn't positive is rejected") {
+            REQUIRE_THROWS_AS(r1.setResistance(0), std::invalid_argument);
+            REQUIRE_THROWS_AS(r1.setResistance(-100), std::invalid_argument);
+            REQUIRE_THROWS_AS(r1.setResistance(std::nan("")), std::invalid_argument);
+            REQUIRE(r1.resistance() == 1000);
+        }
+
+        WHEN("Switch is opened") {
+            solver.solve();
+            s.open();
+            size_t nets = solver.solve();
+
+            THEN("Nets without path to ground have source voltage") {
+                REQUIRE(nets == 2);
+                REQUIRE((*Node::find(1, 0))->v() == Approx(10).epsilon(EPS));
+                REQUIRE((*Node::find(3, 0))->v() == Approx(10).epsilon(EPS));
+                REQUIRE(r1.current() == Approx(0).margin(EPS));
+            }
+        }
+    }
+
+    GIVEN("Gate output which drives two resistors to ground") {
+        NOTGate not1;
+        not1.connect({{0, 0}, {1, 0}});
+        Resistor r1(1000), r2(1000);
+        r1.connect({{1, 0}, {2, 0}});
+        r2.connect({{2, 0}, {3, 0}});
+        Ground g;
+        g.addNode(3, 0);
+        not1.evaluate();
+
+        WHEN("Circuit is solved") {
+            AnalogSolver solver({&not1, &r1, &r2, &g});
+            solver.solve();
+
+            THEN("Gate output is fixed and resistors divide it") {
+                REQUIRE((*Node::find(1, 0))->v() == Approx(5).epsilon(EPS));
+                REQUIRE((*Node::find(2, 0))->v() == Approx(2.5).epsilon(EPS));
+            }
+        }
+    }
+
+    GIVEN("Mesh of 101 x 101 nodes with source and ground in opposite corners") {
+        const int size = 101;
+        std::vector<Component*> components;
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                if (x + 1 < size) {
+                    components.push_back(new Resistor(100));
+                    components.back()->connect({{x, y}, {x + 1, y}});
+                }
+                if (y + 1 < size) {
+                    components.push_back(new Resistor(100));
+                    components.back()->connect({{x, y}, {x, y + 1}});
+                }
+            }
+        }
+        components.push_back(new DCVoltage(10));
+        components.back()->addNode(0, 0);
+        components.push_back(new Ground());
+        components.back()->addNode(size - 1, size - 1);
+
+        WHEN("Circuit is solved") {
+            AnalogSolver solver(components);
+            size_t nets = solver.solve();
+
+            THEN("Mesh is symmetric and currents in every node sum to zero") {
+                REQUIRE(nets == size * size - 2);
+                REQUIRE((*Node::find(size / 2, size / 2))->v() == Approx(5).epsilon(EPS));
+                REQUIRE((*Node::find(1, 0))->v() + (*Node::find(size - 2, size - 1))->v() == Approx(10).epsilon(EPS));
+
+                std::vector<double> sum(size * size, 0);
+                for (size_t i = 0; i + 2 < components.size(); ++i) {
+                    const auto& nodes = components[i]->nodes();
+                    double current = static_cast<Resistor*>(components[i])->current();
+                    sum[nodes[0]->y() * size + nodes[0]->x()] += current;
+                    sum[nodes[1]->y() * size + nodes[1]->x()] -= current;
+                }
+                double worst = 0;
+                for (int k = 1; k + 1 < size * size; ++k) worst = std::max(worst, std::fabs(sum[k]));
+                REQUIRE(worst < 1e-9);
+            }
+        }
+
+        WHEN("Resistors are changed one by one") {
+            AnalogSolver solver(components);
+            solver.solve();
+            for (size_t i = 0; i < 40; ++i) {
+                static_cast<Resistor*>(components[i * 101])->setResistance(50 + i);
+                solver.solve();
+            }
+            double center = (*Node::find(size / 2, size / 2))->v();
+            double corner = (*Node::find(1, 0))->v();
+
+            THEN("Updates give the same voltages as new solver and factorization is repeated when there are too many") {
+                REQUIRE(solver.analyses() == 1);
+                REQUIRE(solver.factorizations() == 2);
+                REQUIRE(solver.updates() == 7);
+
+                AnalogSolver fresh(components);
+                fresh.solve();
+                REQUIRE((*Node::find(size / 2, size / 2))->v() == Approx(center).epsilon(EPS));
+                REQUIRE((*Node::find(1, 0))->v() == Approx(corner).epsilon(EPS));
+            }
+        }
+
+        for (auto c : components) delete c;
+    }
+}
+
+SCENARIO("slab allocation of nodes and components", "[slab]"){
+    GIVEN("Chain of NOT gates") {
+        size_t used = SlabAllocator::used();
+        std::vector<Component*> gates;
+        for (int i = 0; i < 1000; ++i) {
+            gates.push_back(new NOTGate());
+            gates.back()->connect({{200 * i, 60}, {200 * i + 180, 60}});
+        }
+
+        THEN("Gates and their nodes are taken from slabs") {
+            REQUIRE(SlabAllocator::used() == used + 3000);
+        }
+
+        WHEN("Gates are deleted and built again") {
+            for (auto g : gates) delete g;
+            REQUIRE(SlabAllocator::used() == used);
+            size_t slabs = SlabAllocator::slabs();
+
+            for (int i = 0; i < 1000; ++i) {
+                gates[i] = new NOTGate();
+                gates[i]->connect({{200 * i, 60}, {200 * i + 180, 60}});
+            }
+
+            THEN("Freed pieces are used again") {
+                REQUIRE(SlabAllocator::slabs() == slabs);
+                REQUIRE(SlabAllocator::used() == used + 3000);
+            }
+        }
+
+        for (auto g : gates) delete g;
+    }
+
+    GIVEN("Two components on the same node") {
+        Wire w1, w2;
+        w1.connect({{0, 0}, {10, 0}});
+        w2.connect({{10, 0}, {20, 0}});
+
+        THEN("Node is shared") {
+            REQUIRE(w1.nodes()[1] == w2.nodes()[0]);
+            REQUIRE(*Node::find(10, 0) == w2.nodes()[0]);
+            REQUIRE((*Node::find(10, 0))->directComponents().size() == 2);
+        }
+    }
+}
+
+SCENARIO("four-state logic", "[fourstate]"){
+    GIVEN("AND gate with one floating input") {
+        Logic::setFourState(true);
+        DCVoltage high(5);
+        high.addNode(0, 0);
+        ANDGate and1;
+        and1.connect({{0, 0}, {0, 20}, {20, 10}});
+
+        THEN("Floating input is Z and output is X") {
+            REQUIRE((*Node::find(0, 0))->level() == Logic::ONE);
+            REQUIRE((*Node::find(0, 20))->level() == Logic::Z);
+            REQUIRE((*Node::find(20, 10))->level() == Logic::X);
+            REQUIRE((*Node::find(20, 10))->v() == Approx(0).epsilon(EPS));
+        }
+
+        WHEN("Floating input is driven") {
+            DCVoltage other(5);
+            other.addNode(0, 20);
+
+            THEN("Output is known") {
+                REQUIRE((*Node::find(20, 10))->level() == Logic::ONE);
+                REQUIRE((*Node::find(20, 10))->v() == Approx(5).epsilon(EPS));
+            }
+        }
+
+        WHEN("Other input is 0") {
+            high.setVoltage(0);
+
+            THEN("0 decides output without floating input") {
+                REQUIRE((*Node::find(20, 10))->level() == Logic::ZERO);
+            }
+        }
+        Logic::setFourState(false);
+    }
+
+    GIVEN("Outputs of two NOT gates on one net and gate which reads it") {
+        Logic::setFourState(true);
+        DCVoltage a(5), b(5);
+        a.addNode(0, 0);
+        b.addNode(0, 10);
+        NOTGate not1, not2, reader;
+        not1.connect({{0, 0}, {20, 0}});
+        not2.connect({{0, 10}, {20, 0}});
+        reader.connect({{20, 0}, {40, 0}});
+
+        THEN("Drivers agree and net has their value") {
+            REQUIRE((*Node::find(20, 0))->level() == Logic::ZERO);
+            REQUIRE((*Node::find(40, 0))->level() == Logic::ONE);
+        }
+
+        WHEN("One driver changes its value") {
+            b.setVoltage(0);
+
+            THEN("Net is X and X goes through reader") {
+                REQUIRE((*Node::find(20, 0))->level() == Logic::X);
+                REQUIRE((*Node::find(40, 0))->level() == Logic::X);
+            }
+
+            AND_WHEN("Other driver is disconnected") {
+                not1.disconnect();
+
+                THEN("Net has value of the last driver") {
+                    REQUIRE((*Node::find(20, 0))->level() == Logic::ONE);
+                    REQUIRE((*Node::find(40, 0))->level() == Logic::ZERO);
+                }
+            }
+        }
+
+        WHEN("Net is joined by wire with net driven to another value") {
+            DCVoltage c(5);
+            c.addNode(60, 0);
+            Wire w;
+            w.connect({{20, 0}, {60, 0}});
+
+            THEN("Joined net is X") {
+                REQUIRE((*Node::find(60, 0))->level() == Logic::X);
+                REQUIRE((*Node::find(40, 0))->level() == Logic::X);
+            }
+
+            AND_WHEN("Wire is removed") {
+                w.disconnect();
+
+                THEN("Both nets are resolved again") {
+                    REQUIRE((*Node::find(20, 0))->level() == Logic::ZERO);
+                    REQUIRE((*Node::find(60, 0))->level() == Logic::ONE);
+                    REQUIRE((*Node::find(40, 0))->level() == Logic::ONE);
+                }
+            }
+        }
+        Logic::setFourState(false);
+    }
+
+    GIVEN("JK flip-flop with J = 1 and K = 0") {
+        Logic::setFourState(true);
+        DCVoltage j(5), clk(5), k(0);
+        j.addNode(0, 0);
+        clk.addNode(0, 10);
+        k.addNode(0, 20);
+        JKFlipFlop ff;
+        ff.connect({{0, 0}, {0, 10}, {0, 20}, {20, 0}, {20, 20}});
+
+        THEN("Outputs are not driven before first edge") {
+            REQUIRE((*Node::find(20, 0))->level() == Logic::Z);
+        }
+
+        WHEN("Another source drives clock to 0") {
+            DCVoltage other(0);
+            other.addNode(0, 10);
+
+            THEN("Clock is X, it could be an edge, so outputs are X") {
+                REQUIRE((*Node::find(0, 10))->level() == Logic::X);
+                REQUIRE((*Node::find(20, 0))->level() == Logic::X);
+                REQUIRE((*Node::find(20, 20))->level() == Logic::X);
+            }
+
+            AND_WHEN("Clock is known again and falls") {
+                other.disconnect();
+                clk.setVoltage(0);
+
+                THEN("Flip-flop is set") {
+                    REQUIRE((*Node::find(20, 0))->level() == Logic::ONE);
+                    REQUIRE((*Node::find(20, 20))->level() == Logic::ZERO);
+                }
+            }
+        }
+        Logic::setFourState(false);
+    }
+
+    GIVEN("Decoder with floating input I0") {
+        Logic::setFourState(true);
+        DCVoltage i3(0), i2(0), i1(0);
+        i3.addNode(0, 0);
+        i2.addNode(0, 10);
+        i1.addNode(0, 20);
+        Decoder d;
+        std::vector<std::pair<int, int>> points;
+        for (int i = 0; i < 11; ++i) points.push_back({i < 4 ? 0 : 20, 10 * i});
+        d.connect(points);
+
+        THEN("All segments are X") {
+            for (int i = 4; i < 11; ++i) REQUIRE((*Node::find(20, 10 * i))->level() == Logic::X);
+        }
+
+        WHEN("I0 is driven to 1") {
+            DCVoltage i0(5);
+            i0.addNode(0, 30);
+
+            THEN("Digit 1 is shown") {
+                REQUIRE((*Node::find(20, 10 * Decoder::a))->level() == Logic::ZERO);
+                REQUIRE((*Node::find(20, 10 * Decoder::b))->level() == Logic::ONE);
+                REQUIRE((*Node::find(20, 10 * Decoder::c))->level() == Logic::ONE);
+                for (int i = Decoder::d; i <= Decoder::g; ++i) REQUIRE((*Node::find(20, 10 * i))->level() == Logic::ZERO);
+            }
+        }
+        Logic::setFourState(false);
+    }
+
+    GIVEN("Compiled chain of 3 NOT gates with floating input") {
+        Logic::setFourState(true);
+        std::vector<Component*> chain;
+        for (int i = 0; i < 3; ++i) {
+            chain.push_back(new NOTGate());
+            chain.back()->connect({{i, 100}, {i + 1, 100}});
+        }
+        CompiledLogic block(chain);
+
+        THEN("Gates are compiled and X goes through them") {
+            REQUIRE(block.program().size() == 3);
+            REQUIRE((*Node::find(3, 100))->level() == Logic::X);
+        }
+
+        WHEN("Input is driven") {
+            DCVoltage v(5);
+            v.addNode(0, 100);
+
+            THEN("Block drives known value") {
+                REQUIRE((*Node::find(1, 100))->level() == Logic::ZERO);
+                REQUIRE((*Node::find(3, 100))->level() == Logic::ZERO);
+            }
+        }
+
+        WHEN("Patterns 0, 1 and X are evaluated on bit-planes") {
+            unsigned in = static_cast<unsigned>(block.slot((*Node::find(0, 100))->net()));
+            unsigned out = static_cast<unsigned>(block.slot((*Node::find(3, 100))->net()));
+            std::vector<uint64_t> values(block.slots(), 0), unknown(block.slots(), 0);
+            values[in] = 2;
+            unknown[in] = 4;
+            block.evaluate(values, unknown);
+
+            THEN("Every pattern is inverted, X stays X") {
+                REQUIRE((values[out] & 7) == 1);
+                REQUIRE((unknown[out] & 7) == 4);
+            }
+        }
+
+        for (auto c : chain) delete c;
+        Logic::setFourState(false);
+    }
+
+    GIVEN("Resolution of drivers") {
+        THEN("Z gives way and different values are X") {
+            REQUIRE(Logic::resolve(Logic::Z, Logic::ONE) == Logic::ONE);
+            REQUIRE(Logic::resolve(Logic::ZERO, Logic::Z) == Logic::ZERO);
+            REQUIRE(Logic::resolve(Logic::ONE, Logic::ONE) == Logic::ONE);
+            REQUIRE(Logic::resolve(Logic::ZERO, Logic::ONE) == Logic::X);
+            REQUIRE(Logic::resolve(Logic::X, Logic::Z) == Logic::X);
+            REQUIRE(Logic::resolve(Logic::Z, Logic::Z) == Logic::Z);
+        }
+
+        THEN("Known input decides output of gate with X") {
+            REQUIRE(Logic::andOf(Logic::ZERO, Logic::X) == Logic::ZERO);
+            REQUIRE(Logic::andOf(Logic::ONE, Logic::Z) == Logic::X);
+            REQUIRE(Logic::orOf(Logic::X, Logic::ONE) == Logic::ONE);
+            REQUIRE(Logic::xorOf(Logic::ONE, Logic::X) == Logic::X);
+            REQUIRE(Logic::notOf(Logic::Z) == Logic::X);
+        }
+    }
+}
+
+SCENARIO("propagation delays", "[delay]"){
+    struct Event {
+        long long time;
+        int id;
+    };
+
+    GIVEN("Timing wheel") {
+        TimingWheel<Event> wheel;
+        wheel.insert({70000, 0});
+        wheel.insert({5, 1});
+        wheel.insert({300, 2});
+        wheel.insert({5, 3});
+        wheel.insert(Event{1LL << 40, 4});
+
+        THEN("Events come in order of time, at the same time in order of insertion") {
+            std::vector<Event> out;
+            REQUIRE(wheel.nextTime() == 5);
+            wheel.takeNext(out);
+            REQUIRE(out.size() == 2);
+            REQUIRE(out[0].id == 1);
+            REQUIRE(out[1].id == 3);
+
+            wheel.insert({10, 5});
+            std::vector<long long> times;
+            while (!wheel.empty()) {
+                out.clear();
+                wheel.takeNext(out);
+                REQUIRE(out.size() == 1);
+                times.push_back(out[0].time);
+            }
+            REQUIRE(times == std::vector<long long>({10, 300, 70000, 1LL << 40}));
+            REQUIRE(wheel.nextTime() == -1);
+        }
+    }
+
+    GIVEN("NOT gate with delay 10") {
+        Timeline::reset();
+        NOTGate not1;
+        not1.connect({{0, 200}, {1, 200}});
+        not1.setDelay(Delay(10));
+        DCVoltage v(5);
+
+        WHEN("Input changes") {
+            v.addNode(0, 200);
+
+            THEN("Output changes 10 ms later") {
+                REQUIRE((*Node::find(1, 200))->v() == Approx(5).epsilon(EPS));
+                REQUIRE(Timeline::nextEventTime() == 10);
+                Timeline::advanceTo(9);
+                REQUIRE((*Node::find(1, 200))->v() == Approx(5).epsilon(EPS));
+                Timeline::advanceTo(10);
+                REQUIRE((*Node::find(1, 200))->v() == Approx(0).epsilon(EPS));
+                REQUIRE(Timeline::nextEventTime() == -1);
+            }
+        }
+
+        WHEN("Pulse shorter than delay comes to input") {
+            v.addNode(0, 200);
+            Timeline::advanceTo(5);
+            v.disconnect();
+
+            THEN("Inertial delay swallows it") {
+                Timeline::advanceTo(20);
+                REQUIRE((*Node::find(1, 200))->v() == Approx(5).epsilon(EPS));
+                REQUIRE(Delays::pending() == 0);
+            }
+        }
+
+        WHEN("Pulse shorter than delay comes to input of gate with transport delay") {
+            not1.setDelay(Delay(10, DelayModel::TRANSPORT));
+            v.addNode(0, 200);
+            Timeline::advanceTo(5);
+            v.disconnect();
+
+            THEN("Pulse comes to output later") {
+                Timeline::advanceTo(10);
+                REQUIRE((*Node::find(1, 200))->v() == Approx(0).epsilon(EPS));
+                Timeline::advanceTo(15);
+                REQUIRE((*Node::find(1, 200))->v() == Approx(5).epsilon(EPS));
+            }
+        }
+
+        WHEN("Gate is compiled") {
+            std::vector<Component*> gates{&not1};
+            CompiledLogic block(gates);
+
+            THEN("Gate with delay is left out") {
+                REQUIRE(block.program().empty());
+            }
+        }
+
+        THEN("Only logical components can have delay") {
+            REQUIRE(not1.delay().time == 10);
+            REQUIRE_THROWS_AS(v.setDelay(Delay(1)), std::invalid_argument);
+            REQUIRE_THROWS_AS(not1.setDelay(Delay(-1)), std::invalid_argument);
+            REQUIRE_THROWS_AS(Delays::set(ComponentKind::WIRE, Delay(1)), std::invalid_argument);
+        }
+        Timeline::reset();
+    }
+
+    GIVEN("Default delay of AND gates") {
+        Timeline::reset();
+        Delays::set(ComponentKind::AND, Delay(3));
+        ANDGate* and1 = new ANDGate();
+        and1->connect(and1->connectionPoints());
+        DCVoltage v1(5), v2(5);
+        v1.addNode(0, 30);
+        v2.addNode(0, 90);
+
+        THEN("Gate uses it") {
+            REQUIRE(and1->delay().time == 3);
+            REQUIRE(Timeline::nextEventTime() == 3);
+        }
+
+        WHEN("Gate with scheduled change is deleted") {
+            delete and1;
+            and1 = nullptr;
+
+            THEN("Change is dropped") {
+                Timeline::advanceTo(3);
+                REQUIRE(Timeline::nextEventTime() == -1);
+            }
+        }
+
+        delete and1;
+        Delays::setAll(Delay());
+        Timeline::reset();
+    }
+}
+
+SCENARIO("value change dump", "[vcd]"){
+    GIVEN("NOT gate with probes on input and output") {
+        const std::string path = "test-dump.vcd";
+        NOTGate not1;
+        not1.connect({{0, 300}, {1, 300}});
+        DCVoltage v(0);
+        v.addNode(0, 300);
+        std::vector<VcdWriter::Probe> probes{{"in", Node::find(0, 300)->get()}, {"out", Node::find(1, 300)->get()}};
+
+        auto read = [&path]() {
+            std::ifstream file(path, std::ios::binary);
+            return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        };
+
+        WHEN("Input changes twice and changes are written through buffer of one change") {
+            VcdWriter vcd(path, probes, 1);
+            ChangeFeed::publish(0);
+            ChangeFeed::publish(5);
+            v.setVoltage(5);
+            ChangeFeed::publish(10);
+            v.setVoltage(0);
+            ChangeFeed::publish(20);
+            vcd.close();
+
+            THEN("Only changes are written, after header with both wires") {
+                REQUIRE(vcd.changes() == 6);
+                REQUIRE(read() ==
+                        "$version protoElectronics $end\n"
+                        "$timescale 1 ms $end\n"
+                        "$scope module circuit $end\n"
+                        "$var wire 1 ! in $end\n"
+                        "$var wire 1 \" out $end\n"
+                        "$upscope $end\n"
+                        "$enddefinitions $end\n"
+                        "#0\n0!\n1\"\n"
+                        "#10\n1!\n0\"\n"
+                        "#20\n0!\n1\"\n");
+            }
+        }
+
+        WHEN("Writer is destroyed without close") {
+            {
+                VcdWriter vcd(path, probes);
+                ChangeFeed::publish(0);
+            }
+
+            THEN("Buffered changes are written") {
+                std::string text = read();
+                REQUIRE(text.substr(text.size() - 9) == "#0\n0!\n1\"\n");
+            }
+        }
+        std::remove(path.c_str());
+
+        THEN("File which can't be created throws") {
+            REQUIRE_THROWS_AS(VcdWriter("no-such-directory/dump.vcd", probes), std::runtime_error);
+        }
+    }
+
+    GIVEN("Many probes") {
+        THEN("Identifiers are printable and unique") {
+            REQUIRE(VcdWriter::identifier(0) == "!");
+            REQUIRE(VcdWriter::identifier(93) == "~");
+            REQUIRE(VcdWriter::identifier(94) == "!\"");
+            REQUIRE(VcdWriter::identifier(95) != VcdWriter::identifier(1));
+        }
+    }
+}
+
+SCENARIO("ring buffer of changes with trigger", "[ring]"){
+    GIVEN("NOT gate with input and output in ring of 3 changes") {
+        NOTGate not1;
+        not1.connect({{0, 400}, {1, 400}});
+        DCVoltage v(0);
+        v.addNode(0, 400);
+        TraceBuffer ring;
+        ring.addGroup({{"in", Node::find(0, 400)->get()}, {"out", Node::find(1, 400)->get()}}, 3);
+
+        auto toggle = [&v](int times, long long& time) {
+            for (int i = 0; i < times; ++i) {
+                v.setVoltage(v.voltage() > 0 ? 0 : 5);
+                time += 10;
+                ChangeFeed::publish(time);
+            }
+        };
+
+        WHEN("Input toggles many times without trigger") {
+            long long time = 0;
+            ChangeFeed::publish(time);
+            toggle(5, time);
+
+            THEN("Only the last changes are kept, with level of other probe before them") {
+                auto records = ring.records();
+                REQUIRE(records.size() == 4);
+                REQUIRE(records[0].time == 40);
+                REQUIRE(records[0].probe == 0);
+                REQUIRE(records[0].value == Logic::ZERO);
+                REQUIRE(records[1].probe == 1);
+                REQUIRE(records[1].value == Logic::ONE);
+                REQUIRE(records[3].time == 50);
+                REQUIRE(records[3].value == Logic::ZERO);
+                REQUIRE_FALSE(ring.triggered());
+            }
+        }
+
+        WHEN("Trigger is rising edge of input with 10 ms after it") {
+            ring.setTrigger(0, TraceBuffer::Condition::BECOMES, Logic::ONE, 10);
+            long long time = 0;
+            ChangeFeed::publish(time);
+            toggle(1, time);
+
+            THEN("Buffer freezes 10 ms after trigger") {
+                REQUIRE(ring.triggerTime() == 10);
+                REQUIRE_FALSE(ring.frozen());
+                toggle(3, time);
+                REQUIRE(ring.frozen());
+                auto records = ring.records();
+                REQUIRE(records.back().time == 20);
+                REQUIRE(records.back().value == Logic::ONE);
+            }
+
+            THEN("Rearmed buffer starts again") {
+                ring.rearm();
+                REQUIRE_FALSE(ring.triggered());
+                REQUIRE(ring.records().empty());
+            }
+        }
+
+        WHEN("Trigger is level which probe already has") {
+            ring.setTrigger(1, TraceBuffer::Condition::EQUALS, Logic::ONE);
+            ChangeFeed::publish(0);
+
+            THEN("Buffer freezes at once") {
+                REQUIRE(ring.frozen());
+                REQUIRE(ring.triggerTime() == 0);
+            }
+        }
+
+        WHEN("Window is written") {
+            const std::string path = "test-ring.vcd";
+            ring.setTrigger(0, TraceBuffer::Condition::TOGGLES);
+            long long time = 0;
+            ChangeFeed::publish(time);
+            toggle(2, time);
+            ring.writeVcd(path);
+            std::ifstream file(path, std::ios::binary);
+            std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            std::remove(path.c_str());
+
+            THEN("Trigger is marked in file") {
+                REQUIRE(text.substr(text.find("#0")) == "#0\n0!\n1\"\n#10\n$comment trigger $end\n1!\n0\"\n");
+            }
+        }
+
+        THEN("Wrong trigger and depth throw") {
+            REQUIRE_THROWS_AS(ring.setTrigger(2, TraceBuffer::Condition::TOGGLES), std::invalid_argument);
+            REQUIRE_THROWS_AS(ring.addGroup({}, 0), std::invalid_argument);
+        }
+    }
+}
+
+SCENARIO("history of levels for waveform view", "[changelog]"){
+    GIVEN("Clock with interval 10 on input of NOT gate and log of its output") {
+        Timeline::reset();
+        NOTGate not1;
+        not1.connect({{0, 500}, {1, 500}});
+        Clock clock(5, 10);
+        clock.addNode(0, 500);
+        ChangeLog log;
+        log.addProbe("out", 1, 500);
+        ChangeFeed::publish(0);
+        Timeline::advanceTo(1000);
+
+        THEN("Every moment is recorded") {
+            REQUIRE(log.end() == 1000);
+            REQUIRE(log.changes(0) == 101);
+            REQUIRE(log.level(0, 5) == Logic::ZERO);
+            REQUIRE(log.level(0, 10) == Logic::ONE);
+            REQUIRE(log.level(0, 19) == Logic::ONE);
+            REQUIRE(log.level(0, -1) == Logic::Z);
+            REQUIRE(log.probed(1, 500));
+            REQUIRE_FALSE(log.probed(0, 500));
+        }
+
+        WHEN("History is summarized in columns") {
+            std::vector<ChangeLog::Column> wide(4), narrow(200);
+            log.summarize(0, 0, 1000, wide);
+            log.summarize(0, 0, 20, narrow);
+
+            THEN("Column shows number of changes or one change") {
+                REQUIRE(wide[0].changes == 25);
+                REQUIRE(wide[3].last == Logic::ONE);
+                REQUIRE(narrow[0].first == Logic::Z);
+                REQUIRE(narrow[0].last == Logic::ZERO);
+                REQUIRE(narrow[1].changes == 0);
+                REQUIRE(narrow[100].changes == 1);
+                REQUIRE(narrow[100].first == Logic::ZERO);
+                REQUIRE(narrow[100].last == Logic::ONE);
+            }
+        }
+
+        WHEN("One probe has more changes than limit and other doesn't") {
+            ChangeLog small(10);
+            small.addProbe("out", 1, 500);
+            small.addProbe("nothing", 7, 7);
+            ChangeFeed::publish(Timeline::now());
+            Timeline::advanceTo(1200);
+
+            THEN("Older half is dropped and history starts where it is known for both probes") {
+                REQUIRE(small.changes(0) <= 10);
+                REQUIRE(small.changes(1) == 1);
+                REQUIRE(small.begin() > 1000);
+                REQUIRE(small.level(0, 1200) == log.level(0, 1200));
+                REQUIRE(small.level(0, small.begin() - 1) == log.level(0, small.begin() - 1));
+                REQUIRE(small.level(1, small.begin()) == Logic::floating());
+            }
+        }
+
+        WHEN("Node of probe is deleted") {
+            ChangeLog missing;
+            missing.addProbe("nothing", 7, 7);
+            ChangeFeed::publish(Timeline::now());
+
+            THEN("Probe reads floating net") {
+                REQUIRE(missing.level(0, Timeline::now()) == Logic::floating());
+            }
+
+            THEN("Probe finds node which is added later") {
+                DCVoltage v(5);
+                v.addNode(7, 7);
+                Timeline::advanceTo(1010);
+                REQUIRE(missing.level(0, 1010) == Logic::ONE);
+            }
+        }
+    }
+}